@@ -0,0 +1,196 @@
+/***********************************************************************
+ * Header:
+ *    AUGMENT
+ * Summary:
+ *    What every node of the BST knows about its whole subtree. Pick
+ *    one with the fifth template parameter:
+ *        BST <int, RedBlack, std::less<int>, std::allocator<int>, OrderStatistic>
+ *    Each augmentation gives:
+ *        Meta<T>             : data stored in every node (BNode inherits it)
+ *        counts              : whether Meta has the size of the subtree
+ *        update()            : recompute one node from its children, which
+ *                              are already up to date. Called for the two
+ *                              nodes of a rotation, and bottom up for every
+ *                              node of a subtree that is built or rebuilt
+ *        inserted()          : called after a new leaf is linked in, before
+ *                              the tree is rebalanced; fixes its ancestors
+ *        erased()            : called after a node is unlinked, before the
+ *                              tree is rebalanced, with the lowest node whose
+ *                              subtree changed; fixes it and its ancestors
+ *    Like the balancing policies, everything is static, so the default
+ *    costs nothing.
+ *
+ *    This will contain the class definition of:
+ *        NoAugment           : Nothing extra (the default)
+ *        OrderStatistic      : The number of elements in every subtree
+ *        Aggregate<Monoid>   : That, and the elements of every subtree
+ *                              combined by a monoid
+ *        Sum, Min, Max       : Monoids for Aggregate
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <limits>     // for std::numeric_limits
+
+namespace custom
+{
+
+/*****************************************************************
+ * NO AUGMENT
+ * A node knows nothing beyond its own element
+ *****************************************************************/
+struct NoAugment
+{
+   template <class T>
+   struct Meta { };
+
+   static const bool counts = false;
+
+   template <class Node>
+   static void update(Node * /* pNode */) { }
+
+   template <class Node>
+   static void inserted(Node * /* pNode */) { }
+
+   template <class Node>
+   static void erased(Node * /* pParent */) { }
+};
+
+/*****************************************************************
+ * ORDER STATISTIC
+ * Every node counts the elements in its subtree, itself included.
+ * That is what rank(), select(), nth() and count_range() walk down.
+ *****************************************************************/
+struct OrderStatistic
+{
+   template <class T>
+   struct Meta { size_t size = 1; };     // a new node is a leaf
+
+   static const bool counts = true;
+
+   template <class Node>
+   static size_t sizeOf(const Node * pNode) { return pNode ? pNode->size : 0; }
+
+   template <class Node>
+   static void update(Node * pNode)
+   {
+      pNode->size = 1 + sizeOf(pNode->pLeft) + sizeOf(pNode->pRight);
+   }
+
+   // one more below every ancestor: no need to look at the siblings
+   template <class Node>
+   static void inserted(Node * pNode)
+   {
+      for (Node * p = pNode->pParent; p; p = p->pParent)
+         p->size++;
+   }
+
+   template <class Node>
+   static void erased(Node * pParent)
+   {
+      for (; pParent; pParent = pParent->pParent)
+         update(pParent);
+   }
+};
+
+/*****************************************************************
+ * AGGREGATE
+ * Every node counts its subtree, like OrderStatistic, and also
+ * combines all the elements in it with a monoid. That is what
+ * aggregate(lo, hi) puts together in O(log n). The monoid must
+ * be stateless and give:
+ *    result_type            : what an aggregate is
+ *    identity()             : the aggregate of nothing
+ *    lift(element)          : the aggregate of one element
+ *    combine(lhs, rhs)      : the aggregate of lhs's elements followed
+ *                             by rhs's. It must be associative, but it
+ *                             need not be commutative.
+ *****************************************************************/
+template <class Monoid>
+struct Aggregate
+{
+   using result_type = typename Monoid::result_type;
+
+   template <class T>
+   struct Meta : OrderStatistic::Meta<T>
+   {
+      result_type value = result_type();  // set as soon as the node is linked in
+   };
+
+   static const bool counts = true;
+
+   template <class Node>
+   static size_t sizeOf(const Node * pNode) { return OrderStatistic::sizeOf(pNode); }
+
+   // the monoid, for the tree to put the pieces of a range together
+   static result_type identity() { return Monoid().identity(); }
+   static result_type combine(const result_type & lhs, const result_type & rhs)
+   {
+      return Monoid().combine(lhs, rhs);
+   }
+   template <class Node>
+   static result_type lift(const Node * pNode) { return Monoid().lift(pNode->data); }
+   template <class Node>
+   static result_type valueOf(const Node * pNode) { return pNode ? pNode->value : identity(); }
+
+   template <class Node>
+   static void update(Node * pNode)
+   {
+      pNode->size = 1 + sizeOf(pNode->pLeft) + sizeOf(pNode->pRight);
+      pNode->value = combine(combine(valueOf(pNode->pLeft), lift(pNode)), valueOf(pNode->pRight));
+   }
+
+   // the new leaf, then every ancestor, since the siblings are part of it
+   template <class Node>
+   static void inserted(Node * pNode)
+   {
+      for (; pNode; pNode = pNode->pParent)
+         update(pNode);
+   }
+
+   template <class Node>
+   static void erased(Node * pParent)
+   {
+      for (; pParent; pParent = pParent->pParent)
+         update(pParent);
+   }
+};
+
+/*****************************************************************
+ * SUM, MIN, MAX
+ * Monoids for Aggregate over elements that convert to R
+ *****************************************************************/
+template <class R>
+struct Sum
+{
+   using result_type = R;
+   R identity() const { return R(); }
+   template <class T>
+   R lift(const T & t) const { return static_cast<R>(t); }
+   R combine(const R & lhs, const R & rhs) const { return lhs + rhs; }
+};
+
+template <class R>
+struct Min
+{
+   using result_type = R;
+   R identity() const { return std::numeric_limits<R>::max(); }
+   template <class T>
+   R lift(const T & t) const { return static_cast<R>(t); }
+   R combine(const R & lhs, const R & rhs) const { return rhs < lhs ? rhs : lhs; }
+};
+
+template <class R>
+struct Max
+{
+   using result_type = R;
+   R identity() const { return std::numeric_limits<R>::lowest(); }
+   template <class T>
+   R lift(const T & t) const { return static_cast<R>(t); }
+   R combine(const R & lhs, const R & rhs) const { return lhs < rhs ? rhs : lhs; }
+};
+
+} // namespace custom
@@ -0,0 +1,919 @@
+/***********************************************************************
+ * Header:
+ *    BALANCE
+ * Summary:
+ *    The balancing policies for the BST. Pick one with the second
+ *    template parameter: BST <int, AVL>. Each policy gives:
+ *        Meta                : data stored in every node (BNode inherits it)
+ *        Parent<Node>        : how a node points to its parent: Node *, or
+ *                              a TaggedLink that keeps a bit in it too
+ *        State               : data stored once per tree
+ *        inserted()          : called after a new leaf is linked in
+ *        erased()            : called after a node is unlinked
+ *        built()             : called for each node of a tree built from
+ *                              sorted data, bottom up, with its depth, the
+ *                              height of its subtree, and how many levels
+ *                              of the whole tree are full
+ *        join()              : called to hang two trees of the policy under
+ *                              a node that goes between them, and make the
+ *                              whole a tree of the policy at tree.root
+ *        rankAbove()         : how tall a subtree is, the way join() wants
+ *                              to know, from how tall one of its children is
+ *        rankBelow()         : the same, from how tall its parent is
+ *        accessed()          : called with a node looked up by
+ *                              find_and_splay(), for a policy that adapts
+ *                              its shape to what is looked up
+ *    The tree has already updated numElements when a hook is called.
+ *    Everything is static, so the choice costs nothing at run time.
+ *
+ *    This will contain the class definition of:
+ *        Unbalanced          : A plain binary search tree
+ *        RedBlack            : A red-black tree (the default)
+ *        PackedRedBlack      : The same, with the color in the parent pointer
+ *        AVL                 : A height-balanced tree
+ *        Treap               : A tree that is also a heap on random priorities
+ *        Scapegoat           : Rebuilds any subtree that grows too deep
+ *        Splay               : Moves whatever is touched up to the root
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uintptr_t
+#include <cmath>      // for std::log
+
+namespace custom
+{
+
+/*****************************************************************
+ * TAGGED LINK
+ * A pointer to a node (a parent here, a child in lean.h and
+ * threaded.h) that keeps numTags more bits in its lowest bits, which
+ * are always 0 in the address of a node. It reads like a Node * and
+ * takes a new Node * the same way, leaving the bits alone, so the
+ * code that links nodes together never knows they are there. tag()
+ * is the lowest bit, tagAt() any of them.
+ *****************************************************************/
+template <class Node, int numTags = 1>
+class TaggedLink
+{
+   static const uintptr_t mask = ((uintptr_t)1 << numTags) - 1;
+public:
+   TaggedLink(Node * p = nullptr) : bits(reinterpret_cast<uintptr_t>(p)) { }
+   TaggedLink(const TaggedLink & rhs) = default;
+   TaggedLink & operator = (Node * p)
+   {
+      bits = (bits & mask) | reinterpret_cast<uintptr_t>(p);
+      return *this;
+   }
+   TaggedLink & operator = (const TaggedLink & rhs) { return *this = rhs.get(); }
+
+   Node * get() const
+   {
+      static_assert(alignof(Node) > mask, "the tags need the low bits of a node's address");
+      return reinterpret_cast<Node *>(bits & ~mask);
+   }
+   operator Node * ()    const { return get(); }
+   Node * operator -> () const { return get(); }
+
+   bool tag() const        { return tagAt(0); }
+   void tag(bool value)    { tagAt(0, value); }
+   bool tagAt(int which) const { return (bits >> which & 1) != 0; }
+   void tagAt(int which, bool value)
+   {
+      bits = (bits & ~((uintptr_t)1 << which)) | ((uintptr_t)value << which);
+   }
+
+private:
+   uintptr_t bits;
+};
+
+// the tag goes along when a node's policy data is copied, swapped or
+// reset. A plain pointer has none.
+template <class Node>
+void copyTag(Node * & /* lhs */, Node * const & /* rhs */) { }
+template <class Node>
+void copyTag(TaggedLink<Node> & lhs, const TaggedLink<Node> & rhs) { lhs.tag(rhs.tag()); }
+template <class Node>
+void swapTags(Node * & /* lhs */, Node * & /* rhs */) { }
+template <class Node>
+void swapTags(TaggedLink<Node> & lhs, TaggedLink<Node> & rhs)
+{
+   bool tag = lhs.tag();
+   lhs.tag(rhs.tag());
+   rhs.tag(tag);
+}
+template <class Node>
+void clearTag(Node * & /* link */) { }
+template <class Node>
+void clearTag(TaggedLink<Node> & link) { link.tag(false); }
+
+/*****************************************************************
+ * UNBALANCED
+ * Do nothing. The shape depends on the order of insertion.
+ *****************************************************************/
+struct Unbalanced
+{
+   struct Meta  { };
+   struct State { };
+   template <class Node> using Parent = Node *;
+
+   template <class Tree, class Node>
+   static void inserted(Tree & /* tree */, Node * /* pNode */) { }
+
+   template <class Tree, class Node>
+   static void erased(Tree & /* tree */, Node * /* pRemoved */,
+                      Node * /* pChild */, Node * /* pParent */) { }
+
+   template <class Tree, class Node>
+   static void built(Tree & /* tree */, Node * /* pNode */,
+                     size_t /* depth */, size_t /* height */, size_t /* fullLevels */) { }
+
+   // no node ends up deeper than it was when a tree is split
+   template <class Tree, class Node>
+   static size_t join(Tree & tree, Node * pLeft, size_t /* rankLeft */,
+                      Node * pMiddle, Node * pRight, size_t /* rankRight */)
+   {
+      tree.hang(pMiddle, pLeft, pRight, nullptr, false);
+      return 0;
+   }
+
+   template <class Node>
+   static size_t rankAbove(const Node * /* pNode */, size_t /* rankChild */) { return 0; }
+   template <class Node>
+   static size_t rankBelow(const Node * /* pNode */, const Node * /* pParent */, size_t /* rankParent */) { return 0; }
+
+   template <class Tree, class Node>
+   static void accessed(Tree & /* tree */, Node * /* pNode */) { }
+};
+
+/*****************************************************************
+ * COLOR BYTE, COLOR BIT
+ * Where a red-black node keeps its color: in a bool of its own, or
+ * in the lowest bit of its parent pointer, which saves the bool and
+ * the padding after it. The bit is set for black, so a new node is
+ * red either way.
+ *****************************************************************/
+struct ColorByte
+{
+   struct Meta { bool isRed = true; };   // Red-black balancing stuff
+   template <class Node> using Parent = Node *;
+
+   template <class Node>
+   static bool isRed(const Node * pNode) { return pNode->isRed; }
+   template <class Node>
+   static void paint(Node * pNode, bool red) { pNode->isRed = red; }
+};
+
+struct ColorBit
+{
+   struct Meta { };
+   template <class Node> using Parent = TaggedLink<Node>;
+
+   template <class Node>
+   static bool isRed(const Node * pNode) { return !pNode->pParent.tag(); }
+   template <class Node>
+   static void paint(Node * pNode, bool red) { pNode->pParent.tag(!red); }
+};
+
+/*****************************************************************
+ * RED BLACK
+ * No red node has a red child, and every path from a node down to
+ * a null has the same number of black nodes. Color says where the
+ * color is kept.
+ *****************************************************************/
+template <class Color>
+struct BasicRedBlack
+{
+   using Meta = typename Color::Meta;
+   struct State { };
+   template <class Node> using Parent = typename Color::template Parent<Node>;
+
+   template <class Node>
+   static bool isRed(const Node * pNode) { return Color::isRed(pNode); }
+
+   template <class Tree, class Node>
+   static void inserted(Tree & tree, Node * pNode);
+
+   // pRemoved carries the color of the spot that left the tree
+   template <class Tree, class Node>
+   static void erased(Tree & tree, Node * pRemoved, Node * pChild, Node * pParent)
+   {
+      if (!isRed(pRemoved))
+         eraseFixup(tree, pChild, pParent);
+   }
+
+   // a built tree is full down to its last level, so the only red
+   // nodes are the ones on a last level that is not full
+   template <class Tree, class Node>
+   static void built(Tree & /* tree */, Node * pNode, size_t depth, size_t /* height */, size_t fullLevels)
+   {
+      paint(pNode, depth == fullLevels);
+   }
+
+   // the rank is the black height: the black nodes on every path
+   // from the top of the subtree down to a null
+   template <class Tree, class Node>
+   static size_t join(Tree & tree, Node * pLeft, size_t rankLeft,
+                      Node * pMiddle, Node * pRight, size_t rankRight);
+
+   template <class Node>
+   static size_t rankAbove(const Node * pNode, size_t rankChild)
+   {
+      return rankChild + (isRed(pNode) ? 0 : 1);
+   }
+   template <class Node>
+   static size_t rankBelow(const Node * /* pNode */, const Node * pParent, size_t rankParent)
+   {
+      return rankParent - (isRed(pParent) ? 0 : 1);
+   }
+
+   template <class Tree, class Node>
+   static void accessed(Tree & /* tree */, Node * /* pNode */) { }
+
+private:
+   template <class Tree, class Node>
+   static void redFixup(Tree & tree, Node * pNode);
+
+   template <class Tree, class Node>
+   static void eraseFixup(Tree & tree, Node * pNode, Node * pParent);
+
+   template <class Node>
+   static void paint(Node * pNode, bool red) { Color::paint(pNode, red); }
+};
+
+using RedBlack       = BasicRedBlack<ColorByte>;
+using PackedRedBlack = BasicRedBlack<ColorBit>;
+
+/*****************************************************************
+ * AVL
+ * The heights of the two children of every node differ by at most one.
+ *****************************************************************/
+struct AVL
+{
+   struct Meta  { unsigned char height = 1; };
+   struct State { };
+   template <class Node> using Parent = Node *;
+
+   template <class Tree, class Node>
+   static void inserted(Tree & tree, Node * pNode) { retrace(tree, pNode->pParent); }
+
+   template <class Tree, class Node>
+   static void erased(Tree & tree, Node * /* pRemoved */, Node * /* pChild */, Node * pParent)
+   {
+      retrace(tree, pParent);
+   }
+
+   template <class Tree, class Node>
+   static void built(Tree & /* tree */, Node * pNode, size_t /* depth */, size_t height, size_t /* fullLevels */)
+   {
+      pNode->height = (unsigned char)height;
+   }
+
+   // the rank is the height, which every node already knows
+   template <class Tree, class Node>
+   static size_t join(Tree & tree, Node * pLeft, size_t /* rankLeft */,
+                      Node * pMiddle, Node * pRight, size_t /* rankRight */);
+
+   template <class Node>
+   static size_t rankAbove(const Node * pNode, size_t /* rankChild */) { return heightOf(pNode); }
+   template <class Node>
+   static size_t rankBelow(const Node * pNode, const Node * /* pParent */, size_t /* rankParent */)
+   {
+      return heightOf(pNode);
+   }
+
+   template <class Tree, class Node>
+   static void accessed(Tree & /* tree */, Node * /* pNode */) { }
+
+private:
+   template <class Node>
+   static int heightOf(const Node * pNode) { return pNode ? pNode->height : 0; }
+
+   template <class Node>
+   static void update(Node * pNode)
+   {
+      int left  = heightOf(pNode->pLeft);
+      int right = heightOf(pNode->pRight);
+      pNode->height = (unsigned char)(1 + (left > right ? left : right));
+   }
+
+   template <class Tree, class Node>
+   static void retrace(Tree & tree, Node * pNode);
+};
+
+/*****************************************************************
+ * TREAP
+ * A binary search tree on the data and a max-heap on a random
+ * priority, which makes the shape that of a random insertion order.
+ *****************************************************************/
+struct Treap
+{
+   struct Meta  { unsigned int priority = 0; };
+   struct State { unsigned int seed = 2463534242u; };
+   template <class Node> using Parent = Node *;
+
+   template <class Tree, class Node>
+   static void inserted(Tree & tree, Node * pNode);
+
+   // the successor inherited the priority of the spot it took over,
+   // and a node with at most one child can leave without breaking the heap
+   template <class Tree, class Node>
+   static void erased(Tree & /* tree */, Node * /* pRemoved */,
+                      Node * /* pChild */, Node * /* pParent */) { }
+
+   // the height goes in the top bits so every parent outranks its
+   // children; the random bottom bits break the ties
+   template <class Tree, class Node>
+   static void built(Tree & tree, Node * pNode, size_t /* depth */, size_t height, size_t /* fullLevels */)
+   {
+      pNode->priority = ((unsigned int)height << 26) | (random(tree.balanceState) >> 6);
+   }
+
+   // the priorities alone say where pMiddle goes
+   template <class Tree, class Node>
+   static size_t join(Tree & tree, Node * pLeft, size_t /* rankLeft */,
+                      Node * pMiddle, Node * pRight, size_t /* rankRight */);
+
+   template <class Node>
+   static size_t rankAbove(const Node * /* pNode */, size_t /* rankChild */) { return 0; }
+   template <class Node>
+   static size_t rankBelow(const Node * /* pNode */, const Node * /* pParent */, size_t /* rankParent */) { return 0; }
+
+   template <class Tree, class Node>
+   static void accessed(Tree & /* tree */, Node * /* pNode */) { }
+
+private:
+   // xorshift: cheap, and good enough to shuffle a tree
+   static unsigned int random(State & state)
+   {
+      state.seed ^= state.seed << 13;
+      state.seed ^= state.seed >> 17;
+      state.seed ^= state.seed << 5;
+      return state.seed;
+   }
+};
+
+/*****************************************************************
+ * SCAPEGOAT
+ * No per-node data at all. When a new leaf lands too deep, find the
+ * ancestor whose subtree is lopsided and rebuild it from scratch.
+ *****************************************************************/
+struct Scapegoat
+{
+   struct Meta  { };
+   struct State { size_t maxSize = 0; };  // the most elements since the last full rebuild
+   template <class Node> using Parent = Node *;
+
+   template <class Tree, class Node>
+   static void inserted(Tree & tree, Node * pNode);
+
+   template <class Tree, class Node>
+   static void erased(Tree & tree, Node * /* pRemoved */, Node * /* pChild */, Node * /* pParent */)
+   {
+      // shrunk below alpha of its old size: rebuild the whole thing
+      if (3 * tree.numElements < 2 * tree.balanceState.maxSize)
+      {
+         if (tree.root)
+            tree.rebuild(tree.root);
+         tree.balanceState.maxSize = tree.numElements;
+      }
+   }
+
+   template <class Tree, class Node>
+   static void built(Tree & tree, Node * /* pNode */, size_t /* depth */, size_t /* height */, size_t /* fullLevels */)
+   {
+      tree.balanceState.maxSize = tree.numElements;
+   }
+
+   // no per-node data to join by, so hang the three together. While
+   // splitting (the tree counts as empty until the end), that leaves
+   // no node deeper than it was. Joining whole trees adds a level,
+   // so a tree as big as it has been since it was last rebuilt is
+   // rebuilt: O(n).
+   template <class Tree, class Node>
+   static size_t join(Tree & tree, Node * pLeft, size_t /* rankLeft */,
+                      Node * pMiddle, Node * pRight, size_t /* rankRight */)
+   {
+      tree.hang(pMiddle, pLeft, pRight, nullptr, false);
+      if (tree.numElements && tree.numElements >= tree.balanceState.maxSize)
+      {
+         tree.rebuild(tree.root);
+         tree.balanceState.maxSize = tree.numElements;
+      }
+      return 0;
+   }
+
+   template <class Node>
+   static size_t rankAbove(const Node * /* pNode */, size_t /* rankChild */) { return 0; }
+   template <class Node>
+   static size_t rankBelow(const Node * /* pNode */, const Node * /* pParent */, size_t /* rankParent */) { return 0; }
+
+   template <class Tree, class Node>
+   static void accessed(Tree & /* tree */, Node * /* pNode */) { }
+
+private:
+   template <class Node>
+   static size_t count(const Node * pNode)
+   {
+      return pNode ? 1 + count(pNode->pLeft) + count(pNode->pRight) : 0;
+   }
+};
+
+/*****************************************************************
+ * SPLAY
+ * No per-node data either. Every node inserted or looked up with
+ * find_and_splay() is rotated all the way up to the root, so the
+ * keys in use gather near the top, where a lookup is short and its
+ * path stays in the cache. Everything costs O(log n) amortized.
+ *****************************************************************/
+struct Splay
+{
+   struct Meta  { };
+   struct State { };
+   template <class Node> using Parent = Node *;
+
+   template <class Tree, class Node>
+   static void inserted(Tree & tree, Node * pNode) { splay(tree, pNode); }
+
+   // the parent of what left is the last node the erase touched
+   template <class Tree, class Node>
+   static void erased(Tree & tree, Node * /* pRemoved */, Node * /* pChild */, Node * pParent)
+   {
+      if (pParent)
+         splay(tree, pParent);
+   }
+
+   template <class Tree, class Node>
+   static void built(Tree & /* tree */, Node * /* pNode */,
+                     size_t /* depth */, size_t /* height */, size_t /* fullLevels */) { }
+
+   // like Unbalanced: no node ends up deeper than it was when a tree
+   // is split, and the next lookups splay the rest into shape
+   template <class Tree, class Node>
+   static size_t join(Tree & tree, Node * pLeft, size_t /* rankLeft */,
+                      Node * pMiddle, Node * pRight, size_t /* rankRight */)
+   {
+      tree.hang(pMiddle, pLeft, pRight, nullptr, false);
+      return 0;
+   }
+
+   template <class Node>
+   static size_t rankAbove(const Node * /* pNode */, size_t /* rankChild */) { return 0; }
+   template <class Node>
+   static size_t rankBelow(const Node * /* pNode */, const Node * /* pParent */, size_t /* rankParent */) { return 0; }
+
+   template <class Tree, class Node>
+   static void accessed(Tree & tree, Node * pNode) { splay(tree, pNode); }
+
+private:
+   template <class Tree, class Node>
+   static void splay(Tree & tree, Node * pNode);
+
+   // pNode takes its parent's place
+   template <class Tree, class Node>
+   static void rotateUp(Tree & tree, Node * pNode)
+   {
+      if (pNode->isLeftChild())
+         tree.rotateRight(pNode->pParent);
+      else
+         tree.rotateLeft(pNode->pParent);
+   }
+};
+
+
+/******************************************************
+ * RED BLACK :: INSERTED
+ * A new red node was just hung on the tree
+ ******************************************************/
+template <class Color>
+template <class Tree, class Node>
+void BasicRedBlack<Color>::inserted(Tree & tree, Node * pNode)
+{
+   redFixup(tree, pNode);
+   paint(tree.root, false);
+}
+
+/******************************************************
+ * RED BLACK :: JOIN
+ * Walk down the near side of the taller tree to the first black
+ * node as tall as the shorter one, and put pMiddle there, red,
+ * with that node and the shorter tree under it. Only the path
+ * above it can have a red node with a red child, which the insert
+ * fixup takes care of. The cost is the difference in black height.
+ ******************************************************/
+template <class Color>
+template <class Tree, class Node>
+size_t BasicRedBlack<Color>::join(Tree & tree, Node * pLeft, size_t rankLeft,
+                                  Node * pMiddle, Node * pRight, size_t rankRight)
+{
+   // black roots, so a red pMiddle can go right above either one
+   if (pLeft && isRed(pLeft))
+   {
+      paint(pLeft, false);
+      rankLeft++;
+   }
+   if (pRight && isRed(pRight))
+   {
+      paint(pRight, false);
+      rankRight++;
+   }
+
+   size_t rank = (rankLeft > rankRight) ? rankLeft : rankRight;
+   Node* pParent = nullptr;
+   if (rankLeft >= rankRight)
+   {
+      Node* p = pLeft;
+      for (size_t r = rankLeft; r > rankRight || (p && isRed(p)); p = p->pRight)
+      {
+         r -= isRed(p) ? 0 : 1;
+         pParent = p;
+      }
+      tree.root = pLeft;
+      tree.hang(pMiddle, p, pRight, pParent, false /* goLeft */);
+   }
+   else
+   {
+      Node* p = pRight;
+      for (size_t r = rankRight; r > rankLeft || (p && isRed(p)); p = p->pLeft)
+      {
+         r -= isRed(p) ? 0 : 1;
+         pParent = p;
+      }
+      tree.root = pRight;
+      tree.hang(pMiddle, pLeft, p, pParent, true /* goLeft */);
+   }
+
+   paint(pMiddle, true);
+   redFixup(tree, pMiddle);
+
+   // a red root turned black is one more on every path
+   if (isRed(tree.root))
+   {
+      paint(tree.root, false);
+      rank++;
+   }
+   return rank;
+}
+
+/******************************************************
+ * RED BLACK :: RED FIXUP
+ * pNode is red. Recolor and rotate until no red node has a red
+ * parent, which may leave the root red.
+ ******************************************************/
+template <class Color>
+template <class Tree, class Node>
+void BasicRedBlack<Color>::redFixup(Tree & tree, Node * pNode)
+{
+   while (pNode->pParent && isRed<Node>(pNode->pParent))
+   {
+      Node* pParent = pNode->pParent;
+      Node* pGranny = pParent->pParent;
+
+      // a red root is fixed by the recolor below
+      if (!pGranny)
+         break;
+
+      if (pParent == pGranny->pLeft)
+      {
+         Node* pAunt = pGranny->pRight;
+
+         // red aunt: push the blackness down from granny and keep going
+         if (pAunt && isRed(pAunt))
+         {
+            paint(pParent, false);
+            paint(pAunt, false);
+            paint(pGranny, true);
+            pNode = pGranny;
+         }
+         // black aunt: at most two rotations and we are done
+         else
+         {
+            if (pNode == pParent->pRight)
+            {
+               pNode = pParent;
+               tree.rotateLeft(pNode);
+               pParent = pNode->pParent;
+            }
+            paint(pParent, false);
+            paint(pGranny, true);
+            tree.rotateRight(pGranny);
+         }
+      }
+      else
+      {
+         Node* pAunt = pGranny->pLeft;
+
+         if (pAunt && isRed(pAunt))
+         {
+            paint(pParent, false);
+            paint(pAunt, false);
+            paint(pGranny, true);
+            pNode = pGranny;
+         }
+         else
+         {
+            if (pNode == pParent->pLeft)
+            {
+               pNode = pParent;
+               tree.rotateRight(pNode);
+               pParent = pNode->pParent;
+            }
+            paint(pParent, false);
+            paint(pGranny, true);
+            tree.rotateLeft(pGranny);
+         }
+      }
+   }
+}
+
+/******************************************************
+ * RED BLACK :: ERASE FIXUP
+ * A black node was removed from above pNode (which may be null),
+ * leaving that path one black short. Borrow from the sibling or
+ * push the shortage up until it can be absorbed.
+ ******************************************************/
+template <class Color>
+template <class Tree, class Node>
+void BasicRedBlack<Color>::eraseFixup(Tree & tree, Node * pNode, Node * pParent)
+{
+   while (pNode != tree.root && (!pNode || !isRed(pNode)))
+   {
+      if (pNode == pParent->pLeft)
+      {
+         Node* pSibling = pParent->pRight;
+
+         // red sibling: rotate so the sibling is black
+         if (isRed(pSibling))
+         {
+            paint(pSibling, false);
+            paint(pParent, true);
+            tree.rotateLeft(pParent);
+            pSibling = pParent->pRight;
+         }
+
+         // both nephews black: the sibling can give up its blackness
+         if ((!pSibling->pLeft  || !isRed(pSibling->pLeft)) &&
+             (!pSibling->pRight || !isRed(pSibling->pRight)))
+         {
+            paint(pSibling, true);
+            pNode = pParent;
+            pParent = pNode->pParent;
+         }
+         // a red nephew: rotate it over and we are done
+         else
+         {
+            if (!pSibling->pRight || !isRed(pSibling->pRight))
+            {
+               paint(pSibling->pLeft, false);
+               paint(pSibling, true);
+               tree.rotateRight(pSibling);
+               pSibling = pParent->pRight;
+            }
+            paint(pSibling, isRed(pParent));
+            paint(pParent, false);
+            paint(pSibling->pRight, false);
+            tree.rotateLeft(pParent);
+            pNode = tree.root;
+         }
+      }
+      else
+      {
+         Node* pSibling = pParent->pLeft;
+
+         if (isRed(pSibling))
+         {
+            paint(pSibling, false);
+            paint(pParent, true);
+            tree.rotateRight(pParent);
+            pSibling = pParent->pLeft;
+         }
+
+         if ((!pSibling->pLeft  || !isRed(pSibling->pLeft)) &&
+             (!pSibling->pRight || !isRed(pSibling->pRight)))
+         {
+            paint(pSibling, true);
+            pNode = pParent;
+            pParent = pNode->pParent;
+         }
+         else
+         {
+            if (!pSibling->pLeft || !isRed(pSibling->pLeft))
+            {
+               paint(pSibling->pRight, false);
+               paint(pSibling, true);
+               tree.rotateLeft(pSibling);
+               pSibling = pParent->pLeft;
+            }
+            paint(pSibling, isRed(pParent));
+            paint(pParent, false);
+            paint(pSibling->pLeft, false);
+            tree.rotateRight(pParent);
+            pNode = tree.root;
+         }
+      }
+   }
+
+   if (pNode)
+      paint(pNode, false);
+}
+
+/******************************************************
+ * AVL :: RETRACE
+ * Walk from pNode up to the root fixing heights, and rotate
+ * wherever the children differ by two.
+ ******************************************************/
+template <class Tree, class Node>
+void AVL::retrace(Tree & tree, Node * pNode)
+{
+   while (pNode)
+   {
+      update(pNode);
+      int balance = heightOf(pNode->pLeft) - heightOf(pNode->pRight);
+
+      // left heavy: pull the left child up (through its right child if need be)
+      if (balance > 1)
+      {
+         Node* pLeft = pNode->pLeft;
+         if (heightOf(pLeft->pLeft) < heightOf(pLeft->pRight))
+         {
+            tree.rotateLeft(pLeft);
+            update(pLeft);
+            update(pLeft->pParent);
+         }
+         tree.rotateRight(pNode);
+         update(pNode);
+         pNode = pNode->pParent;
+         update(pNode);
+      }
+      // right heavy: the mirror image
+      else if (balance < -1)
+      {
+         Node* pRight = pNode->pRight;
+         if (heightOf(pRight->pRight) < heightOf(pRight->pLeft))
+         {
+            tree.rotateRight(pRight);
+            update(pRight);
+            update(pRight->pParent);
+         }
+         tree.rotateLeft(pNode);
+         update(pNode);
+         pNode = pNode->pParent;
+         update(pNode);
+      }
+
+      pNode = pNode->pParent;
+   }
+}
+
+/******************************************************
+ * AVL :: JOIN
+ * Walk down the near side of the taller tree to the first node
+ * at most one taller than the shorter tree, and put pMiddle there
+ * with that node and the shorter tree under it. Retracing from
+ * pMiddle fixes the heights and does at most one (double) rotation
+ * that matters. The cost is the difference in height.
+ ******************************************************/
+template <class Tree, class Node>
+size_t AVL::join(Tree & tree, Node * pLeft, size_t /* rankLeft */,
+                 Node * pMiddle, Node * pRight, size_t /* rankRight */)
+{
+   int left  = heightOf(pLeft);
+   int right = heightOf(pRight);
+   Node* pParent = nullptr;
+   if (left > right + 1)
+   {
+      Node* p = pLeft;
+      while (heightOf(p) > right + 1)
+      {
+         pParent = p;
+         p = p->pRight;
+      }
+      tree.root = pLeft;
+      tree.hang(pMiddle, p, pRight, pParent, false /* goLeft */);
+   }
+   else if (right > left + 1)
+   {
+      Node* p = pRight;
+      while (heightOf(p) > left + 1)
+      {
+         pParent = p;
+         p = p->pLeft;
+      }
+      tree.root = pRight;
+      tree.hang(pMiddle, pLeft, p, pParent, true /* goLeft */);
+   }
+   else
+      tree.hang(pMiddle, pLeft, pRight, nullptr, false);
+
+   retrace(tree, pMiddle);
+   return heightOf(tree.root);
+}
+
+/******************************************************
+ * TREAP :: JOIN
+ * Put pMiddle on top, then rotate it down under whichever child
+ * outranks it until neither does. A node joined with the subtrees
+ * it used to be above (as when splitting) stays on top.
+ ******************************************************/
+template <class Tree, class Node>
+size_t Treap::join(Tree & tree, Node * pLeft, size_t /* rankLeft */,
+                   Node * pMiddle, Node * pRight, size_t /* rankRight */)
+{
+   tree.hang(pMiddle, pLeft, pRight, nullptr, false);
+   for (;;)
+   {
+      Node* pChild = pMiddle->pLeft;
+      if (!pChild || (pMiddle->pRight && pChild->priority < pMiddle->pRight->priority))
+         pChild = pMiddle->pRight;
+      if (!pChild || !(pMiddle->priority < pChild->priority))
+         break;
+      if (pChild == pMiddle->pLeft)
+         tree.rotateRight(pMiddle);
+      else
+         tree.rotateLeft(pMiddle);
+   }
+   return 0;
+}
+
+/******************************************************
+ * TREAP :: INSERTED
+ * Draw a priority for the new leaf and rotate it up past every
+ * parent with a lower priority.
+ ******************************************************/
+template <class Tree, class Node>
+void Treap::inserted(Tree & tree, Node * pNode)
+{
+   pNode->priority = random(tree.balanceState);
+   while (pNode->pParent && pNode->pParent->priority < pNode->priority)
+   {
+      if (pNode->isLeftChild())
+         tree.rotateRight(pNode->pParent);
+      else
+         tree.rotateLeft(pNode->pParent);
+   }
+}
+
+/******************************************************
+ * SCAPEGOAT :: INSERTED
+ * If the new leaf is deeper than log 3/2 (n), climb until we find a
+ * node with one child holding more than 2/3 of its subtree and
+ * rebuild that node's subtree.
+ ******************************************************/
+template <class Tree, class Node>
+void Scapegoat::inserted(Tree & tree, Node * pNode)
+{
+   if (tree.numElements > tree.balanceState.maxSize)
+      tree.balanceState.maxSize = tree.numElements;
+
+   size_t depth = 0;
+   for (Node* p = pNode; p->pParent; p = p->pParent)
+      depth++;
+   if ((double)depth <= std::log((double)tree.numElements) / std::log(1.5))
+      return;
+
+   size_t size = 1;
+   for (Node* pChild = pNode; pChild->pParent; pChild = pChild->pParent)
+   {
+      Node* pParent = pChild->pParent;
+      Node* pSibling = pChild->isLeftChild() ? pParent->pRight : pParent->pLeft;
+      size_t sizeParent = size + 1 + count(pSibling);
+      if (3 * size > 2 * sizeParent)
+      {
+         tree.rebuild(pParent);
+         return;
+      }
+      size = sizeParent;
+   }
+}
+
+/******************************************************
+ * SPLAY :: SPLAY
+ * Rotate pNode up to the root, two levels at a time. When pNode
+ * and its parent are on the same side, the grandparent goes down
+ * first (zig-zig), which is what roughly halves the depth of every
+ * node on the way. Otherwise pNode goes up twice (zig-zag).
+ ******************************************************/
+template <class Tree, class Node>
+void Splay::splay(Tree & tree, Node * pNode)
+{
+   while (Node * pParent = pNode->pParent)
+   {
+      if (!pParent->pParent)
+         rotateUp(tree, pNode);
+      else if (pNode->isLeftChild() == pParent->isLeftChild())
+      {
+         rotateUp(tree, pParent);
+         rotateUp(tree, pNode);
+      }
+      else
+      {
+         rotateUp(tree, pNode);
+         rotateUp(tree, pNode);
+      }
+   }
+}
+
+} // namespace custom
@@ -0,0 +1,610 @@
+/***********************************************************************
+ * Program:
+ *    Benchmark
+ * Summary:
+ *    Time the BST balancing policies against each other. Build it on
+ *    its own, with optimization, and pass the number of keys:
+ *        g++ -O2 -std=c++14 benchBST.cpp -o benchBST
+ *        ./benchBST 1000000
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#include "bst.h"          // for BST and the balancing policies
+#include "parallel.h"     // for Parallel
+#include "lean.h"         // for LeanTree
+#include "threaded.h"     // for ThreadedTree
+#include "compact.h"      // for CompactTree
+
+#include <chrono>         // for std::chrono::steady_clock
+#include <cmath>          // for std::pow
+#include <cstdlib>        // for std::atoi
+#include <iomanip>        // for std::setw
+#include <iterator>       // for std::next
+#include <iostream>       // for std::cout
+#include <random>         // for std::mt19937
+#include <string>         // for std::string
+#include <vector>         // for std::vector
+#include <algorithm>      // for std::shuffle and std::lower_bound
+
+/**********************************************************************
+ * TIMER
+ * Milliseconds spent running a function
+ ***********************************************************************/
+template <class Function>
+double time(Function f)
+{
+   auto begin = std::chrono::steady_clock::now();
+   f();
+   auto end = std::chrono::steady_clock::now();
+   return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+/**********************************************************************
+ * RUN
+ * Insert the keys, look every one of them up, then erase them all
+ ***********************************************************************/
+template <class Tree>
+void run(const std::string & name, const std::vector<int> & keys)
+{
+   Tree bst;
+   long found = 0;
+
+   double msInsert = time([&]() {
+      for (int key : keys)
+         bst.insert(key);
+   });
+   double msFind = time([&]() {
+      for (int key : keys)
+         found += (bst.find(key) != bst.end());
+   });
+   double msErase = time([&]() {
+      for (int key : keys)
+      {
+         auto it = bst.find(key);
+         bst.erase(it);
+      }
+   });
+
+   std::cout << std::setw(12) << name
+             << std::setw(12) << msInsert
+             << std::setw(12) << msFind
+             << std::setw(12) << msErase
+             << (found == (long)keys.size() ? "" : "   (lost keys!)")
+             << "\n";
+}
+
+/**********************************************************************
+ * BULK
+ * Load sorted keys one insert at a time, then each appended at
+ * end(), then all at once
+ ***********************************************************************/
+template <class Tree>
+void bulk(const std::string & name, const std::vector<int> & keys)
+{
+   Tree bstInsert;
+   Tree bstAppend;
+   Tree bstSorted;
+
+   double msInsert = time([&]() {
+      for (int key : keys)
+         bstInsert.insert(key);
+   });
+   double msAppend = time([&]() {
+      for (int key : keys)
+         bstAppend.insert(bstAppend.end(), key);
+   });
+   double msSorted = time([&]() {
+      bstSorted.assign_sorted(keys.begin(), keys.end());
+   });
+
+   std::cout << std::setw(12) << name
+             << std::setw(12) << msInsert
+             << std::setw(12) << msAppend
+             << std::setw(12) << msSorted
+             << "\n";
+}
+
+/**********************************************************************
+ * PERCENTILES
+ * The 99th percentile of a tree, again and again: by walking an
+ * iterator there, and by select() on a tree that counts
+ ***********************************************************************/
+void percentiles(const std::vector<int> & keys)
+{
+   const int numQueries = 10;
+   custom::BST <int> bstPlain;
+   custom::BST <int, custom::RedBlack, std::less<int>, std::allocator<int>, custom::OrderStatistic> bstCounted;
+   double msPlain = time([&]() {
+      for (int key : keys)
+         bstPlain.insert(key);
+   });
+   double msCounted = time([&]() {
+      for (int key : keys)
+         bstCounted.insert(key);
+   });
+
+   size_t position = keys.size() * 99 / 100;
+   long sum = 0;
+   double msWalk = time([&]() {
+      for (int i = 0; i < numQueries; i++)
+         sum += *std::next(bstPlain.begin(), position);
+   });
+   double msSelect = time([&]() {
+      for (int i = 0; i < numQueries; i++)
+         sum += bstCounted.select(position);
+   });
+
+   std::cout << "\nPercentiles (" << keys.size() << " keys, " << numQueries << " p99 queries, ms)\n"
+             << std::setw(12) << "tree"
+             << std::setw(12) << "insert"
+             << std::setw(12) << "p99" << "\n"
+             << std::setw(12) << "plain"
+             << std::setw(12) << msPlain
+             << std::setw(12) << msWalk << "\n"
+             << std::setw(12) << "counted"
+             << std::setw(12) << msCounted
+             << std::setw(12) << msSelect
+             << (sum == 2L * numQueries * *std::next(bstPlain.begin(), position) ? "" : "   (wrong answer!)")
+             << "\n";
+}
+
+/**********************************************************************
+ * WORKLOAD
+ * Every policy against one ordering of the keys
+ ***********************************************************************/
+void workload(const std::string & title, const std::vector<int> & keys, bool sorted)
+{
+   std::cout << "\n" << title << " (" << keys.size() << " keys, ms)\n"
+             << std::setw(12) << "policy"
+             << std::setw(12) << "insert"
+             << std::setw(12) << "find"
+             << std::setw(12) << "erase" << "\n";
+
+   // sorted input makes the unbalanced tree quadratic
+   if (sorted)
+      std::cout << std::setw(12) << "unbalanced" << "     skipped\n";
+   else
+      run <custom::BST <int, custom::Unbalanced>> ("unbalanced", keys);
+   run <custom::BST <int, custom::RedBlack>>  ("red-black", keys);
+   run <custom::BST <int, custom::AVL>>       ("AVL",       keys);
+   run <custom::BST <int, custom::Treap>>     ("treap",     keys);
+   run <custom::BST <int, custom::Scapegoat>> ("scapegoat", keys);
+}
+
+/**********************************************************************
+ * RESHARD
+ * Move the upper part of a counted tree out and back: by walking it
+ * and inserting into a new tree, against split() and join()
+ ***********************************************************************/
+void reshard(const std::vector<int> & keys)
+{
+   const int numQueries = 10;
+   using Counted = custom::BST <int, custom::RedBlack, std::less<int>, std::allocator<int>, custom::OrderStatistic>;
+   Counted bst;
+   for (int key : keys)
+      bst.insert(key);
+
+   size_t num = 0;
+   double msCopy = time([&]() {
+      for (int i = 0; i < numQueries; i++)
+      {
+         Counted bstUpper;
+         for (auto it = bst.lower_bound(keys[i]); it != bst.end(); ++it)
+            bstUpper.insert(bstUpper.end(), *it);
+         num += bstUpper.size();
+      }
+   });
+   double msSplit = time([&]() {
+      for (int i = 0; i < numQueries; i++)
+      {
+         Counted bstUpper = bst.split(keys[i]);
+         num -= bstUpper.size();
+         bst.join(bstUpper);
+      }
+   });
+
+   std::cout << "\nReshard (" << keys.size() << " keys, " << numQueries << " moves of a key range, ms)\n"
+             << std::setw(12) << "reinsert"
+             << std::setw(12) << "split+join" << "\n"
+             << std::setw(12) << msCopy
+             << std::setw(12) << msSplit
+             << (num == 0 && bst.size() == keys.size() ? "" : "   (wrong answer!)")
+             << "\n";
+}
+
+/**********************************************************************
+ * INTERSECT
+ * What a small tree and a large one have in common: by looking
+ * each of the small one up in the large one, and by intersecting.
+ * Then two halves of the keys, also in parallel.
+ ***********************************************************************/
+void intersect(const std::vector<int> & keys)
+{
+   custom::BST <int> bstAll;
+   custom::BST <int> bstFew;
+   custom::BST <int> bstEvens;
+   custom::BST <int> bstThirds;
+   for (int key : keys)
+   {
+      bstAll.insert(key);
+      if (key % 1000 == 0)
+         bstFew.insert(key);
+      if (key % 2 == 0)
+         bstEvens.insert(key);
+      if (key % 3 == 0)
+         bstThirds.insert(key);
+   }
+
+   size_t numFound = 0;
+   size_t numIntersected = 0;
+   auto findEach = [&](const custom::BST <int> & bstSmall, const custom::BST <int> & bstLarge) {
+      custom::BST <int> bstCommon;
+      for (int key : bstSmall)
+         if (bstLarge.contains(key))
+            bstCommon.insert(bstCommon.end(), key);
+      numFound += bstCommon.size();
+   };
+   double msFindFew = time([&]() { findEach(bstFew, bstAll); });
+   double msFew = time([&]() { numIntersected += set_intersection(bstFew, bstAll).size(); });
+   double msFindHalves = time([&]() { findEach(bstThirds, bstEvens); });
+   double msHalves = time([&]() { numIntersected += set_intersection(bstEvens, bstThirds).size(); });
+   double msParallel = time([&]() { numIntersected += set_intersection(bstEvens, bstThirds, custom::Parallel()).size(); });
+
+   std::cout << "\nIntersect (" << keys.size() << " keys, ms)\n"
+             << std::setw(12) << "trees"
+             << std::setw(12) << "find each"
+             << std::setw(12) << "intersect"
+             << std::setw(12) << "parallel" << "\n"
+             << std::setw(12) << "n/1000, n"
+             << std::setw(12) << msFindFew
+             << std::setw(12) << msFew << "\n"
+             << std::setw(12) << "n/3, n/2"
+             << std::setw(12) << msFindHalves
+             << std::setw(12) << msHalves
+             << std::setw(12) << msParallel
+             << (2 * numFound == numIntersected + bstFew.size() ? "" : "   (wrong answer!)")
+             << "\n";
+}
+
+/**********************************************************************
+ * REKEY
+ * Give many elements a new key: by erasing and inserting again,
+ * and by taking the node out and putting it back
+ ***********************************************************************/
+void rekey(const std::vector<int> & keys)
+{
+   const int shift = (int)keys.size();
+   custom::BST <int> bstErase;
+   custom::BST <int> bstExtract;
+   for (int key : keys)
+   {
+      bstErase.insert(key);
+      bstExtract.insert(key);
+   }
+
+   size_t numRekeyed = keys.size() / 10;
+   double msErase = time([&]() {
+      for (size_t i = 0; i < numRekeyed; i++)
+      {
+         auto it = bstErase.find(keys[i]);
+         bstErase.erase(it);
+         bstErase.insert(keys[i] + shift);
+      }
+   });
+   double msExtract = time([&]() {
+      for (size_t i = 0; i < numRekeyed; i++)
+      {
+         auto node = bstExtract.extract(keys[i]);
+         node.value() += shift;
+         bstExtract.insert(std::move(node));
+      }
+   });
+
+   std::cout << "\nRekey (" << keys.size() << " keys, " << numRekeyed << " new keys, ms)\n"
+             << std::setw(12) << "erase+insert"
+             << std::setw(12) << "extract" << "\n"
+             << std::setw(12) << msErase
+             << std::setw(12) << msExtract
+             << (bstErase.back() == bstExtract.back() && bstErase.size() == bstExtract.size() ? "" : "   (wrong answer!)")
+             << "\n";
+}
+
+/**********************************************************************
+ * REBALANCE
+ * A sorted burst into an Unbalanced tree: left as a vine, kept
+ * shallow as it goes with auto_rebalance(), and rebalanced once at
+ * the end. Each then looks up every key.
+ ***********************************************************************/
+void rebalance(size_t num)
+{
+   custom::BST <int, custom::Unbalanced> bstVine;
+   custom::BST <int, custom::Unbalanced> bstAuto;
+   custom::BST <int, custom::Unbalanced> bstOnce;
+   bstAuto.auto_rebalance(2.0);
+
+   // a vine costs O(n) for each insert at its bottom, so build it from the top
+   double msVine = time([&]() {
+      for (size_t i = num; i > 0; i--)
+         bstVine.insert(bstVine.begin(), (int)i);
+   });
+   double msAuto = time([&]() {
+      for (size_t i = 1; i <= num; i++)
+         bstAuto.insert(bstAuto.end(), (int)i);
+   });
+   double msOnce = time([&]() {
+      for (size_t i = 1; i <= num; i++)
+         bstOnce.insert(bstOnce.end(), (int)i);
+      bstOnce.rebalance();
+   });
+
+   auto lookups = [&](custom::BST <int, custom::Unbalanced> & bst, size_t numLookups) {
+      size_t numFound = 0;
+      for (size_t i = 1; i <= numLookups; i++)
+         numFound += bst.find((int)(i * 7919 % num + 1)) != bst.end();
+      return numFound;
+   };
+   size_t numFound = 0;
+   double msFindVine = time([&]() { numFound += lookups(bstVine, 100); });
+   double msFindAuto = time([&]() { numFound += lookups(bstAuto, num); });
+   double msFindOnce = time([&]() { numFound += lookups(bstOnce, num); });
+
+   std::cout << "\nRebalance (" << num << " sorted keys, ms; the vine only looks up 100)\n"
+             << std::setw(12) << ""
+             << std::setw(12) << "vine"
+             << std::setw(12) << "auto"
+             << std::setw(12) << "once" << "\n"
+             << std::setw(12) << "build"
+             << std::setw(12) << msVine
+             << std::setw(12) << msAuto
+             << std::setw(12) << msOnce << "\n"
+             << std::setw(12) << "find"
+             << std::setw(12) << msFindVine
+             << std::setw(12) << msFindAuto
+             << std::setw(12) << msFindOnce << "\n"
+             << std::setw(12) << "height"
+             << std::setw(12) << bstVine.height()
+             << std::setw(12) << bstAuto.height()
+             << std::setw(12) << bstOnce.height()
+             << (numFound == 100 + 2 * num ? "" : "   (wrong answer!)")
+             << "\n";
+}
+
+/**********************************************************************
+ * SKEWED
+ * Look keys up with a Zipf distribution, s = 1.4, where a few hundred
+ * keys get 90% of the lookups, and again with every key as likely:
+ * a red-black tree with find() against a splay tree with
+ * find_and_splay()
+ ***********************************************************************/
+void skewed(const std::vector<int> & keys)
+{
+   // the i-th key in keys is the i-th most popular
+   std::vector<double> cumulative;
+   double total = 0.0;
+   for (size_t i = 0; i < keys.size(); i++)
+      cumulative.push_back(total += 1.0 / std::pow((double)(i + 1), 1.4));
+   std::mt19937 random(877);
+   std::uniform_real_distribution<double> uniform(0.0, total);
+   std::vector<int> lookupsZipf;
+   std::vector<int> lookupsUniform;
+   for (size_t i = 0; i < keys.size(); i++)
+   {
+      size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), uniform(random)) - cumulative.begin();
+      lookupsZipf.push_back(keys[rank < keys.size() ? rank : keys.size() - 1]);
+      lookupsUniform.push_back(keys[random() % keys.size()]);
+   }
+
+   custom::BST <int, custom::RedBlack> bstRedBlack;
+   custom::BST <int, custom::Splay>    bstSplay;
+   for (int key : keys)
+   {
+      bstRedBlack.insert(key);
+      bstSplay.insert(key);
+   }
+
+   long numFound = 0;
+   auto findAll = [&](custom::BST <int, custom::RedBlack> & bst, const std::vector<int> & lookups) {
+      for (int key : lookups)
+         numFound += bst.find(key) != bst.end();
+   };
+   auto splayAll = [&](custom::BST <int, custom::Splay> & bst, const std::vector<int> & lookups) {
+      for (int key : lookups)
+         numFound += bst.find_and_splay(key) != bst.end();
+   };
+   double msRedBlackZipf    = time([&]() { findAll(bstRedBlack, lookupsZipf); });
+   double msSplayZipf       = time([&]() { splayAll(bstSplay, lookupsZipf); });
+   double msRedBlackUniform = time([&]() { findAll(bstRedBlack, lookupsUniform); });
+   double msSplayUniform    = time([&]() { splayAll(bstSplay, lookupsUniform); });
+
+   std::cout << "\nSkewed lookups (" << keys.size() << " keys, as many lookups, ms)\n"
+             << std::setw(12) << "policy"
+             << std::setw(12) << "zipf"
+             << std::setw(12) << "uniform" << "\n"
+             << std::setw(12) << "red-black"
+             << std::setw(12) << msRedBlackZipf
+             << std::setw(12) << msRedBlackUniform << "\n"
+             << std::setw(12) << "splay"
+             << std::setw(12) << msSplayZipf
+             << std::setw(12) << msSplayUniform
+             << (numFound == 4 * (long)keys.size() ? "" : "   (wrong answer!)")
+             << "\n";
+}
+
+/**********************************************************************
+ * COUNTING ALLOCATOR
+ * std::allocator that adds up the bytes it hands out
+ ***********************************************************************/
+size_t bytesAllocated = 0;
+
+template <class T>
+struct CountingAllocator
+{
+   using value_type = T;
+   CountingAllocator() { }
+   template <class U>
+   CountingAllocator(const CountingAllocator<U> &) { }
+   T * allocate(size_t num)
+   {
+      bytesAllocated += num * sizeof(T);
+      return std::allocator<T>().allocate(num);
+   }
+   void deallocate(T * p, size_t num)
+   {
+      bytesAllocated -= num * sizeof(T);
+      std::allocator<T>().deallocate(p, num);
+   }
+   template <class U>
+   bool operator == (const CountingAllocator<U> &) const { return true; }
+   template <class U>
+   bool operator != (const CountingAllocator<U> &) const { return false; }
+};
+
+/**********************************************************************
+ * PACKED
+ * 8-byte keys in red-black nodes with a color of their own, with
+ * the color in the parent pointer, with no parent pointer at all,
+ * and with 32-bit links into one array: the memory per element,
+ * and the time to insert, find and erase them all
+ ***********************************************************************/
+template <class Tree>
+void packedRow(const std::string & name, const std::vector<int> & keys)
+{
+   long found = 0;
+   bytesAllocated = 0;
+   Tree bst;
+   double msInsert = time([&]() {
+      for (int key : keys)
+         bst.insert((long long)key << 20);
+   });
+   double bytesPer = (double)bytesAllocated / keys.size();
+   double msFind = time([&]() {
+      for (int key : keys)
+         found += bst.find((long long)key << 20) != bst.end();
+   });
+   double msErase = time([&]() {
+      for (int key : keys)
+      {
+         auto it = bst.find((long long)key << 20);
+         bst.erase(it);
+      }
+   });
+   std::cout << std::setw(12) << name
+             << std::setw(12) << bytesPer
+             << std::setw(12) << msInsert
+             << std::setw(12) << msFind
+             << std::setw(12) << msErase
+             << (found == (long)keys.size() && bst.empty() ? "" : "   (wrong answer!)")
+             << "\n";
+}
+
+void packed(const std::vector<int> & keys)
+{
+   std::cout << "\nPacked nodes (" << keys.size() << " 8-byte keys, ms)\n"
+             << std::setw(12) << "policy"
+             << std::setw(12) << "bytes each"
+             << std::setw(12) << "insert"
+             << std::setw(12) << "find"
+             << std::setw(12) << "erase" << "\n";
+   using Alloc = CountingAllocator<long long>;
+   packedRow <custom::BST <long long, custom::RedBlack, std::less<long long>, Alloc>>       ("red-black", keys);
+   packedRow <custom::BST <long long, custom::PackedRedBlack, std::less<long long>, Alloc>> ("packed",    keys);
+   packedRow <custom::LeanTree <long long, std::less<long long>, Alloc>>                   ("lean",      keys);
+   packedRow <custom::CompactTree <long long, std::less<long long>, Alloc>>                ("compact",   keys);
+}
+
+/**********************************************************************
+ * PAGING
+ * Cursors that page through the tree: find a random key, then step
+ * forward, or back, a page of elements from there. The parents
+ * climb, the lean tree pops its path, and the threads go straight
+ * to the next node.
+ ***********************************************************************/
+template <class Tree>
+void pagingRow(const std::string & name, const std::vector<int> & keys)
+{
+   const int pageSize = 100;
+   Tree bst;
+   for (int key : keys)
+      bst.insert(key);
+
+   long sum = 0;
+   double msForward = time([&]() {
+      for (size_t i = 0; i < keys.size(); i += pageSize)
+      {
+         auto it = bst.lower_bound(keys[i]);
+         for (int j = 0; j < pageSize && it != bst.end(); j++, ++it)
+            sum += *it;
+      }
+   });
+   double msBackward = time([&]() {
+      auto itBegin = bst.begin();
+      for (size_t i = 0; i < keys.size(); i += pageSize)
+      {
+         auto it = bst.lower_bound(keys[i]);
+         for (int j = 0; j < pageSize && it != itBegin; j++)
+            sum -= *--it;
+      }
+   });
+   double msWalk = time([&]() {
+      for (int key : bst)
+         sum += key;
+   });
+
+   std::cout << std::setw(12) << name
+             << std::setw(12) << msForward
+             << std::setw(12) << msBackward
+             << std::setw(12) << msWalk
+             << "\n";
+}
+
+void paging(const std::vector<int> & keys)
+{
+   std::cout << "\nPaging (" << keys.size() << " keys, pages of 100, ms)\n"
+             << std::setw(12) << "tree"
+             << std::setw(12) << "forward"
+             << std::setw(12) << "backward"
+             << std::setw(12) << "walk" << "\n";
+   pagingRow <custom::BST <int>>          ("red-black", keys);
+   pagingRow <custom::LeanTree <int>>     ("lean",      keys);
+   pagingRow <custom::ThreadedTree <int>> ("threaded",  keys);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   int num = (argc > 1) ? std::atoi(argv[1]) : 100000;
+
+   std::vector<int> keys;
+   for (int i = 0; i < num; i++)
+      keys.push_back(i);
+   std::cout << std::fixed << std::setprecision(1);
+
+   workload("Sorted", keys, true /* sorted */);
+
+   std::cout << "\nBulk load (" << keys.size() << " sorted keys, ms)\n"
+             << std::setw(12) << "policy"
+             << std::setw(12) << "insert"
+             << std::setw(12) << "append"
+             << std::setw(12) << "sorted" << "\n";
+   bulk <custom::BST <int, custom::RedBlack>>  ("red-black", keys);
+   bulk <custom::BST <int, custom::AVL>>       ("AVL",       keys);
+   bulk <custom::BST <int, custom::Treap>>     ("treap",     keys);
+   bulk <custom::BST <int, custom::Scapegoat>> ("scapegoat", keys);
+
+   std::mt19937 random(232);
+   std::shuffle(keys.begin(), keys.end(), random);
+   workload("Random", keys, false /* sorted */);
+   percentiles(keys);
+   reshard(keys);
+   intersect(keys);
+   rekey(keys);
+   rebalance(keys.size());
+   skewed(keys);
+   packed(keys);
+   paging(keys);
+
+   return 0;
+}
@@ -13,6 +13,14 @@
  *    This will contain the class definition of:
  *        BST                 : A class that represents a binary search tree
  *        BST::iterator       : An iterator through BST
+ *        BST::node_type      : A node taken out of a BST, element and all
+ *
+ *    set.h and map.h build custom::set and custom::map on top of it.
+ *
+ *    The balancing algorithm is chosen with the Balance template
+ *    parameter. See balance.h for the policies. What else each node
+ *    keeps about its subtree, such as its size, is chosen with the
+ *    Augment template parameter. See augment.h.
  * Author
  *    Joshua Sooaemalelagi & Brooklyn Sowards
  ************************************************************************/
@@ -27,58 +35,272 @@
 
 #include <cassert>
 #include <utility>
-#include <memory>     // for std::allocator
+#include <memory>     // for std::allocator and std::allocator_traits
 #include <functional> // for std::less
 #include <utility>    // for std::pair
+#include <vector>     // for std::vector
+#include <iterator>   // for std::distance, std::reverse_iterator and the iterator tags
+#include <type_traits> // for std::is_trivially_destructible and std::integral_constant
+#include <cmath>      // for std::log2
+#include "balance.h"  // for RedBlack and the other balancing policies
+#include "augment.h"  // for NoAugment and OrderStatistic
+#include "pool.h"     // for NodePool
+
+// std::pmr arrived with C++17; MSVC only reports it through _MSVC_LANG
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <memory_resource> // for std::pmr::polymorphic_allocator
+#define CUSTOM_HAS_PMR
+#endif
 
 class TestBST; // forward declaration for unit tests
 class TestMap;
 class TestSet;
+class TestInterval;
 
 namespace custom
 {
 
-   template <class TT>
+   template <class TT, class CC, class AA, class BB>
    class set;
-   template <class KK, class VV>
+   template <class KK, class VV, class CC, class AA, class BB>
    class map;
+   template <class PP, class BB, class AA>
+   class IntervalTree;
+
+/*****************************************************************
+ * SERIAL
+ * How the set algebra works out two halves: one after the other,
+ * on this thread. Parallel in parallel.h gives them threads.
+ *****************************************************************/
+struct Serial
+{
+   // how many levels of halves get threads of their own
+   static int forksFor(size_t /* numSmaller */) { return 0; }
+
+   // run left() and right()
+   template <class Left, class Right>
+   static void both(Left left, Right right) { left(); right(); }
+};
 
 /*****************************************************************
  * BINARY SEARCH TREE
  * Create a Binary Search Tree
  *****************************************************************/
-template <typename T>
+template <typename T,
+          typename Balance   = RedBlack,
+          typename Compare   = std::less<T>,
+          typename Allocator = std::allocator<T>,
+          typename Augment   = NoAugment >
 class BST
 {
    friend class ::TestBST; // give unit tests access to the privates
    friend class ::TestMap;
    friend class ::TestSet;
+   friend class ::TestInterval;
 
-   template <class KK, class VV>
+   template <class KK, class VV, class CC, class AA, class BB>
    friend class map;
 
-   template <class TT>
+   template <class TT, class CC, class AA, class BB>
    friend class set;
 
-   template <class KK, class VV>
-   friend void swap(map<KK, VV>& lhs, map<KK, VV>& rhs);
+   template <class PP, class BB, class AA>
+   friend class IntervalTree;
+
+   friend Balance;            // the policy rotates and rebuilds our nodes
 private:
 
    class BNode;
    BNode * root;              // root node of the binary search tree
+   BNode * leftmost;          // the smallest element, nullptr when empty
+   BNode * rightmost;         // the largest element, nullptr when empty
    size_t numElements;        // number of elements currently in the tree
+   typename Balance::State balanceState; // whatever the policy tracks per tree
+   Compare compare;           // the ordering of the elements
+   NodePool<BNode, Allocator> pool; // where every node of this tree lives
+   double depthFactor;        // see auto_rebalance(); 0 when off
+   size_t rebalancedSize;     // the size when keepShallow() last rebalanced it all
 
-   void deleteBinaryTree(BNode*& p);
+   size_t deleteBinaryTree(BNode*& p);
    BNode* copyBinaryTree(const BNode* pSrc);
    void assignBinaryTree(BNode*& pDest, const BNode* pSrc);
+   BNode* copyNode(BNode*& pDest, BNode* pParent, const BNode* pSrc);
+   void copyData(BNode*& pDest, const BNode* pSrc, std::true_type);
+   void copyData(BNode*& pDest, const BNode* pSrc, std::false_type);
+   void findExtremes();
+   void swapTree(BST & rhs);
+   void takeNodes(BST & rhs);
+
+   // restructuring used by the balancing policies
+   void rotateLeft (BNode* pNode);
+   void rotateRight(BNode* pNode);
+   void rebuild    (BNode* pSubtree);
+   void hang       (BNode* pNode, BNode* pLeft, BNode* pRight, BNode* pParent, bool goLeft);
+
+   // keeping the shape in check
+   template <class Visit> void walk(const BNode* pTop, Visit visit) const;
+   size_t sizeOfSubtree(const BNode* pTop) const;
+   size_t markBuilt(BNode* pNode, size_t depth, size_t fullLevels);
+   static size_t fullLevelsOf(size_t num);
+   void keepShallow(BNode* pNew);
+
+   // take a node out of the tree without destroying it; the next one comes back
+   BNode* unlink(BNode* pDelete);
+
+   // splitting and joining: the rank is how tall the policy thinks a tree is
+   template <class K> BST splitAt(const K& key);
+   size_t rankOfSubtree(const BNode* pTop) const;
+   void recount(BST& rhs, size_t total, std::true_type);
+   void recount(BST& rhs, size_t total, std::false_type);
+
+   // a subtree cut loose from any tree, with its rank. The policy
+   // joins pieces inside a scratch tree, which only lends its root.
+   struct Piece { BNode* pRoot; size_t rank; };
+   static Piece takePiece(Piece& piece)
+   {
+      Piece taken = piece;
+      piece = Piece{ nullptr, 0 };
+      return taken;
+   }
+   template <class Side>
+   BNode* splitPiece(BST& scratch, BNode* pTop, Side side, Piece& left, Piece& right) const;
+   Piece joinPieces(BST& scratch, const Piece& left, BNode* pMiddle, const Piece& right) const;
+   Piece joinPieces(BST& scratch, const Piece& left, const Piece& right) const;
+
+   // set algebra on pieces. Nodes that drop out wait on a list until
+   // the end, so that halves running in parallel never touch the pool.
+   // If the comparator throws, every node still in hand goes there too.
+   struct Discard
+   {
+      BNode* pHead = nullptr;  // subtrees, chained through their pParent
+      BNode* pTail = nullptr;
+      void push(BNode* pNode)
+      {
+         pNode->pParent = nullptr;
+         if (pTail)
+            pTail->pParent = pNode;
+         else
+            pHead = pNode;
+         pTail = pNode;
+      }
+      void pushAll(std::initializer_list<BNode*> nodes)
+      {
+         for (BNode* pNode : nodes)
+            if (pNode)
+               push(pNode);
+      }
+      void append(const Discard& rhs)
+      {
+         if (!rhs.pHead)
+            return;
+         if (pTail)
+            pTail->pParent = rhs.pHead;
+         else
+            pHead = rhs.pHead;
+         pTail = rhs.pTail;
+      }
+   };
+   template <class Fork>
+   Piece unitePieces    (BST& scratch, Piece piece, BNode* pOther, size_t rankOther, Discard& discard, int forks) const;
+   template <class Fork>
+   Piece intersectPieces(BST& scratch, Piece piece, const BNode* pOther, Discard& discard, int forks) const;
+   template <class Fork>
+   Piece subtractPieces (BST& scratch, Piece piece, const BNode* pOther, Discard& discard, int forks) const;
+   template <class Fork, class Half>
+   void bothHalves(Half half, Piece& left, Piece& right, BST& scratch, Discard& discard, int forks) const;
+   size_t destroyDiscarded(Discard& discard);
+   void adopt(const Piece& piece, size_t num);
+
+   // the balanced subtree of the next num sorted elements
+   template <class ForwardIt>
+   BNode* buildSorted(ForwardIt& it, size_t num, size_t depth, size_t fullLevels, size_t& height);
+
+   // Compare is either a less-than predicate returning bool, or a
+   // three-way comparison whose result is ordered against 0, such as
+   // an int like strcmp() or a std::strong_ordering from operator<=>
+   using CompareResult = decltype(std::declval<const Compare &>()(std::declval<const T &>(),
+                                                                  std::declval<const T &>()));
+   using IsThreeWay = std::integral_constant<bool,
+      !std::is_same<typename std::decay<CompareResult>::type, bool>::value>;
+
+   // a transparent key as the comparator sees it: a string literal
+   // is a const char *, not an array
+   template <class K>
+   using Key = typename std::decay<const K>::type;
+
+   // is a before b? One call to the comparator, whatever its kind
+   template <class A, class B>
+   bool lessThan(const A& a, const B& b) const { return isLess(compare(a, b), IsThreeWay()); }
+   static bool isLess(bool less, std::false_type) { return less; }
+   template <class R>
+   static bool isLess(const R& order, std::true_type) { return order < 0; }
+
+   // -1, 0 or 1 as a is before, equivalent to or after b
+   template <class A, class B>
+   int orderOf(const A& a, const B& b) const { return orderOf(a, b, IsThreeWay()); }
+   template <class A, class B>
+   int orderOf(const A& a, const B& b, std::false_type) const
+   {
+      return lessThan(a, b) ? -1 : (lessThan(b, a) ? 1 : 0);
+   }
+   template <class A, class B>
+   int orderOf(const A& a, const B& b, std::true_type) const
+   {
+      auto order = compare(a, b);
+      return order < 0 ? -1 : (0 < order ? 1 : 0);
+   }
+
+   // searching, one comparison per node
+   template <class K> BNode* findNode(const K& k, std::false_type) const;
+   template <class K> BNode* findNode(const K& k, std::true_type) const;
+   template <class K> BNode* accessNode(const K& k);
+   template <class K> BNode* accessNode(const K& k, BNode*& pTouched, std::false_type) const;
+   template <class K> BNode* accessNode(const K& k, BNode*& pTouched, std::true_type) const;
+   template <class K> BNode* lowerBoundNode(const K& k, BNode* p, BNode* pCandidate) const;
+   template <class K> BNode* upperBoundNode(const K& k, BNode* p, BNode* pCandidate) const;
+   template <class K> std::pair<BNode*, BNode*> equalRangeNodes(const K& k) const;
+   template <class K> size_t countNodes(const K& k) const;
+   template <class K> size_t rankOf(const K& k) const;
+   BNode* selectNode(size_t k) const;
+   template <class K, class A = Augment>
+   typename A::result_type aggregateOf(const K& lo, const K& hi) const;
+   template <class K>
+   BNode* locate(const K& k, bool keepUnique, BNode*& pParent, bool& goLeft, std::false_type) const;
+   template <class K>
+   BNode* locate(const K& k, bool keepUnique, BNode*& pParent, bool& goLeft, std::true_type) const;
+   BNode* attach(BNode* pNew, BNode* pParent, bool goLeft);
+
+   // build the new element from args only if nothing equal to key is there
+   struct InPlace { };
+   template <class K, class ... Args>
+   std::pair<BNode*, bool> emplaceUnique(const K& key, Args&& ... args);
+
+   // build the new element from args first, then find it a place:
+   // right before pHint if it belongs there, else by a search from the root
+   template <class ... Args>
+   std::pair<BNode*, bool> emplaceNode(bool keepUnique, bool hinted, BNode* pHint, Args&& ... args);
+   template <class K>
+   BNode* locateNear(BNode* pHint, const K& k, bool keepUnique, BNode*& pParent, bool& goLeft) const;
+   template <class U>
+   std::pair<BNode*, bool> insertNear(BNode* pHint, U&& t, bool keepUnique);
 public:
+   //
+   // Types
+   //
+
+   using value_type     = T;
+   using key_compare    = Compare;
+   using allocator_type = Allocator;
+
    //
    // Construct
    //
 
    BST();
+   explicit BST(const Allocator & alloc);
+   explicit BST(const Compare & comp, const Allocator & alloc = Allocator());
    BST(const BST &  rhs);
-   BST(BST&& rhs) : BST() { *this = std::move(rhs); }
+   BST(BST&& rhs) : BST(rhs.compare, rhs.get_allocator()) { *this = std::move(rhs); }
    BST(const std::initializer_list<T>& il) : BST() { *this = il; }
    ~BST();
 
@@ -91,19 +313,100 @@ public:
    BST & operator = (const std::initializer_list<T>& il);
    void swap(BST & rhs);
 
+   // a balanced tree in O(n) from elements that are already in order
+   template <class ForwardIt>
+   void assign_sorted(ForwardIt first, ForwardIt last);
+   template <class ForwardIt>
+   static BST from_sorted(ForwardIt first, ForwardIt last,
+                          const Compare & comp = Compare(), const Allocator & alloc = Allocator());
+
    //
    // Iterator
    //
 
    class iterator;
-   iterator   begin() const noexcept;
-   iterator   end()   const noexcept { return iterator(nullptr); }
+   using reverse_iterator = std::reverse_iterator<iterator>;
+   iterator   begin() const noexcept { return iterator(leftmost, this); }
+   iterator   end()   const noexcept { return iterator(nullptr, this);  }
+   reverse_iterator rbegin() const noexcept { return reverse_iterator(end());   }
+   reverse_iterator rend()   const noexcept { return reverse_iterator(begin()); }
 
    //
    // Access
    //
 
-   iterator find(const T& t);
+   // the smallest and largest elements, which had better be there
+   const T& front() const { assert(leftmost);  return leftmost->data;  }
+   const T& back()  const { assert(rightmost); return rightmost->data; }
+
+   iterator find(const T& t) const { return iterator(findNode(t, IsThreeWay()), this); }
+   size_t   count(const T& t) const { return countNodes(t); }
+   bool     contains(const T& t) const { return findNode(t, IsThreeWay()) != nullptr; }
+   iterator lower_bound(const T& t) const { return iterator(lowerBoundNode(t, root, nullptr), this); }
+   iterator upper_bound(const T& t) const { return iterator(upperBoundNode(t, root, nullptr), this); }
+   std::pair<iterator, iterator> equal_range(const T& t) const { return iterators(equalRangeNodes(t)); }
+
+   // the same for any key the comparator can hold up against a T,
+   // as long as the comparator says so with is_transparent
+   template <class K, class C = Compare, class = typename C::is_transparent>
+   iterator find(const K& k) const { return iterator(findNode<Key<K>>(k, IsThreeWay()), this); }
+   template <class K, class C = Compare, class = typename C::is_transparent>
+   size_t   count(const K& k) const { return countNodes<Key<K>>(k); }
+   template <class K, class C = Compare, class = typename C::is_transparent>
+   bool     contains(const K& k) const { return findNode<Key<K>>(k, IsThreeWay()) != nullptr; }
+   template <class K, class C = Compare, class = typename C::is_transparent>
+   iterator lower_bound(const K& k) const { return iterator(lowerBoundNode<Key<K>>(k, root, nullptr), this); }
+   template <class K, class C = Compare, class = typename C::is_transparent>
+   iterator upper_bound(const K& k) const { return iterator(upperBoundNode<Key<K>>(k, root, nullptr), this); }
+   template <class K, class C = Compare, class = typename C::is_transparent>
+   std::pair<iterator, iterator> equal_range(const K& k) const { return iterators(equalRangeNodes<Key<K>>(k)); }
+
+   // find(), then tell the policy what was looked up. A Splay tree
+   // rotates it up to the root, or on a miss the last node the search
+   // touched; the other policies keep their shape. With repeats, this
+   // finds one of them, not always the first. Not const, since the
+   // shape may change.
+   iterator find_and_splay(const T& t) { return iterator(accessNode(t), this); }
+   template <class K, class C = Compare, class = typename C::is_transparent>
+   iterator find_and_splay(const K& k) { return iterator(accessNode<Key<K>>(k), this); }
+
+   //
+   // Order statistics: O(log n) with an Augment that counts,
+   // such as OrderStatistic. Positions count from 0.
+   //
+
+   size_t   rank(const T& t) const { return rankOf(t); }   // how many come before t
+   const T& select(size_t k) const;                       // the element at position k
+   iterator nth(size_t k) const { return iterator(selectNode(k), this); }
+   size_t   count_range(const T& lo, const T& hi) const   // how many are in [lo, hi)
+   {
+      return lessThan(lo, hi) ? rankOf(hi) - rankOf(lo) : 0;
+   }
+   template <class K, class C = Compare, class = typename C::is_transparent>
+   size_t   rank(const K& k) const { return rankOf<Key<K>>(k); }
+   template <class K, class C = Compare, class = typename C::is_transparent>
+   size_t   count_range(const K& lo, const K& hi) const
+   {
+      return lessThan<Key<K>, Key<K>>(lo, hi) ? rankOf<Key<K>>(hi) - rankOf<Key<K>>(lo) : 0;
+   }
+
+   //
+   // Aggregates: O(log n) with an Augment that combines,
+   // such as Aggregate<Sum<long>>
+   //
+
+   template <class A = Augment>
+   typename A::result_type aggregate() const { return A::valueOf(root); }    // of everything
+   template <class A = Augment>
+   typename A::result_type aggregate(const T& lo, const T& hi) const         // of [lo, hi)
+   {
+      return aggregateOf<T, A>(lo, hi);
+   }
+   template <class K, class C = Compare, class = typename C::is_transparent, class A = Augment>
+   typename A::result_type aggregate(const K& lo, const K& hi) const
+   {
+      return aggregateOf<Key<K>, A>(lo, hi);
+   }
 
    // 
    // Insert
@@ -112,12 +415,98 @@ public:
    std::pair<iterator, bool> insert(const T&  t, bool keepUnique = false);
    std::pair<iterator, bool> insert(      T&& t, bool keepUnique = false);
 
+   // t goes right before hint if it belongs there, which costs two
+   // comparisons instead of a search. end() and begin() make an
+   // in-order stream of appends or prepends linear overall.
+   iterator insert(iterator hint, const T&  t, bool keepUnique = false)
+   {
+      return iterator(insertNear(hint.pNode, t, keepUnique).first, this);
+   }
+   iterator insert(iterator hint,       T&& t, bool keepUnique = false)
+   {
+      return iterator(insertNear(hint.pNode, std::move(t), keepUnique).first, this);
+   }
+
+   // the element is built right in its node, so it is never copied or moved
+   template <class ... Args>
+   std::pair<iterator, bool> emplace(Args&& ... args)
+   {
+      std::pair<BNode*, bool> result = emplaceNode(false, false, nullptr, std::forward<Args>(args)...);
+      return std::make_pair(iterator(result.first, this), result.second);
+   }
+   template <class ... Args>
+   iterator emplace_hint(iterator hint, Args&& ... args)
+   {
+      return iterator(emplaceNode(false, true, hint.pNode, std::forward<Args>(args)...).first, this);
+   }
+
    //
    // Remove
    // 
 
    iterator erase(iterator& it);
    void   clear() noexcept;
+   void   pop_front();
+   void   pop_back();
+
+   //
+   // Node handles: an element leaves one tree and goes into another,
+   // or back into the same one with a new key, without its node
+   // being freed or made again
+   //
+
+   class node_type;
+   struct insert_return_type;
+   node_type extract(iterator it);
+   node_type extract(const T& t) { return extract(find(t)); }
+   template <class K, class C = Compare, class = typename C::is_transparent>
+   node_type extract(const K& k) { return extract(find(k)); }
+   insert_return_type insert(node_type&& node, bool keepUnique = false);
+   iterator insert(iterator hint, node_type&& node, bool keepUnique = false);
+
+   // every node of rhs comes here, except, with keepUnique, the ones
+   // equal to something already here, which stay behind in rhs
+   void merge(BST& rhs, bool keepUnique = false);
+
+   //
+   // Split and join: O(log n) with RedBlack, AVL and Treap. Nodes
+   // change trees; no element is copied, moved or allocated. The
+   // nodes that change trees keep their addresses, but iterators
+   // to them must be found again in their new tree. A split finds
+   // the new sizes at the roots with an Augment that counts, such
+   // as OrderStatistic. Without one, as by default, it counts the
+   // smaller side, so splitting m from n elements is O(min(m, n)).
+   //
+
+   // everything from key on moves to the tree that comes back
+   BST  split(const T& key) { return splitAt(key); }
+   template <class K, class C = Compare, class = typename C::is_transparent>
+   BST  split(const K& key) { return splitAt<Key<K>>(key); }
+
+   // everything in rhs, which must all come after everything here,
+   // moves here. rhs is left empty.
+   void join(BST& rhs);
+
+   //
+   // Set algebra: O(m log(n/m + 1)) comparisons and joins for trees
+   // of m and n elements, m <= n, which is far less than walking
+   // both when one is much smaller. Meant for trees without repeats.
+   // These work in place; set_union(), set_intersection() and
+   // set_difference() below leave both trees alone. Given Parallel
+   // from parallel.h, large trees are worked on by several threads,
+   // which share the comparator. Recursion goes as deep as rhs is tall.
+   //
+
+   // everything in rhs moves here, except what is already here,
+   // which is destroyed. rhs is left empty.
+   template <class Fork = Serial>
+   void unite(BST& rhs, Fork = Fork());
+   // keep only what rhs has too
+   template <class Fork = Serial>
+   void intersect(const BST& rhs, Fork = Fork());
+   // keep only what rhs does not have
+   template <class Fork = Serial>
+   void subtract(const BST& rhs, Fork = Fork());
 
    void deleteNode(BNode*& pDelete, bool toRight);
 
@@ -125,11 +514,36 @@ public:
    // Status
    //
 
+   // the number of levels. Nothing keeps it up to date, so it is O(n).
+   size_t height() const;
+
+   // relink every node into a balanced shape, full but for its last
+   // level: Day-Stout-Warren, in O(n) time. No node is allocated and
+   // no element is copied or moved. For a tree left unbalanced, such
+   // as an Unbalanced one after a sorted burst of inserts.
+   void rebalance();
+
+   // from now on, an insert that lands deeper than factor * log2(size())
+   // rebuilds the smallest part of the tree around it that is too deep
+   // for its size, the way a scapegoat tree does, so the cost is spread
+   // out over the inserts. A policy with data in every node, such as
+   // RedBlack, AVL or Treap, has the whole tree rebalanced instead, at
+   // most once each time the tree doubles. Something above 1, such as
+   // 2; 0 turns it off. It stays with the tree whatever joins it, and
+   // a tree split off starts with it too.
+   void auto_rebalance(double factor) { depthFactor = factor; }
+
    bool empty() const noexcept { return numElements == 0; } //Checking if the tree is empty now
    size_t size() const noexcept { return numElements; } //Returning the number of elements now
-   
-
+   Compare key_comp() const { return compare; }
+   Allocator get_allocator() const { return pool.get_allocator(); }
 
+private:
+   // both ends of a range of nodes, as iterators into this tree
+   std::pair<iterator, iterator> iterators(const std::pair<BNode*, BNode*>& range) const
+   {
+      return std::make_pair(iterator(range.first, this), iterator(range.second, this));
+   }
 
 };
 
@@ -138,27 +552,35 @@ public:
  * BINARY NODE
  * A single node in a binary tree. Note that the node does not know
  * anything about the properties of the tree so no validation can be done.
+ * The balancing metadata (the red-black color, AVL height, ...) comes
+ * from the policy's Meta.
  *****************************************************************/
-template <typename T>
-class BST <T> :: BNode
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+class BST <T, Balance, Compare, Allocator, Augment> :: BNode : public Balance::Meta,
+                                                         public Augment::template Meta<T>
 {
 public:
    // 
    // Construct
    //
-   BNode() : data(T()), pLeft(nullptr), pRight(nullptr), pParent(nullptr), isRed(true) {}
-   BNode(const T &  t) : data(t), pLeft(nullptr), pRight(nullptr), pParent(nullptr), isRed(true) {}
-   BNode(T&& t) : data(std::move(t)), pLeft(nullptr), pRight(nullptr), pParent(nullptr), isRed(true) {}  //Corrected Constructors
+   BNode() : data(T()), pLeft(nullptr), pRight(nullptr), pParent(nullptr) {}
+   BNode(const T &  t) : data(t), pLeft(nullptr), pRight(nullptr), pParent(nullptr) {}
+   BNode(T&& t) : data(std::move(t)), pLeft(nullptr), pRight(nullptr), pParent(nullptr) {}  //Corrected Constructors
+   template <class ... Args>
+   BNode(InPlace, Args&& ... args) : data(std::forward<Args>(args)...), pLeft(nullptr), pRight(nullptr), pParent(nullptr) {}
 
    //
    // Insert
    //
    void addLeft (BNode * pNode);
    void addRight(BNode * pNode);
-   void addLeft (const T &  t);
-   void addRight(const T &  t);
-   void addLeft(       T && t);
-   void addRight(      T && t);
+   void addLeft (NodePool<BNode, Allocator> & pool, const T &  t);
+   void addRight(NodePool<BNode, Allocator> & pool, const T &  t);
+   void addLeft (NodePool<BNode, Allocator> & pool,       T && t);
+   void addRight(NodePool<BNode, Allocator> & pool,       T && t);
+
+   // back to a lone leaf, ready to go into a tree again
+   void reset();
 
    // 
    // Status
@@ -172,37 +594,46 @@ public:
    T data;                  // Actual data stored in the BNode
    BNode* pLeft;          // Left child - smaller
    BNode* pRight;         // Right child - larger
-   BNode* pParent;        // Parent
-   bool isRed;              // Red-black balancing stuff
+   typename Balance::template Parent<BNode> pParent; // Parent, a BNode * or one with a tag
 };
 
 /**********************************************************
  * BINARY SEARCH TREE ITERATOR
  * Forward and reverse iterator through a BST
  *********************************************************/
-template <typename T>
-class BST <T> :: iterator
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+class BST <T, Balance, Compare, Allocator, Augment> :: iterator
 {
    friend class ::TestBST; // give unit tests access to the privates
    friend class ::TestMap;
    friend class ::TestSet;
 
-   template <class KK, class VV>
+   template <class KK, class VV, class CC, class AA, class BB>
    friend class map;
 
-   template <class TT>
-   friend class set; 
+   template <class TT, class CC, class AA, class BB>
+   friend class set;
+
+   friend class BST;
 public:
+   // what std algorithms look at to pick their strategy
+   using iterator_category = std::bidirectional_iterator_tag;
+   using value_type        = T;
+   using difference_type   = std::ptrdiff_t;
+   using pointer           = const T *;
+   using reference         = const T &;
+
    // constructors and assignment
-   iterator(BNode * p = nullptr) : pNode(p)
+   explicit iterator(BNode * p = nullptr, const BST * pTree = nullptr) : pNode(p), pTree(pTree)
    { 
    }
-   iterator(const iterator & rhs) : pNode(rhs.pNode)
+   iterator(const iterator & rhs) : pNode(rhs.pNode), pTree(rhs.pTree)
    { 
    }
    iterator & operator = (const iterator & rhs)
    {
        pNode = rhs.pNode;
+       pTree = rhs.pTree;
        return *this;
    }
 
@@ -221,26 +652,106 @@ public:
    {
        return pNode->data;
    }
+   const T * operator -> () const
+   {
+       return &pNode->data;
+   }
 
    // increment and decrement
    iterator & operator ++ ();
-   iterator   operator ++ (int postfix)
+   iterator   operator ++ (int)
    {
-      return *this;
+      iterator itOld(*this);
+      ++*this;
+      return itOld;
    }
    iterator & operator -- ();
-   iterator   operator -- (int postfix)
+   iterator   operator -- (int)
    {
-      return *this;;
+      iterator itOld(*this);
+      --*this;
+      return itOld;
    }
 
    // must give friend status to remove so it can call getNode() from it
-   friend BST <T> :: iterator BST <T> :: erase(iterator & it);
+   friend BST <T, Balance, Compare, Allocator, Augment> :: iterator BST <T, Balance, Compare, Allocator, Augment> :: erase(iterator & it);
 
 private:
    
     // the node
     BNode * pNode;
+
+    // the tree, so end() can step back to the last element
+    const BST * pTree;
+};
+
+/**********************************************************
+ * BINARY SEARCH TREE NODE HANDLE
+ * Owns a node taken out of a tree. The element can be changed,
+ * key and all, and the node put back into any tree with an equal
+ * allocator. The node stays where it was, and the handle holds a
+ * lease on its chunk, so it may outlive the tree it came from or a
+ * clear() of it. Letting go of a full handle destroys the element.
+ *********************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+class BST <T, Balance, Compare, Allocator, Augment> :: node_type
+{
+   friend class ::TestBST; // give unit tests access to the privates
+   friend class BST;
+public:
+   using value_type     = T;
+   using allocator_type = Allocator;
+
+   node_type() noexcept : pNode(nullptr) { }
+   node_type(node_type && rhs) noexcept : pNode(rhs.pNode), lease(std::move(rhs.lease))
+   {
+      rhs.pNode = nullptr;
+   }
+   node_type & operator = (node_type && rhs) noexcept
+   {
+      node_type(std::move(rhs)).swap(*this);
+      return *this;
+   }
+   node_type(const node_type &) = delete;
+   node_type & operator = (const node_type &) = delete;
+   ~node_type()
+   {
+      if (pNode)
+         lease.destroy(pNode);
+   }
+
+   bool empty() const noexcept { return pNode == nullptr; }
+   explicit operator bool() const noexcept { return pNode != nullptr; }
+   allocator_type get_allocator() const { assert(pNode); return lease.get_allocator(); }
+
+   // the element, which unlike in a tree may change however it likes
+   T & value() const { assert(pNode); return pNode->data; }
+
+   void swap(node_type & rhs) noexcept
+   {
+      std::swap(pNode, rhs.pNode);
+      lease.swap(rhs.lease);
+   }
+
+private:
+   using Lease = typename NodePool<BNode, Allocator>::Lease;
+   node_type(BNode * pNode, Lease && lease) noexcept : pNode(pNode), lease(std::move(lease)) { }
+
+   BNode * pNode;   // nullptr when empty
+   Lease   lease;   // keeps the chunk pNode is in alive
+};
+
+/**********************************************************
+ * BINARY SEARCH TREE INSERT RETURN TYPE
+ * Where a node handle went. If it did not go in, the node
+ * comes back in node, and position is the one in the way.
+ *********************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+struct BST <T, Balance, Compare, Allocator, Augment> :: insert_return_type
+{
+   iterator  position;
+   bool      inserted;
+   node_type node;
 };
 
 
@@ -256,19 +767,43 @@ private:
  /*********************************************
   * BST :: DEFAULT CONSTRUCTOR
   ********************************************/
-template <typename T>
-BST <T> ::BST() : numElements(0), root(nullptr)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+BST <T, Balance, Compare, Allocator, Augment> ::BST() : root(nullptr), leftmost(nullptr), rightmost(nullptr), numElements(0), balanceState(),
+   depthFactor(0.0), rebalancedSize(0)
 {
    //numElements = 99;
    //root = new BNode;
 }
 
+/*********************************************
+ * BST :: ALLOCATOR CONSTRUCTOR
+ * An empty tree whose nodes come from alloc
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+BST <T, Balance, Compare, Allocator, Augment> ::BST(const Allocator & alloc) :
+   root(nullptr), leftmost(nullptr), rightmost(nullptr), numElements(0), balanceState(), pool(alloc), depthFactor(0.0), rebalancedSize(0)
+{
+}
+
+/*********************************************
+ * BST :: COMPARATOR CONSTRUCTOR
+ * An empty tree ordered by comp
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+BST <T, Balance, Compare, Allocator, Augment> ::BST(const Compare & comp, const Allocator & alloc) :
+   root(nullptr), leftmost(nullptr), rightmost(nullptr), numElements(0), balanceState(), compare(comp), pool(alloc), depthFactor(0.0), rebalancedSize(0)
+{
+}
+
 /*********************************************
  * BST :: COPY CONSTRUCTOR
  * Copy one tree to another
  ********************************************/
-template <typename T>
-BST<T>::BST(const BST<T>& rhs) : numElements(0), root(nullptr)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+BST<T, Balance, Compare, Allocator, Augment>::BST(const BST<T, Balance, Compare, Allocator, Augment>& rhs) :
+   root(nullptr), leftmost(nullptr), rightmost(nullptr), numElements(0), balanceState(), compare(rhs.compare),
+   pool(std::allocator_traits<Allocator>::select_on_container_copy_construction(rhs.get_allocator())),
+   depthFactor(0.0), rebalancedSize(0)
 {
     *this = rhs;
 }
@@ -278,7 +813,7 @@ BST<T>::BST(const BST<T>& rhs) : numElements(0), root(nullptr)
  * Move one tree to another
  ********************************************/
 //template <typename T>
-//BST <T> :: BST(BST <T> && rhs) : numElements(rhs.numElements), root(rhs.root)
+//BST <T, Balance, Compare, Allocator, Augment> :: BST(BST <T, Balance, Compare, Allocator, Augment> && rhs) : numElements(rhs.numElements), root(rhs.root)
 //{
 //    rhs.root = nullptr;
 //    rhs.numElements = 0;
@@ -289,7 +824,7 @@ BST<T>::BST(const BST<T>& rhs) : numElements(0), root(nullptr)
  * Create a BST from an initializer list
  ********************************************/
 //template <typename T>
-//BST <T> ::BST(const std::initializer_list<T>& il) : numElements(0), root(nullptr)
+//BST <T, Balance, Compare, Allocator, Augment> ::BST(const std::initializer_list<T>& il) : numElements(0), root(nullptr)
 //{
 //    *this = il;
 //}
@@ -297,62 +832,195 @@ BST<T>::BST(const BST<T>& rhs) : numElements(0), root(nullptr)
 /*********************************************
  * BST :: DESTRUCTOR
  ********************************************/
-template <typename T>
-BST <T> :: ~BST()
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+BST <T, Balance, Compare, Allocator, Augment> :: ~BST()
 {
     clear();
 }
 
-// deleteBinaryTree goes down each branch and deletes deleteing the leaf nodes on the way back up
-template <class T>
-void BST<T>::deleteBinaryTree(BST<T>::BNode*& node)
+/*********************************************
+ * BST :: DELETE BINARY TREE
+ * Destroy a subtree without recursion: walk down to a leaf, destroy
+ * it, unhook it from its parent and carry on from the parent. Every
+ * edge is walked once down and once up, so this is O(n) time and
+ * O(1) space however deep the tree is. Says how many there were.
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+size_t BST<T, Balance, Compare, Allocator, Augment>::deleteBinaryTree(BST<T, Balance, Compare, Allocator, Augment>::BNode*& node)
 {
-    if (!node)
-        return;
-
-    deleteBinaryTree(node->pLeft);
-    deleteBinaryTree(node->pRight);
-
-    delete node;
-	node = nullptr; // apperently deleting the node doesn't do this
+    size_t num = 0;
+    BNode* pTop = node;
+    BNode* p = pTop;
+    while (p)
+    {
+        if (p->pLeft)
+            p = p->pLeft;
+        else if (p->pRight)
+            p = p->pRight;
+        else
+        {
+            BNode* pParent = (p == pTop) ? nullptr : p->pParent;
+            if (pParent)
+                (pParent->pLeft == p ? pParent->pLeft : pParent->pRight) = nullptr;
+            pool.destroy(p);
+            num++;
+            p = pParent;
+        }
+    }
+    node = nullptr;
+    return num;
 }
 
-// copyBinaryTree goes down each branch and copies the nodes on the way back up
-template <class T>
-void BST<T>::assignBinaryTree(BST<T>::BNode*& pDest, const BST<T>::BNode* pSrc)
-{   
-	// if the source is null, clear dest before returning
+/*********************************************
+ * BST :: ASSIGN BINARY TREE
+ * Make the subtree pDest a copy of pSrc, reusing the nodes that
+ * are already there. Both trees are walked together in preorder
+ * with their parent pointers, so there is no recursion and no stack.
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST<T, Balance, Compare, Allocator, Augment>::assignBinaryTree(BST<T, Balance, Compare, Allocator, Augment>::BNode*& pDest, const BST<T, Balance, Compare, Allocator, Augment>::BNode* pSrc)
+{
+    // if the source is null, clear dest before returning
     if (!pSrc)
     {
         deleteBinaryTree(pDest);
         return;
     }
 
+    copyNode(pDest, pDest ? pDest->pParent : nullptr, pSrc);
+    const BNode* s = pSrc;
+    BNode* d = pDest;
+    while (true)
+    {
+        // the left side first
+        if (s->pLeft)
+        {
+            d = copyNode(d->pLeft, d, s->pLeft);
+            s = s->pLeft;
+            continue;
+        }
+        deleteBinaryTree(d->pLeft);
+
+        // then the right side
+        if (s->pRight)
+        {
+            d = copyNode(d->pRight, d, s->pRight);
+            s = s->pRight;
+            continue;
+        }
+        deleteBinaryTree(d->pRight);
+
+        // both sides are done: climb until there is a right side left to do
+        while (true)
+        {
+            if (s == pSrc)
+                return;
+            const BNode* sParent = s->pParent;
+            BNode* dParent = d->pParent;
+            if (s == sParent->pLeft)
+            {
+                if (sParent->pRight)
+                {
+                    d = copyNode(dParent->pRight, dParent, sParent->pRight);
+                    s = sParent->pRight;
+                    break;
+                }
+                deleteBinaryTree(dParent->pRight);
+            }
+            s = sParent;
+            d = dParent;
+        }
+    }
+}
+
+/*********************************************
+ * BST :: COPY NODE
+ * Make pDest (creating it if need be) hold what pSrc holds,
+ * balancing metadata and all, under pParent
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: copyNode(
+    BNode *& pDest, BNode * pParent, const BNode * pSrc)
+{
     if (!pDest)
-        pDest = new BNode(pSrc->data);
+        pDest = pool.create(pSrc->data);
     else
-        pDest->data = pSrc->data;
-
-    assignBinaryTree(pDest->pLeft, pSrc->pLeft);
-    if (pDest->pLeft)
-        pDest->pLeft->pParent = pDest;
+        copyData(pDest, pSrc, std::is_copy_assignable<T>());
+    static_cast<typename Balance::Meta &>(*pDest) = static_cast<const typename Balance::Meta &>(*pSrc);
+    static_cast<typename Augment::template Meta<T> &>(*pDest) =
+        static_cast<const typename Augment::template Meta<T> &>(*pSrc);
+    copyTag(pDest->pParent, pSrc->pParent);
+    pDest->pParent = pParent;
+    return pDest;
+}
 
-    assignBinaryTree(pDest->pRight, pSrc->pRight);
-    if (pDest->pRight)
-        pDest->pRight->pParent = pDest;
+/*********************************************
+ * BST :: COPY DATA
+ * Reuse a node by assigning to its element. An element with a
+ * const part, like the key of a map, cannot be assigned to, so
+ * a fresh node takes the old one's place instead.
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: copyData(BNode *& pDest, const BNode * pSrc, std::true_type /* assignable */)
+{
+    pDest->data = pSrc->data;
 }
 
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: copyData(BNode *& pDest, const BNode * pSrc, std::false_type /* assignable */)
+{
+    BNode* pNew = pool.create(pSrc->data);
+    pNew->pLeft = pDest->pLeft;
+    pNew->pRight = pDest->pRight;
+    if (pNew->pLeft)
+        pNew->pLeft->pParent = pNew;
+    if (pNew->pRight)
+        pNew->pRight->pParent = pNew;
+    pool.destroy(pDest);
+    pDest = pNew;
+}
 
+/*********************************************
+ * BST :: FIND EXTREMES
+ * Look up the smallest and largest elements again after
+ * the whole tree was replaced
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: findExtremes()
+{
+    leftmost = rightmost = root;
+    while (leftmost && leftmost->pLeft)
+        leftmost = leftmost->pLeft;
+    while (rightmost && rightmost->pRight)
+        rightmost = rightmost->pRight;
+}
 
 /*********************************************
  * BST :: ASSIGNMENT OPERATOR
  * Copy one tree to another
  ********************************************/
-template <typename T>
-BST <T> & BST <T> :: operator = (const BST <T> & rhs)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+BST <T, Balance, Compare, Allocator, Augment> & BST <T, Balance, Compare, Allocator, Augment> :: operator = (const BST <T, Balance, Compare, Allocator, Augment> & rhs)
 {
-    assignBinaryTree(root, rhs.root);
+    if (this == &rhs)
+        return *this;
+
+    try
+    {
+        assignBinaryTree(root, rhs.root);
+    }
+    catch (...)
+    {
+        // we no longer know how many nodes made it over
+        clear();
+        throw;
+    }
     numElements = rhs.numElements;
+    balanceState = rhs.balanceState;
+    compare = rhs.compare;
+    depthFactor = rhs.depthFactor;
+    rebalancedSize = rhs.rebalancedSize;
+    findExtremes();
     return *this;
 }
 
@@ -360,8 +1028,8 @@ BST <T> & BST <T> :: operator = (const BST <T> & rhs)
  * BST :: ASSIGNMENT OPERATOR with INITIALIZATION LIST
  * Copy nodes onto a BTree
  ********************************************/
-template <typename T>
-BST <T> & BST <T> :: operator = (const std::initializer_list<T>& il)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+BST <T, Balance, Compare, Allocator, Augment> & BST <T, Balance, Compare, Allocator, Augment> :: operator = (const std::initializer_list<T>& il)
 {
     clear();
     for (auto&& it : il)
@@ -371,224 +1039,1557 @@ BST <T> & BST <T> :: operator = (const std::initializer_list<T>& il)
 
 /*********************************************
  * BST :: ASSIGN-MOVE OPERATOR
- * Move one tree to another
+ * Move one tree to another. The nodes come along as they are unless
+ * the allocators differ and ours does not propagate, as with two
+ * std::pmr resources: then the elements are moved one at a time.
  ********************************************/
-template <typename T>
-BST <T> & BST <T> :: operator = (BST <T> && rhs)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+BST <T, Balance, Compare, Allocator, Augment> & BST <T, Balance, Compare, Allocator, Augment> :: operator = (BST <T, Balance, Compare, Allocator, Augment> && rhs)
 {
+    if (this == &rhs)
+        return *this;
+
     clear();
-    swap(rhs);
+    if (pool.adopt(rhs.pool))
+    {
+        swapTree(rhs);
+        return *this;
+    }
+
+    compare = rhs.compare;
+    depthFactor = rhs.depthFactor;
+    for (iterator it = rhs.begin(); it != rhs.end(); ++it)
+        emplace_hint(end(), std::move(it.pNode->data));
+    rhs.clear();
     return *this;
 }
 
 
 /*********************************************
  * BST :: SWAP
- * Swap two trees
+ * Swap two trees. The allocators must be equal unless they
+ * propagate on swap.
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: swap (BST <T, Balance, Compare, Allocator, Augment>& rhs)
+{
+	swapTree(rhs);
+	pool.swap(rhs.pool);
+}
+
+/*********************************************
+ * BST :: SWAP TREE
+ * Swap everything but the pools
  ********************************************/
-template <typename T>
-void BST <T> :: swap (BST <T>& rhs)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: swapTree (BST <T, Balance, Compare, Allocator, Augment>& rhs)
 {
 	std::swap(root, rhs.root);
+	std::swap(leftmost, rhs.leftmost);
+	std::swap(rightmost, rhs.rightmost);
 	std::swap(numElements, rhs.numElements);
+	std::swap(balanceState, rhs.balanceState);
+	std::swap(compare, rhs.compare);
+	std::swap(depthFactor, rhs.depthFactor);
+	std::swap(rebalancedSize, rhs.rebalancedSize);
 }
 
-/*****************************************************
- * BST :: INSERT
- * Insert a node at a given location in the tree
- ****************************************************/
-template <typename T>
-std::pair<typename BST<T>::iterator, bool> BST<T>::insert(const T& t, bool keepUnique)
+/*********************************************
+ * BST :: TAKE NODES
+ * An empty tree takes every node of rhs, leaving it empty. The pools
+ * share, as for a join, so the comparator, the allocator and
+ * auto_rebalance() stay with the tree they were given to.
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: takeNodes (BST <T, Balance, Compare, Allocator, Augment>& rhs)
 {
-    if (!root)
+    assert(!root && this != &rhs);
+    pool.share(rhs.pool);
+    root = rhs.root;
+    leftmost = rhs.leftmost;
+    rightmost = rhs.rightmost;
+    numElements = rhs.numElements;
+    balanceState = rhs.balanceState;
+    rebalancedSize = 0;
+    rhs.root = rhs.leftmost = rhs.rightmost = nullptr;
+    rhs.numElements = 0;
+    rhs.balanceState = typename Balance::State();
+}
+
+/*********************************************
+ * BST :: ASSIGN SORTED
+ * Replace the contents with [first, last), which must already be
+ * in order. Every node comes from one block, in the same order as
+ * the input, and no element is compared.
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class ForwardIt>
+void BST <T, Balance, Compare, Allocator, Augment> :: assign_sorted(ForwardIt first, ForwardIt last)
+{
+    clear();
+    size_t num = (size_t)std::distance(first, last);
+    pool.reserve(num);
+
+    // the policies look at the size as the nodes go in
+    numElements = num;
+    try
     {
-        root = new BNode(t);
-        numElements = 1;
-        return std::make_pair(iterator(root), true);
+        size_t height = 0;
+        root = buildSorted(first, num, 0, fullLevelsOf(num), height);
     }
-
-    BNode* currentNode = root;
-    while (currentNode)
+    catch (...)
     {
-        if (keepUnique && t == currentNode->data)
-            return std::make_pair(iterator(currentNode), false);
-
-        if (t < currentNode->data)
-        {
-            if (currentNode->pLeft)
-                currentNode = currentNode->pLeft;
-            else
-            {
-                currentNode->pLeft = new BNode(t);
-                currentNode->pLeft->pParent = currentNode;
-                ++numElements;
-                return std::make_pair(iterator(currentNode->pLeft), true);
-            }
-        }
-        else
-        {
-            if (currentNode->pRight)
-                currentNode = currentNode->pRight;
-            else
-            {
-                currentNode->pRight = new BNode(t);
-                currentNode->pRight->pParent = currentNode;
-                ++numElements;
-                return std::make_pair(iterator(currentNode->pRight), true);
-            }
-        }
+        numElements = 0;
+        throw;
     }
+    findExtremes();
+}
 
-	return std::make_pair(end(), false); // Should not reach here but need for compiler
+/*********************************************
+ * BST :: FROM SORTED
+ * A new tree holding [first, last), which must already be in order
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class ForwardIt>
+BST <T, Balance, Compare, Allocator, Augment> BST <T, Balance, Compare, Allocator, Augment> :: from_sorted(
+    ForwardIt first, ForwardIt last, const Compare & comp, const Allocator & alloc)
+{
+    BST bst(comp, alloc);
+    bst.assign_sorted(first, last);
+    return bst;
 }
 
-template <typename T>
-std::pair<typename BST <T> ::iterator, bool> BST <T> ::insert(T && t, bool keepUnique)
+/*********************************************
+ * BST :: BUILD SORTED
+ * Build the left half, then the middle, then the right half, so the
+ * input is read once, front to back. Halving at every level keeps
+ * the tree full but for its last level. If an element fails to
+ * copy, the part that was built is destroyed.
+ ********************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class ForwardIt>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: buildSorted(
+    ForwardIt & it, size_t num, size_t depth, size_t fullLevels, size_t & height)
 {
-    if (!root)
-    {
-        root = new BNode(std::move(t));
-        numElements = 1;
-        return std::make_pair(iterator(root), true);
-    }
+    height = 0;
+    if (num == 0)
+        return nullptr;
 
-    BNode* currentNode = root;
-    BNode* parentNode = nullptr;
+    size_t numLeft = num / 2;
+    size_t heightLeft = 0;
+    size_t heightRight = 0;
 
-    while (currentNode)
+    BNode* pLeft = buildSorted(it, numLeft, depth + 1, fullLevels, heightLeft);
+    BNode* pNode = nullptr;
+    try
+    {
+        pNode = pool.create(*it);
+    }
+    catch (...)
     {
-        parentNode = currentNode;
-        if (keepUnique && t == currentNode->data)
-            return std::make_pair(iterator(currentNode), false);
+        deleteBinaryTree(pLeft);
+        throw;
+    }
+    ++it;
+    pNode->pLeft = pLeft;
+    if (pLeft)
+        pLeft->pParent = pNode;
 
-        if (t < currentNode->data)
-            currentNode = currentNode->pLeft;
-        else
-            currentNode = currentNode->pRight;
+    try
+    {
+        pNode->pRight = buildSorted(it, num - numLeft - 1, depth + 1, fullLevels, heightRight);
+    }
+    catch (...)
+    {
+        deleteBinaryTree(pNode);
+        throw;
     }
+    if (pNode->pRight)
+        pNode->pRight->pParent = pNode;
 
-    BNode* newNode = new BNode(std::move(t));
-    newNode->pParent = parentNode;
+    height = 1 + (heightLeft > heightRight ? heightLeft : heightRight);
+    Augment::update(pNode);
+    Balance::built(*this, pNode, depth, height, fullLevels);
+    return pNode;
+}
 
-    if (newNode->data < parentNode->data)
-        parentNode->pLeft = newNode;
-    else
-        parentNode->pRight = newNode;
+/*****************************************************
+ * BST :: INSERT
+ * Insert a node at a given location in the tree
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+std::pair<typename BST<T, Balance, Compare, Allocator, Augment>::iterator, bool> BST<T, Balance, Compare, Allocator, Augment>::insert(const T& t, bool keepUnique)
+{
+    BNode* pParent = nullptr;
+    bool goLeft = false;
+    BNode* pSame = locate(t, keepUnique, pParent, goLeft, IsThreeWay());
+    if (pSame)
+        return std::make_pair(iterator(pSame, this), false);
 
-    ++numElements;
-    return std::make_pair(iterator(newNode), true);
+    return std::make_pair(iterator(attach(pool.create(t), pParent, goLeft), this), true);
 }
 
-/*************************************************
- * BST :: ERASE
- * Remove a given node as specified by the iterator
- ************************************************/
-template <typename T>
-typename BST<T>::iterator BST<T>::erase(iterator& it)
+/*****************************************************
+ * BST :: INSERT
+ * Insert a node at a given location in the tree,
+ * moving the value into the node
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+std::pair<typename BST <T, Balance, Compare, Allocator, Augment> ::iterator, bool> BST <T, Balance, Compare, Allocator, Augment> ::insert(T && t, bool keepUnique)
 {
-    // do nothing if there is nothing to do
-    if (it == end())
-        return end();
+    BNode* pParent = nullptr;
+    bool goLeft = false;
+    BNode* pSame = locate(t, keepUnique, pParent, goLeft, IsThreeWay());
+    if (pSame)
+        return std::make_pair(iterator(pSame, this), false);
 
-    // remember where we were
-    iterator itNext(it);
-    BNode* pDelete = it.pNode;
+    return std::make_pair(iterator(attach(pool.create(std::move(t)), pParent, goLeft), this), true);
+}
 
-    // if there is only one child (right) or no children (how sad!)
-    if (!pDelete->pLeft)
+/*****************************************************
+ * BST :: LOCATE
+ * Walk down to where t belongs, with one comparison per node. The
+ * new node would go under pParent, on the left if goLeft. With
+ * keepUnique, return the node already holding t, if any.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: locate(
+    const K & k, bool keepUnique, BNode *& pParent, bool & goLeft, std::false_type /* less than */) const
+{
+    // equal elements go to the right, so the last node we went right
+    // from is the only one that could be equal to k
+    BNode* pCandidate = nullptr;
+    for (BNode* p = root; p; p = goLeft ? p->pLeft : p->pRight)
     {
-        ++itNext;
-        deleteNode(pDelete, true /* go right */);
+        pParent = p;
+        goLeft = compare(k, p->data);
+        if (!goLeft)
+            pCandidate = p;
     }
 
-    // there is only one child (left)
-    else if (!pDelete->pRight)
+    if (keepUnique && pCandidate && !compare(pCandidate->data, k))
+        return pCandidate;
+    return nullptr;
+}
+
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: locate(
+    const K & k, bool keepUnique, BNode *& pParent, bool & goLeft, std::true_type /* three way */) const
+{
+    for (BNode* p = root; p; p = goLeft ? p->pLeft : p->pRight)
     {
-        ++itNext;
-        deleteNode(pDelete, false);
+        pParent = p;
+        auto order = compare(k, p->data);
+        if (keepUnique && order == 0)
+            return p;
+        goLeft = order < 0;
     }
+    return nullptr;
+}
 
-    // otherwise, swap places with the in-order successor
-    else
-    {
+/*****************************************************
+ * BST :: EMPLACE UNIQUE
+ * Look for key first, and only when it is missing build the
+ * new element in its node straight from args
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K, class ... Args>
+std::pair<typename BST <T, Balance, Compare, Allocator, Augment> :: BNode *, bool>
+BST <T, Balance, Compare, Allocator, Augment> :: emplaceUnique(const K & key, Args && ... args)
+{
+    BNode* pParent = nullptr;
+    bool goLeft = false;
+    BNode* pSame = locate(key, true /* keepUnique */, pParent, goLeft, IsThreeWay());
+    if (pSame)
+        return std::make_pair(pSame, false);
+
+    BNode* pNew = pool.create(InPlace(), std::forward<Args>(args)...);
+    return std::make_pair(attach(pNew, pParent, goLeft), true);
+}
+
+/*****************************************************
+ * BST :: EMPLACE NODE
+ * The key is in the element, so the element has to exist before
+ * we can tell where it goes. If it turns out to be a duplicate we
+ * do not want, it is thrown away again.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class ... Args>
+std::pair<typename BST <T, Balance, Compare, Allocator, Augment> :: BNode *, bool>
+BST <T, Balance, Compare, Allocator, Augment> :: emplaceNode(bool keepUnique, bool hinted, BNode * pHint, Args && ... args)
+{
+    BNode* pNew = pool.create(InPlace(), std::forward<Args>(args)...);
+
+    BNode* pParent = nullptr;
+    bool goLeft = false;
+    BNode* pSame;
+    try
+    {
+        pSame = hinted ? locateNear(pHint, pNew->data, keepUnique, pParent, goLeft)
+                       : locate(pNew->data, keepUnique, pParent, goLeft, IsThreeWay());
+    }
+    catch (...)
+    {
+        pool.destroy(pNew);
+        throw;
+    }
+
+    if (pSame)
+    {
+        pool.destroy(pNew);
+        return std::make_pair(pSame, false);
+    }
+    return std::make_pair(attach(pNew, pParent, goLeft), true);
+}
+
+/*****************************************************
+ * BST :: LOCATE NEAR
+ * Where k goes if it goes right before pHint (nullptr is end()).
+ * That is only so when k is between pHint and the one before it;
+ * then it is the left child of pHint, or if that is taken, the
+ * right child of the one before, in two comparisons. A unique k
+ * equal to either neighbor is found right there. Otherwise the
+ * hint was wrong and we search from the root.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: locateNear(
+    BNode * pHint, const K & k, bool keepUnique, BNode *& pParent, bool & goLeft) const
+{
+    // the extremes are cached, so the ends of the tree cost nothing
+    BNode* pNext = pHint;
+    BNode* pPrev = nullptr;
+    if (!pNext)
+        pPrev = rightmost;
+    else if (pNext != leftmost)
+        pPrev = (--iterator(pNext)).pNode;
+
+    // duplicates may sit next to their equals, unique ones are found there
+    bool fits = true;
+    if (pPrev && !lessThan(pPrev->data, k))
+    {
+        if (lessThan(k, pPrev->data))
+            fits = false;
+        else if (keepUnique)
+            return pPrev;
+    }
+    if (fits && pNext && !lessThan(k, pNext->data))
+    {
+        if (lessThan(pNext->data, k))
+            fits = false;
+        else if (keepUnique)
+            return pNext;
+    }
+    if (!fits)
+        return locate(k, keepUnique, pParent, goLeft, IsThreeWay());
+
+    if (pNext && !pNext->pLeft)
+    {
+        pParent = pNext;
+        goLeft = true;
+    }
+    else
+    {
+        pParent = pPrev;
+        goLeft = false;
+    }
+    return nullptr;
+}
+
+/*****************************************************
+ * BST :: INSERT NEAR
+ * Insert t right before pHint when it belongs there, and
+ * wherever it does belong otherwise
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class U>
+std::pair<typename BST <T, Balance, Compare, Allocator, Augment> :: BNode *, bool>
+BST <T, Balance, Compare, Allocator, Augment> :: insertNear(BNode * pHint, U && t, bool keepUnique)
+{
+    BNode* pParent = nullptr;
+    bool goLeft = false;
+    BNode* pSame = locateNear(pHint, t, keepUnique, pParent, goLeft);
+    if (pSame)
+        return std::make_pair(pSame, false);
+    return std::make_pair(attach(pool.create(std::forward<U>(t)), pParent, goLeft), true);
+}
+
+/*****************************************************
+ * BST :: ATTACH
+ * Hang a new node under pParent (or make it the root)
+ * and let the balancing policy know about it
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: attach(
+    BNode * pNew, BNode * pParent, bool goLeft)
+{
+    if (!pParent)
+        root = leftmost = rightmost = pNew;
+    else if (goLeft)
+    {
+        pParent->addLeft(pNew);
+        if (pParent == leftmost)
+            leftmost = pNew;
+    }
+    else
+    {
+        pParent->addRight(pNew);
+        if (pParent == rightmost)
+            rightmost = pNew;
+    }
+
+    ++numElements;
+    Augment::inserted(pNew);
+    Balance::inserted(*this, pNew);
+    if (depthFactor > 0.0)
+        keepShallow(pNew);
+    return pNew;
+}
+
+/*************************************************
+ * BST :: ERASE
+ * Remove a given node as specified by the iterator
+ ************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST<T, Balance, Compare, Allocator, Augment>::iterator BST<T, Balance, Compare, Allocator, Augment>::erase(iterator& it)
+{
+    // do nothing if there is nothing to do
+    if (it == end())
+        return end();
+
+    BNode* pDelete = it.pNode;
+    BNode* pNext = unlink(pDelete);
+    pool.destroy(pDelete);
+    return iterator(pNext, this);
+}
+
+/*************************************************
+ * BST :: EXTRACT
+ * Take the node out of the tree, and hand it over with a lease
+ * on the chunk it is in
+ ************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST <T, Balance, Compare, Allocator, Augment> :: node_type BST <T, Balance, Compare, Allocator, Augment> :: extract(iterator it)
+{
+    if (it == end())
+        return node_type();
+    typename node_type::Lease lease = pool.lend();
+    unlink(it.pNode);
+    return node_type(it.pNode, std::move(lease));
+}
+
+/*************************************************
+ * BST :: INSERT NODE
+ * Put the node of a handle where its element goes, unless keepUnique
+ * finds an equal one already there. We join the group of chunks
+ * the node is in, as join() does.
+ ************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST <T, Balance, Compare, Allocator, Augment> :: insert_return_type BST <T, Balance, Compare, Allocator, Augment> :: insert(
+    node_type&& node, bool keepUnique)
+{
+    if (node.empty())
+        return insert_return_type{ end(), false, node_type() };
+
+    BNode* pParent = nullptr;
+    bool goLeft = false;
+    BNode* pSame = locate(node.pNode->data, keepUnique, pParent, goLeft, IsThreeWay());
+    if (pSame)
+        return insert_return_type{ iterator(pSame, this), false, std::move(node) };
+
+    pool.take(node.lease);
+    BNode* pNode = node.pNode;
+    node.pNode = nullptr;
+    pNode->reset();
+    return insert_return_type{ iterator(attach(pNode, pParent, goLeft), this), true, node_type() };
+}
+
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST <T, Balance, Compare, Allocator, Augment> :: iterator BST <T, Balance, Compare, Allocator, Augment> :: insert(
+    iterator hint, node_type&& node, bool keepUnique)
+{
+    if (node.empty())
+        return end();
+
+    BNode* pParent = nullptr;
+    bool goLeft = false;
+    BNode* pSame = locateNear(hint.pNode, node.pNode->data, keepUnique, pParent, goLeft);
+    if (pSame)
+        return iterator(pSame, this);
+
+    pool.take(node.lease);
+    BNode* pNode = node.pNode;
+    node.pNode = nullptr;
+    pNode->reset();
+    return iterator(attach(pNode, pParent, goLeft), this);
+}
+
+/*************************************************
+ * BST :: MERGE
+ * Move the nodes of rhs over one at a time, in order
+ ************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: merge(BST <T, Balance, Compare, Allocator, Augment> & rhs, bool keepUnique)
+{
+    if (this == &rhs || !rhs.root)
+        return;
+
+    pool.share(rhs.pool);
+    BNode* p = rhs.leftmost;
+    while (p)
+    {
+        BNode* pParent = nullptr;
+        bool goLeft = false;
+        if (locate(p->data, keepUnique, pParent, goLeft, IsThreeWay()))
+        {
+            iterator it(p, &rhs);
+            p = (++it).pNode;
+            continue;
+        }
+        BNode* pNext = rhs.unlink(p);
+        p->reset();
+        attach(p, pParent, goLeft);
+        p = pNext;
+    }
+}
+
+/*************************************************
+ * BST :: UNLINK
+ * Take a node out of the tree and rebalance, leaving
+ * the node itself alone. Returns the node after it.
+ ************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: unlink(BNode * pDelete)
+{
+    // remember where we were
+    iterator itNext(pDelete, this);
+
+    // the neighbor of an extreme becomes the new extreme
+    if (pDelete == leftmost)
+        leftmost = (++iterator(pDelete)).pNode;
+    if (pDelete == rightmost)
+        rightmost = (--iterator(pDelete)).pNode;
+
+    // the node that fills the hole and its parent
+    BNode* pChild;
+    BNode* pChildParent;
+
+    // if there is only one child (right) or no children (how sad!)
+    if (!pDelete->pLeft)
+    {
+        ++itNext;
+        pChild = pDelete->pRight;
+        pChildParent = pDelete->pParent;
+        deleteNode(pDelete, true /* go right */);
+    }
+
+    // there is only one child (left)
+    else if (!pDelete->pRight)
+    {
+        ++itNext;
+        pChild = pDelete->pLeft;
+        pChildParent = pDelete->pParent;
+        deleteNode(pDelete, false);
+    }
+
+    // otherwise, swap places with the in-order successor
+    else
+    {
         // find the in-order successor ('I.O.S.')
         BNode* pIOS = pDelete->pRight;
         while (pIOS->pLeft)
             pIOS = pIOS->pLeft;
 
-        // the IOS must not have a right node. Now it will take pDelete's place.
-        assert(pIOS->pLeft == nullptr);
-        pIOS->pLeft = pDelete->pLeft;
-        if (pDelete->pLeft)
-            pDelete->pLeft->pParent = pIOS;
+        // the IOS's right child fills the hole the IOS leaves behind
+        pChild = pIOS->pRight;
+        pChildParent = (pDelete->pRight == pIOS) ? pIOS : static_cast<BNode*>(pIOS->pParent);
+
+        // the IOS must not have a right node. Now it will take pDelete's place.
+        assert(pIOS->pLeft == nullptr);
+        pIOS->pLeft = pDelete->pLeft;
+        if (pDelete->pLeft)
+            pDelete->pLeft->pParent = pIOS;
+
+        // if the IOS is not a direct right sibling, then put it in the place of pDelete
+        if (pDelete->pRight != pIOS)
+        {
+            // if the IOS has a right sibling, then it takes his place
+            if (pIOS->pRight)
+                pIOS->pRight->pParent = pIOS->pParent;
+            pIOS->pParent->pLeft = pIOS->pRight;
+
+            // make IOS' right child pDelete's right child
+            assert(pDelete->pRight != nullptr);
+            pIOS->pRight = pDelete->pRight;
+            pDelete->pRight->pParent = pIOS;
+        }
+
+        // hook up pIOS' successor
+        pIOS->pParent = pDelete->pParent;
+        if (pDelete->pParent && pDelete->pParent->pLeft == pDelete)
+            pDelete->pParent->pLeft = pIOS;
+        if (pDelete->pParent && pDelete->pParent->pRight == pDelete)
+            pDelete->pParent->pRight = pIOS;
+
+        // what if that was the root?!?!
+        if (root == pDelete)
+            root = pIOS;
+
+        // the IOS takes over pDelete's spot, balancing metadata and all,
+        // so what leaves the tree is the metadata of the IOS's old spot
+        std::swap(static_cast<typename Balance::Meta &>(*pIOS),
+                  static_cast<typename Balance::Meta &>(*pDelete));
+        swapTags(pIOS->pParent, pDelete->pParent);
+
+        itNext = iterator(pIOS, this);
+    }
+
+    numElements--;
+    Augment::erased(pChildParent);
+    Balance::erased(*this, pDelete, pChild, pChildParent);
+    return itNext.pNode;
+}
+
+
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST<T, Balance, Compare, Allocator, Augment>::deleteNode(BNode*& pDelete, bool right)
+{   
+    BNode* pNext = (right) ? pDelete->pRight : pDelete->pLeft;
+
+    if (pDelete != root)
+    {
+        if (pDelete->pParent->pLeft == pDelete)
+        {
+            pDelete->pParent->pLeft = nullptr;
+            pDelete->pParent->addLeft(pNext);
+        }
+        else
+        {
+            pDelete->pParent->pRight = nullptr;
+            pDelete->pParent->addRight(pNext);
+        }
+    }
+    else
+    {
+        this->root = pNext;
+        if (pNext)
+            pNext->pParent = nullptr;
+    }
+}
+
+/*****************************************************
+ * BST :: ROTATE LEFT
+ * Pivot pNode's right child up into pNode's place
+ *         (p)                  (r)
+ *        /   \                /   \
+ *      (a)   (r)     =>     (p)   (c)
+ *           /   \          /   \
+ *         (b)   (c)      (a)   (b)
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST<T, Balance, Compare, Allocator, Augment>::rotateLeft(BNode* pNode)
+{
+    BNode* pPivot = pNode->pRight;
+    assert(pPivot != nullptr);
+
+    pNode->addRight(pPivot->pLeft);
+
+    pPivot->pParent = pNode->pParent;
+    if (!pNode->pParent)
+        root = pPivot;
+    else if (pNode->isLeftChild())
+        pNode->pParent->pLeft = pPivot;
+    else
+        pNode->pParent->pRight = pPivot;
+
+    pPivot->addLeft(pNode);
+    Augment::update(pNode);
+    Augment::update(pPivot);
+}
+
+/*****************************************************
+ * BST :: ROTATE RIGHT
+ * Pivot pNode's left child up into pNode's place
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST<T, Balance, Compare, Allocator, Augment>::rotateRight(BNode* pNode)
+{
+    BNode* pPivot = pNode->pLeft;
+    assert(pPivot != nullptr);
+
+    pNode->addLeft(pPivot->pRight);
+
+    pPivot->pParent = pNode->pParent;
+    if (!pNode->pParent)
+        root = pPivot;
+    else if (pNode->isLeftChild())
+        pNode->pParent->pLeft = pPivot;
+    else
+        pNode->pParent->pRight = pPivot;
+
+    pPivot->addRight(pNode);
+    Augment::update(pNode);
+    Augment::update(pPivot);
+}
+
+/*****************************************************
+ * BST :: REBUILD
+ * Relink a subtree into a balanced shape, full but for its last
+ * level: Day-Stout-Warren, in O(n) time and O(1) space. The nodes
+ * keep their data; only the pointers change.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST<T, Balance, Compare, Allocator, Augment>::rebuild(BNode* pSubtree)
+{
+    BNode* pParent = pSubtree->pParent;
+    bool isLeft = pSubtree->isLeftChild();
+
+    // rotate every left child up until the subtree is a vine: one
+    // long right spine, in order. *ppLink is where we are on it.
+    BNode* pTop = pSubtree;
+    BNode** ppLink = &pTop;
+    BNode* pAbove = pParent;
+    size_t num = 0;
+    while (BNode* p = *ppLink)
+    {
+        if (BNode* pLeft = p->pLeft)
+        {
+            p->pLeft = pLeft->pRight;
+            if (p->pLeft)
+                p->pLeft->pParent = p;
+            pLeft->pRight = p;
+            p->pParent = pLeft;
+            pLeft->pParent = pAbove;
+            *ppLink = pLeft;
+        }
+        else
+        {
+            num++;
+            pAbove = p;
+            ppLink = &p->pRight;
+        }
+    }
+
+    // rotate every other node of the vine down to the left, count
+    // times from the top, which halves the spine
+    auto compress = [&](size_t count)
+    {
+        BNode** ppLink = &pTop;
+        BNode* pAbove = pParent;
+        for (size_t i = 0; i < count; i++)
+        {
+            BNode* p = *ppLink;
+            BNode* pRight = p->pRight;
+            p->pRight = pRight->pLeft;
+            if (p->pRight)
+                p->pRight->pParent = p;
+            pRight->pLeft = p;
+            p->pParent = pRight;
+            pRight->pParent = pAbove;
+            *ppLink = pRight;
+            pAbove = pRight;
+            ppLink = &pRight->pRight;
+        }
+    };
+
+    // first the nodes that do not fit in the full levels go to the
+    // bottom, then each pass makes one more level
+    size_t full = 1;
+    while (full * 2 <= num + 1)
+        full *= 2;
+    compress(num + 1 - full);
+    for (size_t spine = full - 1; spine > 1; )
+    {
+        spine /= 2;
+        compress(spine);
+    }
+
+    if (!pParent)
+        root = pTop;
+    else if (isLeft)
+        pParent->pLeft = pTop;
+    else
+        pParent->pRight = pTop;
+
+    // the children come before their parent
+    if (!std::is_same<Augment, NoAugment>::value)
+    {
+        BNode* p = pTop;
+        for (;;)
+        {
+            while (p->pLeft || p->pRight)
+                p = p->pLeft ? p->pLeft : p->pRight;
+            for (;;)
+            {
+                Augment::update(p);
+                if (p == pTop)
+                    return;
+                BNode* pUp = p->pParent;
+                if (p == pUp->pLeft && pUp->pRight)
+                {
+                    p = pUp->pRight;
+                    break;
+                }
+                p = pUp;
+            }
+        }
+    }
+}
+
+/*****************************************************
+ * BST :: WALK
+ * Call visit(node, depth) for every node under pTop, the depth of
+ * pTop being 1. No recursion: the parents lead the way back.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class Visit>
+void BST <T, Balance, Compare, Allocator, Augment> :: walk(const BNode* pTop, Visit visit) const
+{
+    const BNode* p = pTop;
+    const BNode* pFrom = pTop ? pTop->pParent : nullptr;
+    size_t depth = 1;
+    while (p)
+    {
+        const BNode* pNext;
+        if (pFrom == p->pParent)
+        {
+            visit(p, depth);
+            pNext = p->pLeft ? p->pLeft : (p->pRight ? p->pRight : nullptr);
+        }
+        else if (pFrom == p->pLeft)
+            pNext = p->pRight;
+        else
+            pNext = nullptr;
+
+        pFrom = p;
+        if (pNext)
+        {
+            p = pNext;
+            depth++;
+        }
+        else
+        {
+            p = (p == pTop) ? nullptr : p->pParent;
+            depth--;
+        }
+    }
+}
+
+/*****************************************************
+ * BST :: SIZE OF SUBTREE
+ * How many nodes are under pTop, counting them
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+size_t BST <T, Balance, Compare, Allocator, Augment> :: sizeOfSubtree(const BNode* pTop) const
+{
+    size_t num = 0;
+    walk(pTop, [&](const BNode*, size_t) { num++; });
+    return num;
+}
+
+/*****************************************************
+ * BST :: HEIGHT
+ * The deepest any node is
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+size_t BST <T, Balance, Compare, Allocator, Augment> :: height() const
+{
+    size_t height = 0;
+    walk(root, [&](const BNode*, size_t depth) { height = depth > height ? depth : height; });
+    return height;
+}
+
+/*****************************************************
+ * BST :: REBALANCE
+ * Rebuild the whole tree, then let the policy know about the new
+ * shape as if the tree had been built from sorted data. That only
+ * recurses as deep as the tree now is, O(log n).
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: rebalance()
+{
+    if (!root)
+        return;
+    rebuild(root);
+    markBuilt(root, 0, fullLevelsOf(numElements));
+}
+
+/*****************************************************
+ * BST :: MARK BUILT
+ * Children first, hand every node to the policy with its depth,
+ * the height of its subtree, which comes back, and the full levels
+ * of the whole tree
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+size_t BST <T, Balance, Compare, Allocator, Augment> :: markBuilt(BNode* pNode, size_t depth, size_t fullLevels)
+{
+    if (!pNode)
+        return 0;
+    size_t left = markBuilt(pNode->pLeft, depth + 1, fullLevels);
+    size_t right = markBuilt(pNode->pRight, depth + 1, fullLevels);
+    size_t height = 1 + (left > right ? left : right);
+    Balance::built(*this, pNode, depth, height, fullLevels);
+    return height;
+}
+
+/*****************************************************
+ * BST :: FULL LEVELS OF
+ * How many levels are full in a tree of num nodes that is full
+ * but for its last level. Worked out once per build.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+size_t BST <T, Balance, Compare, Allocator, Augment> :: fullLevelsOf(size_t num)
+{
+    size_t fullLevels = 0;
+    while (((size_t)2 << fullLevels) - 1 <= num)
+        fullLevels++;
+    return fullLevels;
+}
+
+/*****************************************************
+ * BST :: KEEP SHALLOW
+ * A new node landed deeper than auto_rebalance() allows. Climb
+ * until the subtree we are in is too deep for its own size, and
+ * rebuild it. Policies with data in every node cannot have part of
+ * the tree rebuilt, so for them the whole tree is rebalanced, but
+ * only once it has doubled or halved since the last time: O(n) work
+ * per n / 2 changes is O(1) per change. Rebalancing on every deep insert
+ * would make a sorted run of inserts O(n^2).
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: keepShallow(BNode* pNew)
+{
+    size_t depth = 0;
+    for (BNode* p = pNew; p->pParent; p = p->pParent)
+        depth++;
+    if ((double)depth <= depthFactor * std::log2((double)numElements))
+        return;
+    if (!std::is_empty<typename Balance::Meta>::value ||
+        !std::is_same<typename Balance::template Parent<BNode>, BNode*>::value)
+    {
+        if (numElements >= 2 * rebalancedSize || 2 * numElements <= rebalancedSize)
+        {
+            rebalance();
+            rebalancedSize = numElements;
+        }
+        return;
+    }
+
+    size_t size = 1;
+    size_t below = 0;
+    for (BNode* pChild = pNew; pChild->pParent; pChild = pChild->pParent)
+    {
+        BNode* pParent = pChild->pParent;
+        size += 1 + sizeOfSubtree(pChild->isLeftChild() ? pParent->pRight : pParent->pLeft);
+        below++;
+        if ((double)below > depthFactor * std::log2((double)size))
+        {
+            rebuild(pParent);
+            return;
+        }
+    }
+}
+
+/*****************************************************
+ * BST :: HANG
+ * Put pLeft and pRight under pNode, and pNode under pParent
+ * (or at the root). What pParent had there is replaced, and
+ * pNode and everything above it see their new elements.
+ * Used by the balancing policies to join trees.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST<T, Balance, Compare, Allocator, Augment>::hang(BNode* pNode, BNode* pLeft, BNode* pRight,
+                                                        BNode* pParent, bool goLeft)
+{
+    pNode->pLeft = pLeft;
+    if (pLeft)
+        pLeft->pParent = pNode;
+    pNode->pRight = pRight;
+    if (pRight)
+        pRight->pParent = pNode;
+
+    pNode->pParent = pParent;
+    if (!pParent)
+        root = pNode;
+    else if (goLeft)
+        pParent->pLeft = pNode;
+    else
+        pParent->pRight = pNode;
+
+    Augment::erased(pNode);
+}
+
+/*****************************************************
+ * BST :: SPLIT AT
+ * Everything before key stays, the rest goes to a new tree.
+ * Both are counted at the end, which is the O(min(m, n)) part
+ * unless the Augment counts.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+BST <T, Balance, Compare, Allocator, Augment> BST <T, Balance, Compare, Allocator, Augment> :: splitAt(const K& key)
+{
+    BST rhs(compare, get_allocator());
+    rhs.pool.share(pool);
+    rhs.balanceState = balanceState;
+    rhs.depthFactor = depthFactor;
+    if (!root)
+        return rhs;
+
+    size_t total = numElements;
+    numElements = 0;          // so the policy does not rebuild halfway
+    Piece left;
+    Piece right;
+    try
+    {
+        splitPiece(*this, root, [&](const BNode* p) { return lessThan(p->data, key) ? -1 : 1; }, left, right);
+    }
+    catch (...)
+    {
+        // the comparator is only called on the way down, before anything moved
+        numElements = total;
+        throw;
+    }
+    root = left.pRoot;
+    rhs.root = right.pRoot;
+
+    findExtremes();
+    rhs.findExtremes();
+    recount(rhs, total, std::integral_constant<bool, Augment::counts>());
+    return rhs;
+}
+
+/*****************************************************
+ * BST :: SPLIT PIECE
+ * Split the subtree under pTop in two. side(p) is -1 if p goes to
+ * the left piece, 1 if it goes to the right one, and 0 if it comes
+ * out on its own, in which case it is handed back. Go down to where
+ * the path ends, then climb back up. Every node on the way goes to
+ * one side along with its subtree on the far side of the path,
+ * joined on top of what that side has so far. The lower nodes go
+ * first, so each join only climbs the difference in rank, and those
+ * differences add up to O(log n).
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class Side>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: splitPiece(
+    BST& scratch, BNode* pTop, Side side, Piece& left, Piece& right) const
+{
+    left = right = Piece{ nullptr, 0 };
+    BNode* pLast = nullptr;
+    BNode* pTaken = nullptr;
+    bool goRight = false;
+    for (BNode* p = pTop; p; p = goRight ? p->pRight : p->pLeft)
+    {
+        pLast = p;
+        int order = side(p);
+        if (order == 0)
+        {
+            pTaken = p;
+            break;
+        }
+        goRight = order < 0;
+    }
+
+    // the children of a node taken out start the two sides
+    size_t rankBelow = 0;     // of the subtree we came up from, as it was
+    BNode* pFrom = nullptr;   // that subtree
+    BNode* p = pLast;
+    if (pTaken)
+    {
+        rankBelow = Balance::rankAbove(pTaken, rankOfSubtree(pTaken->pLeft));
+        left  = Piece{ pTaken->pLeft,  Balance::rankBelow(pTaken->pLeft,  pTaken, rankBelow) };
+        right = Piece{ pTaken->pRight, Balance::rankBelow(pTaken->pRight, pTaken, rankBelow) };
+        if (left.pRoot)
+            left.pRoot->pParent = nullptr;
+        if (right.pRoot)
+            right.pRoot->pParent = nullptr;
+        pFrom = pTaken;
+        p = (pTaken == pTop) ? nullptr : pTaken->pParent;
+        pTaken->pLeft = pTaken->pRight = pTaken->pParent = nullptr;
+    }
+
+    while (p)
+    {
+        BNode* pUp = (p == pTop) ? nullptr : p->pParent;
+        size_t rankHere = Balance::rankAbove(p, rankBelow);
+        if (pFrom ? pFrom == p->pRight : goRight)
+        {
+            BNode* pSide = p->pLeft;
+            size_t rankSide = Balance::rankBelow(pSide, p, rankHere);
+            if (pSide)
+                pSide->pParent = nullptr;
+            left = joinPieces(scratch, Piece{ pSide, rankSide }, p, left);
+        }
+        else
+        {
+            BNode* pSide = p->pRight;
+            size_t rankSide = Balance::rankBelow(pSide, p, rankHere);
+            if (pSide)
+                pSide->pParent = nullptr;
+            right = joinPieces(scratch, right, p, Piece{ pSide, rankSide });
+        }
+        rankBelow = rankHere;
+        pFrom = p;
+        p = pUp;
+    }
+    return pTaken;
+}
+
+/*****************************************************
+ * BST :: JOIN
+ * The first element of rhs goes between the two trees, and the
+ * policy joins the three. O(log n) to take it out and to join.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: join(BST <T, Balance, Compare, Allocator, Augment> & rhs)
+{
+    if (this == &rhs || !rhs.root)
+        return;
+    assert(!rightmost || !lessThan(rhs.leftmost->data, rightmost->data));
+    if (!root)
+    {
+        takeNodes(rhs);
+        return;
+    }
+
+    pool.share(rhs.pool);
+    BNode* pMiddle = rhs.leftmost;
+    rhs.unlink(pMiddle);
+    size_t rankLeft = rankOfSubtree(root);
+    size_t rankRight = rhs.rankOfSubtree(rhs.root);
+
+    numElements += rhs.numElements + 1;
+    rightmost = rhs.rightmost ? rhs.rightmost : pMiddle;
+    BNode* pRight = rhs.root;
+    rhs.root = rhs.leftmost = rhs.rightmost = nullptr;
+    rhs.numElements = 0;
+    Balance::join(*this, root, rankLeft, pMiddle, pRight, rankRight);
+}
+
+/*****************************************************
+ * BST :: RANK OF SUBTREE
+ * The rank of the subtree under pTop, from the bottom of its left
+ * side up
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+size_t BST <T, Balance, Compare, Allocator, Augment> :: rankOfSubtree(const BNode* pTop) const
+{
+    if (!pTop)
+        return 0;
+    const BNode* p = pTop;
+    while (p->pLeft)
+        p = p->pLeft;
+    size_t rank = Balance::rankAbove(p, 0);
+    while (p != pTop)
+    {
+        p = p->pParent;
+        rank = Balance::rankAbove(p, rank);
+    }
+    return rank;
+}
+
+/*****************************************************
+ * BST :: JOIN PIECES
+ * The policy joins left, pMiddle and right in the scratch tree,
+ * which gives its root straight back. Without a middle, the last
+ * node of left is taken out to be one.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST <T, Balance, Compare, Allocator, Augment> :: Piece BST <T, Balance, Compare, Allocator, Augment> :: joinPieces(
+    BST& scratch, const Piece& left, BNode* pMiddle, const Piece& right) const
+{
+    scratch.root = nullptr;
+    size_t rank = Balance::join(scratch, left.pRoot, left.rank, pMiddle, right.pRoot, right.rank);
+    Piece joined{ scratch.root, rank };
+    scratch.root = nullptr;
+    return joined;
+}
+
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST <T, Balance, Compare, Allocator, Augment> :: Piece BST <T, Balance, Compare, Allocator, Augment> :: joinPieces(
+    BST& scratch, const Piece& left, const Piece& right) const
+{
+    if (!left.pRoot)
+        return right;
+    if (!right.pRoot)
+        return left;
+    Piece rest;
+    Piece none;
+    BNode* pLast = splitPiece(scratch, left.pRoot, [](const BNode* p) { return p->pRight ? -1 : 0; }, rest, none);
+    return joinPieces(scratch, rest, pLast, right);
+}
+
+/*****************************************************
+ * BST :: RECOUNT
+ * Share total elements between this tree and rhs after a split.
+ * The root knows its size if the augmentation counts; otherwise
+ * walk both trees together until the smaller one runs out, which
+ * takes as many steps as the smaller tree has elements.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: recount(BST& rhs, size_t total, std::true_type /* counts */)
+{
+    numElements = Augment::sizeOf(root);
+    rhs.numElements = total - numElements;
+}
+
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: recount(BST& rhs, size_t total, std::false_type /* counts */)
+{
+    iterator itLeft = begin();
+    iterator itRight = rhs.begin();
+    size_t num = 0;
+    for (; itLeft != end() && itRight != rhs.end(); ++itLeft, ++itRight)
+        num++;
+    numElements = (itLeft == end()) ? num : total - num;
+    rhs.numElements = total - numElements;
+}
+
+
+
+/*****************************************************
+ * BST :: UNITE
+ * Everything in rhs comes here. Its nodes change trees, except
+ * for the ones equivalent to something already here. If the
+ * comparator throws, both trees are left empty.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class Fork>
+void BST <T, Balance, Compare, Allocator, Augment> :: unite(BST <T, Balance, Compare, Allocator, Augment> & rhs, Fork)
+{
+    if (this == &rhs || !rhs.root)
+        return;
+    if (!root)
+    {
+        takeNodes(rhs);
+        return;
+    }
+
+    pool.share(rhs.pool);
+    size_t total = numElements + rhs.numElements;
+    int forks = Fork::forksFor(numElements < rhs.numElements ? numElements : rhs.numElements);
+    Piece piece{ root, rankOfSubtree(root) };
+    BNode* pOther = rhs.root;
+    size_t rankOther = rhs.rankOfSubtree(pOther);
+    rhs.root = rhs.leftmost = rhs.rightmost = nullptr;
+    rhs.numElements = 0;
+    root = nullptr;
+    numElements = 0;          // so the policy does not rebuild halfway
+
+    Discard discard;
+    try
+    {
+        piece = unitePieces<Fork>(*this, piece, pOther, rankOther, discard, forks);
+    }
+    catch (...)
+    {
+        // every node of both trees is on the list by now
+        destroyDiscarded(discard);
+        adopt(Piece{ nullptr, 0 }, 0);
+        throw;
+    }
+    adopt(piece, total - destroyDiscarded(discard));
+}
 
-        // if the IOS is not a direct right sibling, then put it in the place of pDelete
-        if (pDelete->pRight != pIOS)
-        {
-            // if the IOS has a right sibling, then it takes his place
-            if (pIOS->pRight)
-                pIOS->pRight->pParent = pIOS->pParent;
-            pIOS->pParent->pLeft = pIOS->pRight;
+/*****************************************************
+ * BST :: INTERSECT
+ * Keep only what rhs has too. If the comparator throws, this
+ * tree is left empty.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class Fork>
+void BST <T, Balance, Compare, Allocator, Augment> :: intersect(const BST <T, Balance, Compare, Allocator, Augment> & rhs, Fork)
+{
+    if (this == &rhs || !root)
+        return;
+    if (!rhs.root)
+    {
+        clear();
+        return;
+    }
 
-            // make IOS' right child pDelete's right child
-            assert(pDelete->pRight != nullptr);
-            pIOS->pRight = pDelete->pRight;
-            pDelete->pRight->pParent = pIOS;
-        }
+    size_t total = numElements;
+    int forks = Fork::forksFor(numElements < rhs.numElements ? numElements : rhs.numElements);
+    Piece piece{ root, rankOfSubtree(root) };
+    root = nullptr;
+    numElements = 0;
 
-        // hook up pIOS' successor
-        pIOS->pParent = pDelete->pParent;
-        if (pDelete->pParent && pDelete->pParent->pLeft == pDelete)
-            pDelete->pParent->pLeft = pIOS;
-        if (pDelete->pParent && pDelete->pParent->pRight == pDelete)
-            pDelete->pParent->pRight = pIOS;
+    Discard discard;
+    try
+    {
+        piece = intersectPieces<Fork>(*this, piece, rhs.root, discard, forks);
+    }
+    catch (...)
+    {
+        // every node of this tree is on the list by now
+        destroyDiscarded(discard);
+        adopt(Piece{ nullptr, 0 }, 0);
+        throw;
+    }
+    adopt(piece, total - destroyDiscarded(discard));
+}
 
-        // what if that was the root?!?!
-        if (root == pDelete)
-            root = pIOS;
+/*****************************************************
+ * BST :: SUBTRACT
+ * Keep only what rhs does not have. If the comparator throws,
+ * this tree is left empty.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class Fork>
+void BST <T, Balance, Compare, Allocator, Augment> :: subtract(const BST <T, Balance, Compare, Allocator, Augment> & rhs, Fork)
+{
+    if (this == &rhs)
+    {
+        clear();
+        return;
+    }
+    if (!root || !rhs.root)
+        return;
+
+    size_t total = numElements;
+    int forks = Fork::forksFor(numElements < rhs.numElements ? numElements : rhs.numElements);
+    Piece piece{ root, rankOfSubtree(root) };
+    root = nullptr;
+    numElements = 0;
 
-        itNext = iterator(pIOS);
+    Discard discard;
+    try
+    {
+        piece = subtractPieces<Fork>(*this, piece, rhs.root, discard, forks);
     }
+    catch (...)
+    {
+        // every node of this tree is on the list by now
+        destroyDiscarded(discard);
+        adopt(Piece{ nullptr, 0 }, 0);
+        throw;
+    }
+    adopt(piece, total - destroyDiscarded(discard));
+}
 
-    numElements--;
-    delete pDelete;
-    return itNext;
+/*****************************************************
+ * BST :: UNITE PIECES
+ * The root of the other subtree comes out and splits this piece.
+ * Unite what is before it with its left subtree and what is after
+ * it with its right subtree, then join the two with it in the
+ * middle. If this piece had one the same, that one is kept instead.
+ * Each of the m nodes of the smaller tree takes a split and a join
+ * of O(log(n/m + 1)) on average.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class Fork>
+typename BST <T, Balance, Compare, Allocator, Augment> :: Piece BST <T, Balance, Compare, Allocator, Augment> :: unitePieces(
+    BST& scratch, Piece piece, BNode* pOther, size_t rankOther, Discard& discard, int forks) const
+{
+    if (!pOther)
+        return piece;
+    if (!piece.pRoot)
+        return Piece{ pOther, rankOther };
+
+    Piece lowerOther{ pOther->pLeft,  Balance::rankBelow(pOther->pLeft,  pOther, rankOther) };
+    Piece upperOther{ pOther->pRight, Balance::rankBelow(pOther->pRight, pOther, rankOther) };
+    if (lowerOther.pRoot)
+        lowerOther.pRoot->pParent = nullptr;
+    if (upperOther.pRoot)
+        upperOther.pRoot->pParent = nullptr;
+    pOther->pLeft = pOther->pRight = nullptr;
+
+    Piece lower{ nullptr, 0 };
+    Piece upper{ nullptr, 0 };
+    Piece left{ nullptr, 0 };
+    Piece right{ nullptr, 0 };
+    BNode* pSame = nullptr;
+    try
+    {
+        pSame = splitPiece(scratch, piece.pRoot,
+                           [&](const BNode* p) { return orderOf(p->data, pOther->data); }, lower, upper);
+        piece.pRoot = nullptr;
+        bothHalves<Fork>([&](bool isLeft, BST& scratchHalf, Discard& discardHalf, int forksHalf)
+        {
+            Piece mine  = takePiece(isLeft ? lower : upper);
+            Piece other = takePiece(isLeft ? lowerOther : upperOther);
+            return unitePieces<Fork>(scratchHalf, mine, other.pRoot, other.rank, discardHalf, forksHalf);
+        }, left, right, scratch, discard, forks);
+    }
+    catch (...)
+    {
+        discard.pushAll({ piece.pRoot, lower.pRoot, upper.pRoot, lowerOther.pRoot, upperOther.pRoot,
+                          left.pRoot, right.pRoot, pOther, pSame });
+        throw;
+    }
+
+    if (pSame)
+    {
+        discard.push(pOther);
+        pOther = pSame;
+    }
+    return joinPieces(scratch, left, pOther, right);
 }
 
+/*****************************************************
+ * BST :: INTERSECT PIECES
+ * Split this piece around the root of the other subtree, intersect
+ * both sides with the subtrees of the other on the same sides, and
+ * join them, with the one this piece had the same in the middle.
+ * The other subtree is only read.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class Fork>
+typename BST <T, Balance, Compare, Allocator, Augment> :: Piece BST <T, Balance, Compare, Allocator, Augment> :: intersectPieces(
+    BST& scratch, Piece piece, const BNode* pOther, Discard& discard, int forks) const
+{
+    if (!piece.pRoot)
+        return piece;
+    if (!pOther)
+    {
+        discard.push(piece.pRoot);
+        return Piece{ nullptr, 0 };
+    }
 
-template <typename T>
-void BST<T>::deleteNode(BNode*& pDelete, bool right)
-{   
-    BNode* pNext = (right) ? pDelete->pRight : pDelete->pLeft;
+    Piece lower{ nullptr, 0 };
+    Piece upper{ nullptr, 0 };
+    Piece left{ nullptr, 0 };
+    Piece right{ nullptr, 0 };
+    BNode* pSame = nullptr;
+    try
+    {
+        pSame = splitPiece(scratch, piece.pRoot,
+                           [&](const BNode* p) { return orderOf(p->data, pOther->data); }, lower, upper);
+        piece.pRoot = nullptr;
+        bothHalves<Fork>([&](bool isLeft, BST& scratchHalf, Discard& discardHalf, int forksHalf)
+        {
+            return isLeft ? intersectPieces<Fork>(scratchHalf, takePiece(lower), pOther->pLeft,  discardHalf, forksHalf)
+                          : intersectPieces<Fork>(scratchHalf, takePiece(upper), pOther->pRight, discardHalf, forksHalf);
+        }, left, right, scratch, discard, forks);
+    }
+    catch (...)
+    {
+        discard.pushAll({ piece.pRoot, lower.pRoot, upper.pRoot, left.pRoot, right.pRoot, pSame });
+        throw;
+    }
 
-    if (pDelete != root)
+    return pSame ? joinPieces(scratch, left, pSame, right) : joinPieces(scratch, left, right);
+}
+
+/*****************************************************
+ * BST :: SUBTRACT PIECES
+ * The same, but what this piece had the same goes, and the
+ * two sides are joined without it
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class Fork>
+typename BST <T, Balance, Compare, Allocator, Augment> :: Piece BST <T, Balance, Compare, Allocator, Augment> :: subtractPieces(
+    BST& scratch, Piece piece, const BNode* pOther, Discard& discard, int forks) const
+{
+    if (!piece.pRoot || !pOther)
+        return piece;
+
+    Piece lower{ nullptr, 0 };
+    Piece upper{ nullptr, 0 };
+    Piece left{ nullptr, 0 };
+    Piece right{ nullptr, 0 };
+    BNode* pSame = nullptr;
+    try
     {
-        if (pDelete->pParent->pLeft == pDelete)
+        pSame = splitPiece(scratch, piece.pRoot,
+                           [&](const BNode* p) { return orderOf(p->data, pOther->data); }, lower, upper);
+        piece.pRoot = nullptr;
+        bothHalves<Fork>([&](bool isLeft, BST& scratchHalf, Discard& discardHalf, int forksHalf)
         {
-            pDelete->pParent->pLeft = nullptr;
-            pDelete->pParent->addLeft(pNext);
+            return isLeft ? subtractPieces<Fork>(scratchHalf, takePiece(lower), pOther->pLeft,  discardHalf, forksHalf)
+                          : subtractPieces<Fork>(scratchHalf, takePiece(upper), pOther->pRight, discardHalf, forksHalf);
+        }, left, right, scratch, discard, forks);
+    }
+    catch (...)
+    {
+        discard.pushAll({ piece.pRoot, lower.pRoot, upper.pRoot, left.pRoot, right.pRoot, pSame });
+        throw;
+    }
+
+    if (pSame)
+        discard.push(pSame);
+    return joinPieces(scratch, left, right);
+}
+
+/*****************************************************
+ * BST :: BOTH HALVES
+ * half(isLeft, scratch, discard, forks) works out one half. With
+ * forks to spare, Fork may give the left half a thread of its own,
+ * so it gets a scratch tree and a discard list of its own. The two
+ * halves share no nodes. A half takes its pieces over with
+ * takePiece(), and leaves them on its list if it throws, so the
+ * caller knows which nodes are still its own.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class Fork, class Half>
+void BST <T, Balance, Compare, Allocator, Augment> :: bothHalves(
+    Half half, Piece& left, Piece& right, BST& scratch, Discard& discard, int forks) const
+{
+    if (forks > 0)
+    {
+        Discard discardLeft;
+        try
+        {
+            Fork::both([&]()
+            {
+                BST scratchLeft(compare, get_allocator());
+                left = half(true /* isLeft */, scratchLeft, discardLeft, forks - 1);
+            }, [&]()
+            {
+                right = half(false /* isLeft */, scratch, discard, forks - 1);
+            });
         }
-        else
+        catch (...)
         {
-            pDelete->pParent->pRight = nullptr;
-            pDelete->pParent->addRight(pNext);
+            discard.append(discardLeft);
+            throw;
         }
+        discard.append(discardLeft);
+        return;
     }
-    else
+    left = half(true /* isLeft */, scratch, discard, 0);
+    right = half(false /* isLeft */, scratch, discard, 0);
+}
+
+/*****************************************************
+ * BST :: DESTROY DISCARDED
+ * Destroy every subtree on the list, and say how many nodes went
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+size_t BST <T, Balance, Compare, Allocator, Augment> :: destroyDiscarded(Discard& discard)
+{
+    size_t num = 0;
+    for (BNode* pTop = discard.pHead; pTop; )
     {
-        this->root = pNext;
-        pNext->pParent = nullptr;
+        BNode* pNext = pTop->pParent;
+        num += deleteBinaryTree(pTop);
+        pTop = pNext;
     }
+    discard.pHead = discard.pTail = nullptr;
+    return num;
 }
 
-
+/*****************************************************
+ * BST :: ADOPT
+ * A piece of num elements becomes the whole tree
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: adopt(const Piece& piece, size_t num)
+{
+    root = piece.pRoot;
+    numElements = num;
+    findExtremes();
+}
 
 /*****************************************************
  * BST :: CLEAR
  * Removes all the BNodes from a tree
  ****************************************************/
-template <typename T>
-void BST <T> ::clear() noexcept
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> ::clear() noexcept
 {
 	//// recursivly go down the rabit hole of the tree, once it hits the bottom will delete the leaf nodes on the way back up
  //   std::function<void(BNode*)> deleteNodes = [&](BNode* node) {
@@ -606,46 +2607,342 @@ void BST <T> ::clear() noexcept
  //   root = nullptr;
  //   numElements = 0;
 
-    //if (root)
-    deleteBinaryTree(root);
+    // the destructors only need to run if they do something, or if the
+    // chunks are shared and the slots must go back for the other trees
+    // to use. Otherwise the memory goes back a whole chunk at a time.
+    if (std::is_trivially_destructible<BNode>::value && !pool.shared())
+        root = nullptr;
+    else
+        deleteBinaryTree(root);
+    leftmost = rightmost = nullptr;
+    pool.release();
     numElements = 0;
+    rebalancedSize = 0;
+}
+
+/*****************************************************
+ * BST :: POP FRONT
+ * Remove the smallest element. The next smallest is its
+ * right child or its parent, so this is amortized O(1)
+ * apart from the rebalancing.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: pop_front()
+{
+    assert(leftmost != nullptr);
+    iterator it(leftmost, this);
+    erase(it);
 }
 
 /*****************************************************
- * BST :: BEGIN
- * Return the first node (left-most) in a binary search tree
+ * BST :: POP BACK
+ * Remove the largest element
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: pop_back()
+{
+    assert(rightmost != nullptr);
+    iterator it(rightmost, this);
+    erase(it);
+}
+
+
+/****************************************************
+ * BST :: FIND NODE
+ * With a less-than comparator, go all the way down to the lower
+ * bound and check it once for equality. With a three-way
+ * comparator we can stop as soon as we see k.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: findNode(
+    const K & k, std::false_type /* less than */) const
+{
+    BNode* p = lowerBoundNode(k, root, nullptr);
+    return (p && !compare(k, p->data)) ? p : nullptr;
+}
+
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: findNode(
+    const K & k, std::true_type /* three way */) const
+{
+    BNode* p = root;
+    while (p)
+    {
+        auto order = compare(k, p->data);
+        if (order == 0)
+            return p;
+        p = (order < 0) ? p->pLeft : p->pRight;
+    }
+    return nullptr;
+}
+
+/****************************************************
+ * BST :: ACCESS NODE
+ * A node equal to k, found the way findNode() does, with one
+ * comparator call per node. The node found goes to the policy,
+ * or on a miss the last node the search touched.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: accessNode(
+    const K & k)
+{
+    BNode* pTouched = nullptr;
+    BNode* pFound = accessNode(k, pTouched, IsThreeWay());
+    if (pTouched)
+        Balance::accessed(*this, pTouched);
+    return pFound;
+}
+
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: accessNode(
+    const K & k, BNode*& pTouched, std::false_type /* less than */) const
+{
+    BNode* pBound = nullptr;
+    for (BNode* p = root; p; )
+    {
+        pTouched = p;
+        if (lessThan(p->data, k))
+            p = p->pRight;
+        else
+        {
+            pBound = p;
+            p = p->pLeft;
+        }
+    }
+    if (!pBound || lessThan(k, pBound->data))
+        return nullptr;
+    pTouched = pBound;
+    return pBound;
+}
+
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: accessNode(
+    const K & k, BNode*& pTouched, std::true_type /* three way */) const
+{
+    for (BNode* p = root; p; )
+    {
+        pTouched = p;
+        auto order = compare(k, p->data);
+        if (order == 0)
+            return p;
+        p = (order < 0) ? p->pLeft : p->pRight;
+    }
+    return nullptr;
+}
+
+/****************************************************
+ * BST :: LOWER BOUND NODE
+ * The first node that is not less than k, looking in the subtree
+ * p. If there is none there, it is pCandidate.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: lowerBoundNode(
+    const K & k, BNode * p, BNode * pCandidate) const
+{
+    while (p)
+    {
+        if (lessThan(p->data, k))
+            p = p->pRight;
+        else
+        {
+            pCandidate = p;
+            p = p->pLeft;
+        }
+    }
+    return pCandidate;
+}
+
+/****************************************************
+ * BST :: UPPER BOUND NODE
+ * The first node that is greater than k, looking in the subtree
+ * p. If there is none there, it is pCandidate.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: upperBoundNode(
+    const K & k, BNode * p, BNode * pCandidate) const
+{
+    while (p)
+    {
+        if (lessThan(k, p->data))
+        {
+            pCandidate = p;
+            p = p->pLeft;
+        }
+        else
+            p = p->pRight;
+    }
+    return pCandidate;
+}
+
+/****************************************************
+ * BST :: EQUAL RANGE NODES
+ * The lower and upper bound of k in one trip down the tree.
+ * Until we meet an element equal to k both bounds follow the
+ * same path; after that the lower bound is in the left subtree
+ * of that element and the upper bound is in the right.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+std::pair<typename BST <T, Balance, Compare, Allocator, Augment> :: BNode *,
+          typename BST <T, Balance, Compare, Allocator, Augment> :: BNode *>
+BST <T, Balance, Compare, Allocator, Augment> :: equalRangeNodes(const K & k) const
+{
+    BNode* pUpper = nullptr;
+    BNode* p = root;
+    while (p)
+    {
+        if (lessThan(p->data, k))
+            p = p->pRight;
+        else if (lessThan(k, p->data))
+        {
+            pUpper = p;
+            p = p->pLeft;
+        }
+        else
+            return std::make_pair(lowerBoundNode(k, p->pLeft, p),
+                                  upperBoundNode(k, p->pRight, pUpper));
+    }
+    return std::make_pair(pUpper, pUpper);
+}
+
+/****************************************************
+ * BST :: COUNT NODES
+ * How many elements are equal to k
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+size_t BST <T, Balance, Compare, Allocator, Augment> :: countNodes(const K & k) const
+{
+    std::pair<BNode*, BNode*> range = equalRangeNodes(k);
+    size_t num = 0;
+    for (iterator it(range.first); it != iterator(range.second); ++it)
+        num++;
+    return num;
+}
+
+/****************************************************
+ * BST :: RANK OF
+ * The number of elements before k. Every time we go right, the
+ * node and everything to its left come before k.
  ****************************************************/
-template <typename T>
-typename BST <T> :: iterator custom :: BST <T> :: begin() const noexcept
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K>
+size_t BST <T, Balance, Compare, Allocator, Augment> :: rankOf(const K & k) const
 {
-    BNode* current = root;
-    // move left until we find the left most node 
-    while (current && current->pLeft)
-        current = current->pLeft;
-    return iterator(current);
+    static_assert(Augment::counts, "rank() needs an Augment that counts, such as OrderStatistic");
+    size_t rank = 0;
+    for (BNode* p = root; p; )
+    {
+        if (lessThan(p->data, k))
+        {
+            rank += Augment::sizeOf(p->pLeft) + 1;
+            p = p->pRight;
+        }
+        else
+            p = p->pLeft;
+    }
+    return rank;
 }
 
+/****************************************************
+ * BST :: SELECT NODE
+ * The node at position k in order, or nullptr if there are not
+ * that many. The size of the left subtree says which way to go.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST <T, Balance, Compare, Allocator, Augment> :: BNode * BST <T, Balance, Compare, Allocator, Augment> :: selectNode(size_t k) const
+{
+    static_assert(Augment::counts, "select() needs an Augment that counts, such as OrderStatistic");
+    BNode* p = root;
+    while (p)
+    {
+        size_t sizeLeft = Augment::sizeOf(p->pLeft);
+        if (k < sizeLeft)
+            p = p->pLeft;
+        else if (k == sizeLeft)
+            return p;
+        else
+        {
+            k -= sizeLeft + 1;
+            p = p->pRight;
+        }
+    }
+    return nullptr;
+}
 
 /****************************************************
- * BST :: FIND
- * Return the node corresponding to a given value
+ * BST :: AGGREGATE OF
+ * Combine everything in [lo, hi). Go down to the first node in
+ * the range; everything else in it hangs off the two paths from
+ * there to lo and to hi. Along the way to lo, each node in range
+ * brings its right subtree along, and along the way to hi, its
+ * left one. The pieces are combined in order.
  ****************************************************/
-template <typename T>
-typename BST <T> :: iterator BST<T> :: find(const T & t)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+template <class K, class A>
+typename A::result_type BST <T, Balance, Compare, Allocator, Augment> :: aggregateOf(const K & lo, const K & hi) const
 {
- BNode* current = root;
-    while (current) 
+    typename A::result_type none = A::identity();
+
+    // the top of the range, where the two paths split
+    BNode* pSplit = root;
+    while (pSplit)
+    {
+        if (!lessThan(pSplit->data, hi))
+            pSplit = pSplit->pLeft;
+        else if (lessThan(pSplit->data, lo))
+            pSplit = pSplit->pRight;
+        else
+            break;
+    }
+    if (!pSplit)
+        return none;
+
+    // everything from lo up to pSplit. Each piece comes before the last.
+    typename A::result_type left = none;
+    for (BNode* p = pSplit->pLeft; p; )
+    {
+        if (lessThan(p->data, lo))
+            p = p->pRight;
+        else
+        {
+            left = A::combine(A::combine(A::lift(p), A::valueOf(p->pRight)), left);
+            p = p->pLeft;
+        }
+    }
+
+    // everything after pSplit up to hi. Each piece comes after the last.
+    typename A::result_type right = none;
+    for (BNode* p = pSplit->pRight; p; )
     {
-        if (current->data == t)
-            return iterator(current);
-        // move left 
-        else if (t < current->data)
-            current = current->pLeft;  
-        // move right 
+        if (!lessThan(p->data, hi))
+            p = p->pLeft;
         else
-            current = current->pRight;
+        {
+            right = A::combine(right, A::combine(A::valueOf(p->pLeft), A::lift(p)));
+            p = p->pRight;
+        }
     }
-    return end();
+
+    return A::combine(A::combine(left, A::lift(pSplit)), right);
+}
+
+/****************************************************
+ * BST :: SELECT
+ * The element at position k, which had better be there
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+const T & BST <T, Balance, Compare, Allocator, Augment> :: select(size_t k) const
+{
+    assert(k < numElements);
+    return selectNode(k)->data;
 }
 
 /******************************************************
@@ -657,12 +2954,26 @@ typename BST <T> :: iterator BST<T> :: find(const T & t)
  ******************************************************/
 
  
+/******************************************************
+ * BINARY NODE :: RESET
+ * No links, and the balancing and augmented data of a
+ * node that was just made. The element stays.
+ ******************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: BNode :: reset()
+{
+    pLeft = pRight = pParent = nullptr;
+    clearTag(pParent);
+    static_cast<typename Balance::Meta &>(*this) = typename Balance::Meta();
+    static_cast<typename Augment::template Meta<T> &>(*this) = typename Augment::template Meta<T>();
+}
+
 /******************************************************
  * BINARY NODE :: ADD LEFT
  * Add a node to the left of the current node
  ******************************************************/
-template <typename T>
-void BST <T> :: BNode :: addLeft (BNode * pNode)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: BNode :: addLeft (BNode * pNode)
 {
     if (pNode)
         pNode->pParent = this;
@@ -673,8 +2984,8 @@ void BST <T> :: BNode :: addLeft (BNode * pNode)
  * BINARY NODE :: ADD RIGHT
  * Add a node to the right of the current node
  ******************************************************/
-template <typename T>
-void BST <T> :: BNode :: addRight (BNode * pNode)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: BNode :: addRight (BNode * pNode)
 {
     if (pNode)
         pNode->pParent = this;
@@ -683,45 +2994,45 @@ void BST <T> :: BNode :: addRight (BNode * pNode)
 
 /******************************************************
  * BINARY NODE :: ADD LEFT
- * Add a node to the left of the current node
+ * Create a node in the pool and add it to the left of the current node
  ******************************************************/
-template <typename T>
-void BST<T> :: BNode :: addLeft (const T & t)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST<T, Balance, Compare, Allocator, Augment> :: BNode :: addLeft (NodePool<BNode, Allocator> & pool, const T & t)
 {
-    BNode* newNode = new BNode(t);
+    BNode* newNode = pool.create(t);
     addLeft(newNode);
 }
 
 /******************************************************
  * BINARY NODE :: ADD LEFT
- * Add a node to the left of the current node
+ * Create a node in the pool and add it to the left of the current node
  ******************************************************/
-template <typename T>
-void BST<T> ::BNode::addLeft(T && t)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST<T, Balance, Compare, Allocator, Augment> ::BNode::addLeft(NodePool<BNode, Allocator> & pool, T && t)
 {
-    BNode* newNode = new BNode(t);
+    BNode* newNode = pool.create(std::move(t));
     addLeft(newNode);
 }
 
 /******************************************************
  * BINARY NODE :: ADD RIGHT
- * Add a node to the right of the current node
+ * Create a node in the pool and add it to the right of the current node
  ******************************************************/
-template <typename T>
-void BST <T> :: BNode :: addRight (const T & t)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> :: BNode :: addRight (NodePool<BNode, Allocator> & pool, const T & t)
 {
-	BNode* newNode = new BNode(t);
+	BNode* newNode = pool.create(t);
 	addRight(newNode);
 }
 
 /******************************************************
  * BINARY NODE :: ADD RIGHT
- * Add a node to the right of the current node
+ * Create a node in the pool and add it to the right of the current node
  ******************************************************/
-template <typename T>
-void BST <T> ::BNode::addRight(T && t)
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+void BST <T, Balance, Compare, Allocator, Augment> ::BNode::addRight(NodePool<BNode, Allocator> & pool, T && t)
 {
-	BNode* newNode = new BNode(t);
+	BNode* newNode = pool.create(std::move(t));
 	addRight(newNode);
 
 }
@@ -740,8 +3051,8 @@ void BST <T> ::BNode::addRight(T && t)
  * BST ITERATOR :: INCREMENT PREFIX
  * advance by one
  *************************************************/
-template <typename T>
-typename BST <T> :: iterator & BST <T> :: iterator :: operator ++ ()
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST <T, Balance, Compare, Allocator, Augment> :: iterator & BST <T, Balance, Compare, Allocator, Augment> :: iterator :: operator ++ ()
 {
     if (!pNode)
         return *this;
@@ -770,13 +3081,18 @@ typename BST <T> :: iterator & BST <T> :: iterator :: operator ++ ()
  * BST ITERATOR :: DECREMENT PREFIX
  * advance by one
  *************************************************/
-template <typename T>
-typename BST <T> :: iterator & BST <T> :: iterator :: operator -- ()
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment>
+typename BST <T, Balance, Compare, Allocator, Augment> :: iterator & BST <T, Balance, Compare, Allocator, Augment> :: iterator :: operator -- ()
 {
     // same as incremement but swaps left/right 
 
+    // back from end() is the largest element
     if (!pNode)
+    {
+        if (pTree)
+            pNode = pTree->rightmost;
         return *this;
+    }
     // move to the left if there is a node to the left
     if (pNode->pLeft)
     {
@@ -799,6 +3115,61 @@ typename BST <T> :: iterator & BST <T> :: iterator :: operator -- ()
 }
 
 
+/*****************************************************
+ * SET UNION, SET INTERSECTION, SET DIFFERENCE
+ * A new tree from two that are left alone. Only what the answer
+ * starts from is copied: both trees for the union, the smaller
+ * tree for the intersection (whose elements are the ones kept),
+ * and lhs for the difference.
+ ****************************************************/
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment, class Fork = Serial>
+BST <T, Balance, Compare, Allocator, Augment> set_union(const BST <T, Balance, Compare, Allocator, Augment> & lhs,
+                                                        const BST <T, Balance, Compare, Allocator, Augment> & rhs,
+                                                        Fork fork = Fork())
+{
+    BST <T, Balance, Compare, Allocator, Augment> united(lhs);
+    BST <T, Balance, Compare, Allocator, Augment> other(rhs);
+    united.unite(other, fork);
+    return united;
+}
+
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment, class Fork = Serial>
+BST <T, Balance, Compare, Allocator, Augment> set_intersection(const BST <T, Balance, Compare, Allocator, Augment> & lhs,
+                                                               const BST <T, Balance, Compare, Allocator, Augment> & rhs,
+                                                               Fork fork = Fork())
+{
+    bool lhsSmaller = lhs.size() <= rhs.size();
+    BST <T, Balance, Compare, Allocator, Augment> common(lhsSmaller ? lhs : rhs);
+    common.intersect(lhsSmaller ? rhs : lhs, fork);
+    return common;
+}
+
+template <typename T, typename Balance, typename Compare, typename Allocator, typename Augment, class Fork = Serial>
+BST <T, Balance, Compare, Allocator, Augment> set_difference(const BST <T, Balance, Compare, Allocator, Augment> & lhs,
+                                                             const BST <T, Balance, Compare, Allocator, Augment> & rhs,
+                                                             Fork fork = Fork())
+{
+    BST <T, Balance, Compare, Allocator, Augment> rest(lhs);
+    rest.subtract(rhs, fork);
+    return rest;
+}
+
+#ifdef CUSTOM_HAS_PMR
+/*****************************************************************
+ * PMR BST
+ * A BST whose nodes come from a std::pmr::memory_resource, such as
+ * a monotonic_buffer_resource arena that is dropped all at once
+ *****************************************************************/
+namespace pmr
+{
+   template <typename T,
+             typename Balance = RedBlack,
+             typename Compare = std::less<T>,
+             typename Augment = NoAugment >
+   using BST = custom::BST<T, Balance, Compare, std::pmr::polymorphic_allocator<T>, Augment>;
+}
+#endif // CUSTOM_HAS_PMR
+
 } // namespace custom
 
 
@@ -0,0 +1,105 @@
+/***********************************************************************
+ * Header:
+ *    COMPACT
+ * Summary:
+ *    The lean tree with 32-bit links. Every node is in one array, and
+ *    a link is how many slots away the child is, so that a node with
+ *    8-byte elements is 16 bytes: two thirds of what a lean node
+ *    takes, and two fifths of a BST node. A link counts from the node
+ *    it is in rather than from the start of the array, so the links
+ *    do not need to know where the array is, and it can move when it
+ *    grows without any of them changing. The color is the low bit of
+ *    the left link.
+ *
+ *    The price is the moving: an insert that grows the array moves
+ *    every element, with its move constructor, and as with vector it
+ *    leaves no iterator good. The path in the lean tree's iterators
+ *    is no longer good after an insert that rotates anyway.
+ *
+ *    This will contain the class definition of:
+ *        IndexLinks          : Children by 32-bit index, the color in the left one
+ *        CompactTree         : A lean tree on index links
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>     // for int32_t
+#include <functional>  // for std::less
+#include <memory>      // for std::allocator
+#include <type_traits> // for std::is_nothrow_move_constructible
+#include <utility>     // for std::forward and std::move
+#include "lean.h"      // for LeanTree
+
+namespace custom
+{
+
+/*****************************************************************
+ * INDEX LINKS
+ * An element and its children, each as the distance in slots from
+ * the node to the child, and 0 for none: a node is never its own
+ * child. The left link is doubled to make room for the color in
+ * its low bit, which leaves 31 bits, enough for the most slots an
+ * ArrayPool has. There are no threads.
+ *****************************************************************/
+template <class T>
+struct IndexLinks
+{
+   class Node
+   {
+   public:
+      template <class ... Args>
+      explicit Node(Args && ... args) : data(std::forward<Args>(args)...), iLeft(0), iRight(0) { }
+
+      // the array moves its nodes when it grows, links and all
+      Node(Node && rhs) noexcept(std::is_nothrow_move_constructible<T>::value) :
+         data(std::move(rhs.data)), iLeft(rhs.iLeft), iRight(rhs.iRight) { }
+
+      T data;                     // user data
+      int32_t iLeft;              // twice the way to the left child, and the color (red when new)
+      int32_t iRight;             // the way to the right child
+   };
+
+   static const bool oneArray = true;
+   static const bool threads  = false;
+
+   // the colors, kept in the low bit of the left link: set for black
+   static bool isRed(const Node * pNode) { return pNode && !(pNode->iLeft & 1); }
+   static void paint(Node * pNode, bool red) { pNode->iLeft = (pNode->iLeft & ~1) | (red ? 0 : 1); }
+
+   static Node * left (const Node * pNode) { return follow(pNode, (pNode->iLeft & ~1) / 2); }
+   static Node * right(const Node * pNode) { return follow(pNode, pNode->iRight); }
+   static Node * leftThread (const Node * /* pNode */) { return nullptr; }
+   static Node * rightThread(const Node * /* pNode */) { return nullptr; }
+   static void hangLeft (Node * pNode, Node * pChild, Node * /* pThread */)
+   {
+      pNode->iLeft = way(pNode, pChild) * 2 + (pNode->iLeft & 1);
+   }
+   static void hangRight(Node * pNode, Node * pChild, Node * /* pThread */)
+   {
+      pNode->iRight = way(pNode, pChild);
+   }
+
+private:
+   static Node * follow(const Node * pNode, int32_t way)
+   {
+      return way ? const_cast<Node *>(pNode) + way : nullptr;
+   }
+   static int32_t way(const Node * pNode, const Node * pChild)
+   {
+      return pChild ? (int32_t)(pChild - pNode) : 0;
+   }
+};
+
+/************************************************
+ * COMPACT TREE
+ * Unique elements in order, like set, on a red-black tree of 32-bit
+ * links into one array. It holds at most 2^30 elements.
+ ***********************************************/
+template <class T,
+          class Compare   = std::less<T>,
+          class Allocator = std::allocator<T> >
+using CompactTree = LeanTree <T, Compare, Allocator, IndexLinks<T> >;
+
+} // namespace custom
@@ -0,0 +1,277 @@
+/***********************************************************************
+ * Header:
+ *    INTERVAL
+ * Summary:
+ *    An interval tree on top of our BST. The intervals are kept in
+ *    order of their start, and every node also knows the largest end
+ *    in its subtree, so a search for overlaps can skip every subtree
+ *    that ends too early.
+ *
+ *    This will contain the class definition of:
+ *        Interval            : A half-open range [start, end)
+ *        IntervalMax         : The augmentation with the largest end
+ *        IntervalTree        : Intervals, and which of them overlap what
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <functional> // for std::less
+#include <initializer_list> // for std::initializer_list
+#include <memory>     // for std::allocator
+#include <vector>     // for std::vector
+#include "bst.h"      // for BST
+
+class TestInterval; // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * INTERVAL
+ * Everything from start up to, but not including, end.
+ * Ordered by start, then by end.
+ ***********************************************/
+template <class Point>
+struct Interval
+{
+   Interval() : start(), end() { }
+   Interval(const Point & start, const Point & end) : start(start), end(end) { }
+
+   // do we share anything with [lo, hi)?
+   bool overlaps(const Point & lo, const Point & hi) const { return start < hi && lo < end; }
+   bool contains(const Point & point) const { return !(point < start) && point < end; }
+
+   bool operator == (const Interval & rhs) const { return !(start < rhs.start) && !(rhs.start < start) &&
+                                                          !(end < rhs.end) && !(rhs.end < end); }
+   bool operator != (const Interval & rhs) const { return !(*this == rhs); }
+   bool operator <  (const Interval & rhs) const
+   {
+      return start < rhs.start || (!(rhs.start < start) && end < rhs.end);
+   }
+
+   Point start;
+   Point end;
+};
+
+/*****************************************************************
+ * INTERVAL MAX
+ * The augmentation (see augment.h) that gives every node the
+ * largest end in its subtree
+ *****************************************************************/
+template <class Point>
+struct IntervalMax
+{
+   template <class T>
+   struct Meta { Point maxEnd = Point(); };   // set as soon as the node is linked in
+
+   static const bool counts = false;
+
+   template <class Node>
+   static void update(Node * pNode)
+   {
+      pNode->maxEnd = pNode->data.end;
+      if (pNode->pLeft && pNode->maxEnd < pNode->pLeft->maxEnd)
+         pNode->maxEnd = pNode->pLeft->maxEnd;
+      if (pNode->pRight && pNode->maxEnd < pNode->pRight->maxEnd)
+         pNode->maxEnd = pNode->pRight->maxEnd;
+   }
+
+   // the ancestors only change until one already reaches that far
+   template <class Node>
+   static void inserted(Node * pNode)
+   {
+      pNode->maxEnd = pNode->data.end;
+      for (Node * p = pNode->pParent; p && p->maxEnd < pNode->maxEnd; p = p->pParent)
+         p->maxEnd = pNode->maxEnd;
+   }
+
+   template <class Node>
+   static void erased(Node * pParent)
+   {
+      for (; pParent; pParent = pParent->pParent)
+         update(pParent);
+   }
+};
+
+/************************************************
+ * INTERVAL TREE
+ * Intervals (repeats allowed) in order of their start, on a
+ * balanced BST. Finding the k that overlap something costs
+ * O(log n) to get to the first and at most O(log n) for each
+ * after that: O(min(n, k log n)) in all, not O(log n + k).
+ ***********************************************/
+template <class Point,
+          class Balance   = RedBlack,
+          class Allocator = std::allocator<Interval<Point> > >
+class IntervalTree
+{
+   friend class ::TestInterval; // give unit tests access to the privates
+
+   using Tree = BST<Interval<Point>, Balance, std::less<Interval<Point> >, Allocator, IntervalMax<Point> >;
+   using BNode = typename Tree::BNode;
+public:
+   //
+   // Types
+   //
+
+   using value_type     = Interval<Point>;
+   using allocator_type = Allocator;
+   using size_type      = size_t;
+   using iterator       = typename Tree::iterator;
+
+   //
+   // Construct
+   //
+
+   IntervalTree() { }
+   explicit IntervalTree(const Allocator & alloc) : bst(alloc) { }
+   IntervalTree(const std::initializer_list<value_type> & il)
+   {
+      for (const value_type & interval : il)
+         insert(interval);
+   }
+   void swap(IntervalTree & rhs) { bst.swap(rhs.bst); }
+
+   //
+   // Iterator
+   //
+
+   iterator begin() const noexcept { return bst.begin(); }
+   iterator end()   const noexcept { return bst.end();   }
+
+   //
+   // Overlaps
+   //
+
+   // call f with every interval that overlaps [lo, hi), in order
+   template <class Callback>
+   void overlaps(const Point & lo, const Point & hi, Callback f) const;
+
+   // call f with every interval that contains point, in order
+   template <class Callback>
+   void overlaps(const Point & point, Callback f) const
+   {
+      forEachOverlap(point, point, true /* closed */, [&](const BNode * p) { f(p->data); });
+   }
+
+   // the same, as iterators
+   std::vector<iterator> overlaps(const Point & lo, const Point & hi) const
+   {
+      std::vector<iterator> found;
+      if (lo < hi)
+         forEachOverlap(lo, hi, false /* closed */, [&](BNode * p) { found.push_back(iterator(p, &bst)); });
+      return found;
+   }
+   std::vector<iterator> overlaps(const Point & point) const
+   {
+      std::vector<iterator> found;
+      forEachOverlap(point, point, true /* closed */, [&](BNode * p) { found.push_back(iterator(p, &bst)); });
+      return found;
+   }
+
+   //
+   // Insert and remove
+   //
+
+   iterator insert(const value_type & interval)       { return bst.insert(interval).first; }
+   iterator insert(const Point & start, const Point & end) { return insert(value_type(start, end)); }
+   iterator find(const value_type & interval) const   { return bst.find(interval); }
+   iterator erase(iterator it)                        { return bst.erase(it); }
+   size_t erase(const value_type & interval)
+   {
+      iterator it = bst.find(interval);
+      if (it == end())
+         return 0;
+      bst.erase(it);
+      return 1;
+   }
+   void clear() noexcept { bst.clear(); }
+
+   //
+   // Status
+   //
+
+   bool   empty() const noexcept { return bst.empty(); }
+   size_t size()  const noexcept { return bst.size();  }
+   Allocator get_allocator() const { return bst.get_allocator(); }
+
+private:
+   template <class Visit>
+   void forEachOverlap(const Point & lo, const Point & hi, bool closed, Visit visit) const;
+
+   Tree bst;
+};
+
+/*****************************************************
+ * INTERVAL TREE :: OVERLAPS
+ * Everything that shares a point with [lo, hi)
+ ****************************************************/
+template <class Point, class Balance, class Allocator>
+template <class Callback>
+void IntervalTree <Point, Balance, Allocator> :: overlaps(const Point & lo, const Point & hi, Callback f) const
+{
+   if (lo < hi)
+      forEachOverlap(lo, hi, false /* closed */, [&](const BNode * p) { f(p->data); });
+}
+
+/*****************************************************
+ * INTERVAL TREE :: FOR EACH OVERLAP
+ * An in-order walk that never goes into a subtree whose largest
+ * end is not past lo, and stops at the first start that is not
+ * before hi. With closed, hi itself counts, which is how a single
+ * point is looked up. Each node found is handed to visit.
+ * No recursion: the parents lead the way back. Between two
+ * overlaps the walk may climb and descend the whole height,
+ * so k of them cost O(min(n, k log n)).
+ ****************************************************/
+template <class Point, class Balance, class Allocator>
+template <class Visit>
+void IntervalTree <Point, Balance, Allocator> :: forEachOverlap(
+   const Point & lo, const Point & hi, bool closed, Visit visit) const
+{
+   auto reaches = [&](const BNode * p) { return p && lo < p->maxEnd; };
+   auto startsBefore = [&](const BNode * p) { return closed ? !(hi < p->data.start) : p->data.start < hi; };
+
+   if (!reaches(bst.root))
+      return;
+
+   // the first node of the walk: as far left as the ends allow
+   BNode * p = bst.root;
+   while (reaches(p->pLeft))
+      p = p->pLeft;
+
+   while (p && startsBefore(p))
+   {
+      if (lo < p->data.end)
+         visit(p);
+
+      // next in the walk: down the right, or back up from a left child
+      if (reaches(p->pRight))
+      {
+         p = p->pRight;
+         while (reaches(p->pLeft))
+            p = p->pLeft;
+      }
+      else
+      {
+         while (p->pParent && p->pParent->pRight == p)
+            p = p->pParent;
+         p = p->pParent;
+      }
+   }
+}
+
+/************************************************
+ * SWAP
+ * Swap two interval trees
+ ***********************************************/
+template <class Point, class Balance, class Allocator>
+void swap(IntervalTree<Point, Balance, Allocator> & lhs, IntervalTree<Point, Balance, Allocator> & rhs)
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom
@@ -0,0 +1,465 @@
+/***********************************************************************
+ * Header:
+ *    LEAN
+ * Summary:
+ *    A red-black tree whose nodes have no parent pointer, for large
+ *    indexes that are looked up far more often than walked. A node is
+ *    its element and two links, and the color hides in the lowest bit
+ *    of the left one: with 8-byte elements that is 24 bytes, where a
+ *    BST node takes 40. Whatever would climb back up the tree keeps
+ *    the path it came down instead: insert and erase on the stack,
+ *    and every iterator in a small array of its own. The tree itself
+ *    is the PathTree in pathtree.h.
+ *
+ *    This will contain the class definition of:
+ *        LeanLinks           : Plain children, the color in the left one
+ *        LeanTree            : A set on a red-black tree without parents
+ *        LeanTree::iterator  : An iterator that carries its ancestors
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>    // for assert
+#include <cstddef>    // for size_t and std::ptrdiff_t
+#include <functional> // for std::less
+#include <initializer_list> // for std::initializer_list
+#include <iterator>   // for std::reverse_iterator and the iterator tags
+#include <memory>     // for std::allocator
+#include <utility>    // for std::pair, std::forward and std::move
+#include "balance.h"  // for TaggedLink
+#include "pathtree.h" // for PathTree
+
+class TestLean;    // forward declaration for unit tests
+class TestCompact; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************************************
+ * LEAN LINKS
+ * An element and its children. The color rides along in the left
+ * link, which keeps it through every assignment of a new child.
+ * There are no threads: an empty link is null.
+ *****************************************************************/
+template <class T>
+struct LeanLinks
+{
+   class Node
+   {
+   public:
+      template <class ... Args>
+      explicit Node(Args && ... args) : data(std::forward<Args>(args)...), pRight(nullptr) { }
+
+      T data;                     // user data
+      TaggedLink<Node> pLeft;     // left child, and the color (red when new)
+      Node * pRight;              // right child
+   };
+
+   static const bool oneArray = false;
+   static const bool threads = false;
+
+   // the colors, kept in the tag of the left link: set for black
+   static bool isRed(const Node * pNode) { return pNode && !pNode->pLeft.tag(); }
+   static void paint(Node * pNode, bool red) { pNode->pLeft.tag(!red); }
+
+   static Node * left (const Node * pNode) { return pNode->pLeft.get(); }
+   static Node * right(const Node * pNode) { return pNode->pRight; }
+   static Node * leftThread (const Node * /* pNode */) { return nullptr; }
+   static Node * rightThread(const Node * /* pNode */) { return nullptr; }
+   static void hangLeft (Node * pNode, Node * pChild, Node * /* pThread */) { pNode->pLeft = pChild; }
+   static void hangRight(Node * pNode, Node * pChild, Node * /* pThread */) { pNode->pRight = pChild; }
+};
+
+/************************************************
+ * LEAN TREE
+ * Unique elements in order, like set, on a red-black tree. Nothing
+ * points up, so an iterator is as big as its path (about half a
+ * kilobyte) and begin() costs O(log n); everything else costs what
+ * it does in a BST. Links are pointers unless a Links policy says
+ * otherwise, as the index links of compact.h do.
+ ***********************************************/
+template <class T,
+          class Compare   = std::less<T>,
+          class Allocator = std::allocator<T>,
+          class Links     = LeanLinks<T> >
+class LeanTree : public PathTree <T, Links, Compare, Allocator>
+{
+   friend class ::TestLean;    // give unit tests access to the privates
+   friend class ::TestCompact;
+   template <class Test, template <class ...> class Tree>
+   friend class ::TestPathTree;
+
+   using Base = PathTree <T, Links, Compare, Allocator>;
+   using Node = typename Base::Node;
+public:
+   //
+   // Types
+   //
+
+   class iterator;
+   using reverse_iterator = std::reverse_iterator<iterator>;
+   using Base::maxHeight;
+
+   //
+   // Construct
+   //
+
+   LeanTree() { }
+   explicit LeanTree(const Allocator & alloc) : Base(Compare(), alloc) { }
+   explicit LeanTree(const Compare & comp, const Allocator & alloc = Allocator()) : Base(comp, alloc) { }
+   LeanTree(const LeanTree & rhs) : Base(rhs.compare, rhs.get_allocator()) { this->assign(rhs); }
+   LeanTree(LeanTree && rhs) : Base(rhs.compare, rhs.get_allocator()) { swap(rhs); }
+   LeanTree(const std::initializer_list<T> & il)
+   {
+      for (const T & t : il)
+         insert(t);
+   }
+
+   //
+   // Assign
+   //
+
+   LeanTree & operator = (const LeanTree & rhs)
+   {
+      this->assign(rhs);
+      return *this;
+   }
+   LeanTree & operator = (LeanTree && rhs)
+   {
+      this->clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(LeanTree & rhs) { this->swapTree(rhs); }
+
+   //
+   // Iterator
+   //
+
+   iterator begin() const;
+   iterator end()   const { return iterator(this); }
+   reverse_iterator rbegin() const { return reverse_iterator(end());   }
+   reverse_iterator rend()   const { return reverse_iterator(begin()); }
+
+   //
+   // Access
+   //
+
+   iterator find       (const T & t) const;
+   iterator lower_bound(const T & t) const;
+   iterator upper_bound(const T & t) const;
+   bool   contains(const T & t) const { return find(t) != end(); }
+   size_t count   (const T & t) const { return contains(t) ? 1 : 0; }
+
+   //
+   // Insert
+   //
+
+   std::pair<iterator, bool> insert(const T &  t);
+   std::pair<iterator, bool> insert(      T && t);
+   template <class ... Args>
+   std::pair<iterator, bool> emplace(Args && ... args);
+
+   //
+   // Remove
+   //
+
+   iterator erase(iterator it);
+   size_t   erase(const T & t);
+
+private:
+   iterator link(iterator & it, bool goLeft, Node * pNew);
+};
+
+/**************************************************
+ * LEAN TREE :: ITERATOR
+ * The node it is on and every node above it, root first. At the
+ * end there is nothing on the path at all.
+ *************************************************/
+template <class T, class Compare, class Allocator, class Links>
+class LeanTree <T, Compare, Allocator, Links> :: iterator
+{
+   friend class ::TestLean;    // give unit tests access to the privates
+   friend class ::TestCompact;
+   friend class LeanTree;
+public:
+   // what std algorithms look at to pick their strategy
+   using iterator_category = std::bidirectional_iterator_tag;
+   using value_type        = T;
+   using difference_type   = std::ptrdiff_t;
+   using pointer           = const T *;
+   using reference         = const T &;
+
+   // constructors and assignment. Only the part of the path in use
+   // is copied.
+   iterator() : pTree(nullptr), depth(0) { }
+   iterator(const iterator & rhs) : pTree(rhs.pTree), depth(rhs.depth)
+   {
+      for (int i = 0; i < depth; i++)
+         path[i] = rhs.path[i];
+   }
+   iterator & operator = (const iterator & rhs)
+   {
+      pTree = rhs.pTree;
+      depth = rhs.depth;
+      for (int i = 0; i < depth; i++)
+         path[i] = rhs.path[i];
+      return *this;
+   }
+
+   // compare
+   bool operator == (const iterator & rhs) const { return current() == rhs.current(); }
+   bool operator != (const iterator & rhs) const { return current() != rhs.current(); }
+
+   // de-reference. Cannot change because it will invalidate the tree
+   const T & operator * () const { return current()->data; }
+   const T * operator -> () const { return &current()->data; }
+
+   // increment and decrement
+   iterator & operator ++ ();
+   iterator & operator -- ();
+   iterator   operator ++ (int)
+   {
+      iterator itOld(*this);
+      ++*this;
+      return itOld;
+   }
+   iterator   operator -- (int)
+   {
+      iterator itOld(*this);
+      --*this;
+      return itOld;
+   }
+
+private:
+   explicit iterator(const LeanTree * pTree) : pTree(pTree), depth(0) { }
+
+   Node * current() const { return depth ? path[depth - 1] : nullptr; }
+   void push(Node * pNode)
+   {
+      assert(depth < maxHeight);
+      path[depth++] = pNode;
+   }
+
+   const LeanTree * pTree;     // the tree, to find the way back from the end
+   Node * path[maxHeight];     // the root, down to the current node
+   int depth;                  // how much of path is in use
+};
+
+/*********************************************
+ * LEAN TREE :: ITERATOR :: INCREMENT PREFIX
+ * The leftmost node of the right subtree, or else the first
+ * ancestor we are to the left of
+ ********************************************/
+template <class T, class Compare, class Allocator, class Links>
+typename LeanTree <T, Compare, Allocator, Links> :: iterator & LeanTree <T, Compare, Allocator, Links> :: iterator :: operator ++ ()
+{
+   assert(depth > 0);
+   Node * pNode = path[depth - 1];
+   if (Links::right(pNode))
+   {
+      for (pNode = Links::right(pNode); pNode; pNode = Links::left(pNode))
+         push(pNode);
+   }
+   else
+   {
+      // off the path until we come up from a left child
+      Node * pFrom = path[--depth];
+      while (depth && Links::right(path[depth - 1]) == pFrom)
+         pFrom = path[--depth];
+   }
+   return *this;
+}
+
+/*********************************************
+ * LEAN TREE :: ITERATOR :: DECREMENT PREFIX
+ * The mirror image of increment, except that the end comes back
+ * to the largest element
+ ********************************************/
+template <class T, class Compare, class Allocator, class Links>
+typename LeanTree <T, Compare, Allocator, Links> :: iterator & LeanTree <T, Compare, Allocator, Links> :: iterator :: operator -- ()
+{
+   if (depth == 0)
+   {
+      // the rightmost node of the whole tree
+      for (Node * pNode = pTree->root; pNode; pNode = Links::right(pNode))
+         push(pNode);
+   }
+   else if (Links::left(path[depth - 1]))
+   {
+      // the rightmost node of the left subtree
+      for (Node * pNode = Links::left(path[depth - 1]); pNode; pNode = Links::right(pNode))
+         push(pNode);
+   }
+   else
+   {
+      // off the path until we come up from a right child
+      Node * pFrom = path[--depth];
+      while (depth && Links::left(path[depth - 1]) == pFrom)
+         pFrom = path[--depth];
+   }
+   return *this;
+}
+
+/*********************************************
+ * LEAN TREE :: BEGIN
+ * All the way down the left
+ ********************************************/
+template <class T, class Compare, class Allocator, class Links>
+typename LeanTree <T, Compare, Allocator, Links> :: iterator LeanTree <T, Compare, Allocator, Links> :: begin() const
+{
+   iterator it(this);
+   for (Node * p = this->root; p; p = this->left(p))
+      it.push(p);
+   return it;
+}
+
+/*********************************************
+ * LEAN TREE :: LOWER BOUND
+ * The path goes all the way down, then is cut back to the last
+ * node we went left at
+ ********************************************/
+template <class T, class Compare, class Allocator, class Links>
+typename LeanTree <T, Compare, Allocator, Links> :: iterator LeanTree <T, Compare, Allocator, Links> :: lower_bound(const T & t) const
+{
+   iterator it(this);
+   int found = 0;
+   this->lowerBoundNode(t, [&](Node * p, bool bound)
+   {
+      it.push(p);
+      if (bound)
+         found = it.depth;
+   });
+   it.depth = found;
+   return it;
+}
+
+/*********************************************
+ * LEAN TREE :: UPPER BOUND
+ * The same, for the first element after t
+ ********************************************/
+template <class T, class Compare, class Allocator, class Links>
+typename LeanTree <T, Compare, Allocator, Links> :: iterator LeanTree <T, Compare, Allocator, Links> :: upper_bound(const T & t) const
+{
+   iterator it(this);
+   int found = 0;
+   this->upperBoundNode(t, [&](Node * p, bool bound)
+   {
+      it.push(p);
+      if (bound)
+         found = it.depth;
+   });
+   it.depth = found;
+   return it;
+}
+
+/*********************************************
+ * LEAN TREE :: FIND
+ * The lower bound, if it is not after t
+ ********************************************/
+template <class T, class Compare, class Allocator, class Links>
+typename LeanTree <T, Compare, Allocator, Links> :: iterator LeanTree <T, Compare, Allocator, Links> :: find(const T & t) const
+{
+   iterator it = lower_bound(t);
+   if (it.depth && this->compare(t, *it))
+      it.depth = 0;
+   return it;
+}
+
+/*********************************************
+ * LEAN TREE :: INSERT
+ * Nothing is copied if the element is already there
+ ********************************************/
+template <class T, class Compare, class Allocator, class Links>
+std::pair<typename LeanTree <T, Compare, Allocator, Links> :: iterator, bool> LeanTree <T, Compare, Allocator, Links> :: insert(const T & t)
+{
+   iterator it(this);
+   bool goLeft;
+   if (this->locate(t, it.path, it.depth, goLeft))
+      return std::make_pair(it, false);
+   return std::make_pair(link(it, goLeft, this->make(it.path, it.depth, t)), true);
+}
+
+template <class T, class Compare, class Allocator, class Links>
+std::pair<typename LeanTree <T, Compare, Allocator, Links> :: iterator, bool> LeanTree <T, Compare, Allocator, Links> :: insert(T && t)
+{
+   iterator it(this);
+   bool goLeft;
+   if (this->locate(t, it.path, it.depth, goLeft))
+      return std::make_pair(it, false);
+   return std::make_pair(link(it, goLeft, this->make(it.path, it.depth, std::move(t))), true);
+}
+
+/*********************************************
+ * LEAN TREE :: EMPLACE
+ * The element has to be built to be compared, so a repeat is
+ * built and then dropped
+ ********************************************/
+template <class T, class Compare, class Allocator, class Links>
+template <class ... Args>
+std::pair<typename LeanTree <T, Compare, Allocator, Links> :: iterator, bool> LeanTree <T, Compare, Allocator, Links> :: emplace(Args && ... args)
+{
+   Node * pNew = this->make(nullptr, 0, std::forward<Args>(args)...);
+   iterator it(this);
+   bool goLeft;
+   if (this->locate(pNew->data, it.path, it.depth, goLeft))
+   {
+      this->pool.destroy(pNew);
+      return std::make_pair(it, false);
+   }
+   return std::make_pair(link(it, goLeft, pNew), true);
+}
+
+/*********************************************
+ * LEAN TREE :: LINK
+ * The path the new node comes back with is the iterator, so there
+ * is no second search
+ ********************************************/
+template <class T, class Compare, class Allocator, class Links>
+typename LeanTree <T, Compare, Allocator, Links> :: iterator LeanTree <T, Compare, Allocator, Links> :: link(iterator & it, bool goLeft, Node * pNew)
+{
+   int depth = it.depth;
+   Base::link(it.path, depth, goLeft, pNew);
+   it.depth = depth + 1;
+   return it;
+}
+
+/*********************************************
+ * LEAN TREE :: ERASE
+ * Erase by iterator hands back the next one. The path it came
+ * with does the work the parents would, but the rotations may
+ * move the next node, so it is found again by its element.
+ ********************************************/
+template <class T, class Compare, class Allocator, class Links>
+typename LeanTree <T, Compare, Allocator, Links> :: iterator LeanTree <T, Compare, Allocator, Links> :: erase(iterator it)
+{
+   assert(it.depth > 0);
+   iterator itNext = it;
+   ++itNext;
+   this->remove(it.path, it.depth - 1);
+   return itNext.depth ? lower_bound(*itNext) : end();
+}
+
+template <class T, class Compare, class Allocator, class Links>
+size_t LeanTree <T, Compare, Allocator, Links> :: erase(const T & t)
+{
+   iterator it = find(t);
+   if (it.depth == 0)
+      return 0;
+   this->remove(it.path, it.depth - 1);
+   return 1;
+}
+
+/************************************************
+ * SWAP
+ * Swap two lean trees
+ ***********************************************/
+template <class T, class Compare, class Allocator, class Links>
+void swap(LeanTree<T, Compare, Allocator, Links> & lhs, LeanTree<T, Compare, Allocator, Links> & rhs)
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom
@@ -0,0 +1,371 @@
+/***********************************************************************
+ * Header:
+ *    MAP
+ * Summary:
+ *    Our custom implementation of std::map, on top of our BST. The tree
+ *    holds the key-value pairs but only ever compares the keys.
+ *
+ *    This will contain the class definition of:
+ *        map                 : A class that maps unique keys to values
+ *        map::iterator       : An iterator through a map
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <functional> // for std::less
+#include <initializer_list> // for std::initializer_list
+#include <iterator>   // for std::reverse_iterator and the iterator tags
+#include <memory>     // for std::allocator
+#include <stdexcept>  // for std::out_of_range
+#include <tuple>      // for std::forward_as_tuple
+#include <type_traits> // for std::conditional and std::enable_if
+#include <utility>    // for std::pair and std::piecewise_construct
+#include "bst.h"      // for BST
+
+class TestMap; // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * MAP
+ * Unique keys, each with a value, kept in key order. The balancing
+ * policy comes last so the rest reads like std::map.
+ ***********************************************/
+template <class K,
+          class V,
+          class Compare   = std::less<K>,
+          class Allocator = std::allocator<std::pair<const K, V> >,
+          class Balance   = RedBlack>
+class map
+{
+   friend class ::TestMap; // give unit tests access to the privates
+public:
+   //
+   // Types
+   //
+
+   using key_type       = K;
+   using mapped_type    = V;
+   using value_type     = std::pair<const K, V>;
+   using key_compare    = Compare;
+   using allocator_type = Allocator;
+   using size_type      = size_t;
+
+private:
+   /******************************************
+    * KEY COMPARE
+    * Pull the key out of a pair (or take a bare key as it is) and
+    * compare only that. Being transparent is what lets the tree look
+    * for a bare key without building a pair around it.
+    ******************************************/
+   class KeyCompare
+   {
+   public:
+      using is_transparent = void;
+
+      KeyCompare(const Compare & comp = Compare()) : comp(comp) { }
+
+      template <class A, class B>
+      auto operator () (const A & lhs, const B & rhs) const
+         -> decltype(std::declval<const Compare &>()(std::declval<const K &>(), std::declval<const K &>()))
+      {
+         return comp(keyOf(lhs), keyOf(rhs));
+      }
+
+      Compare comp;
+   private:
+      static const K & keyOf(const value_type & value) { return value.first; }
+      static const K & keyOf(const K & key)            { return key;         }
+   };
+
+   using Tree = BST<value_type, Balance, KeyCompare, Allocator>;
+
+   template <bool isConst>
+   class Iterator;
+
+public:
+   using iterator       = Iterator<false>;
+   using const_iterator = Iterator<true>;
+   using reverse_iterator       = std::reverse_iterator<iterator>;
+   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+   //
+   // Construct
+   //
+
+   map() { }
+   explicit map(const Compare & comp, const Allocator & alloc = Allocator()) : bst(KeyCompare(comp), alloc) { }
+   explicit map(const Allocator & alloc) : bst(alloc) { }
+   map(const std::initializer_list<value_type> & il) { insert(il.begin(), il.end()); }
+   template <class InputIt>
+   map(InputIt first, InputIt last) { insert(first, last); }
+
+   map & operator = (const std::initializer_list<value_type> & il)
+   {
+      clear();
+      insert(il.begin(), il.end());
+      return *this;
+   }
+   void swap(map & rhs) { bst.swap(rhs.bst); }
+
+   //
+   // Iterator
+   //
+
+   iterator       begin()       noexcept { return iterator(bst.begin());       }
+   iterator       end()         noexcept { return iterator(bst.end());         }
+   const_iterator begin() const noexcept { return const_iterator(bst.begin()); }
+   const_iterator end()   const noexcept { return const_iterator(bst.end());   }
+   reverse_iterator       rbegin()       noexcept { return reverse_iterator(end());         }
+   reverse_iterator       rend()         noexcept { return reverse_iterator(begin());       }
+   const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end());   }
+   const_reverse_iterator rend()   const noexcept { return const_reverse_iterator(begin()); }
+
+   //
+   // Access
+   //
+
+   V & operator [] (const K &  key) { return try_emplace(key).first->second;            }
+   V & operator [] (      K && key) { return try_emplace(std::move(key)).first->second; }
+   V & at(const K & key);
+   const V & at(const K & key) const;
+
+   iterator       find(const K & key)       { return iterator(bst.find(key));       }
+   const_iterator find(const K & key) const { return const_iterator(bst.find(key)); }
+   iterator       find_and_splay(const K & key) { return iterator(bst.find_and_splay(key)); }
+   size_t count(const K & key)    const { return bst.count(key);    }
+   bool   contains(const K & key) const { return bst.contains(key); }
+   iterator lower_bound(const K & key) { return iterator(bst.lower_bound(key)); }
+   iterator upper_bound(const K & key) { return iterator(bst.upper_bound(key)); }
+   std::pair<iterator, iterator> equal_range(const K & key)
+   {
+      auto range = bst.equal_range(key);
+      return std::make_pair(iterator(range.first), iterator(range.second));
+   }
+
+   //
+   // Insert
+   //
+
+   std::pair<iterator, bool> insert(const value_type &  value) { return wrap(bst.insert(value, true /* keepUnique */)); }
+   std::pair<iterator, bool> insert(      value_type && value) { return wrap(bst.insert(std::move(value), true /* keepUnique */)); }
+   iterator insert(const_iterator hint, const value_type &  value) { return iterator(bst.insert(hint.it, value, true /* keepUnique */)); }
+   iterator insert(const_iterator hint,       value_type && value) { return iterator(bst.insert(hint.it, std::move(value), true /* keepUnique */)); }
+   template <class InputIt>
+   void insert(InputIt first, InputIt last)
+   {
+      for (; first != last; ++first)
+         insert(*first);
+   }
+
+   // the pair is built in its node, then dropped again if the key is there
+   template <class ... Args>
+   std::pair<iterator, bool> emplace(Args && ... args)
+   {
+      auto result = bst.emplaceNode(true /* keepUnique */, false, nullptr, std::forward<Args>(args)...);
+      return std::make_pair(iterator(typename Tree::iterator(result.first, &bst)), result.second);
+   }
+   template <class ... Args>
+   iterator emplace_hint(const_iterator hint, Args && ... args)
+   {
+      return iterator(typename Tree::iterator(
+         bst.emplaceNode(true /* keepUnique */, true, hint.it.pNode, std::forward<Args>(args)...).first, &bst));
+   }
+
+   // the value is only built, from args, when the key is not there yet
+   template <class ... Args>
+   std::pair<iterator, bool> try_emplace(const K &  key, Args && ... args)
+   {
+      return tryEmplace(key, std::forward<Args>(args)...);
+   }
+   template <class ... Args>
+   std::pair<iterator, bool> try_emplace(      K && key, Args && ... args)
+   {
+      return tryEmplace(std::move(key), std::forward<Args>(args)...);
+   }
+
+   // assign to the value if the key is there, insert it otherwise
+   template <class M>
+   std::pair<iterator, bool> insert_or_assign(const K &  key, M && obj)
+   {
+      return insertOrAssign(key, std::forward<M>(obj));
+   }
+   template <class M>
+   std::pair<iterator, bool> insert_or_assign(      K && key, M && obj)
+   {
+      return insertOrAssign(std::move(key), std::forward<M>(obj));
+   }
+
+   //
+   // Remove
+   //
+
+   iterator erase(iterator it)
+   {
+      return iterator(bst.erase(it.it));
+   }
+   size_t erase(const K & key)
+   {
+      typename Tree::iterator it = bst.find(key);
+      if (it == bst.end())
+         return 0;
+      bst.erase(it);
+      return 1;
+   }
+   void clear() noexcept { bst.clear(); }
+
+   //
+   // Status
+   //
+
+   bool   empty() const noexcept { return bst.empty(); }
+   size_t size()  const noexcept { return bst.size();  }
+   Compare   key_comp()      const { return bst.key_comp().comp; }
+   Allocator get_allocator() const { return bst.get_allocator();  }
+
+private:
+   template <class KK, class ... Args>
+   std::pair<iterator, bool> tryEmplace(KK && key, Args && ... args);
+   template <class KK, class M>
+   std::pair<iterator, bool> insertOrAssign(KK && key, M && obj);
+
+   static std::pair<iterator, bool> wrap(const std::pair<typename Tree::iterator, bool> & result)
+   {
+      return std::make_pair(iterator(result.first), result.second);
+   }
+
+   Tree bst;
+};
+
+/**********************************************************
+ * MAP ITERATOR
+ * The tree only hands out its elements as const, because changing
+ * one could break the order. Here only the value can change, since
+ * the key is const in the pair, so it is safe to hand it out.
+ *********************************************************/
+template <class K, class V, class Compare, class Allocator, class Balance>
+template <bool isConst>
+class map <K, V, Compare, Allocator, Balance> :: Iterator
+{
+   friend class map;
+   friend class Iterator<!isConst>;
+   friend class ::TestMap;
+public:
+   using iterator_category = std::bidirectional_iterator_tag;
+   using value_type        = typename map::value_type;
+   using difference_type   = std::ptrdiff_t;
+   using reference = typename std::conditional<isConst, const value_type &, value_type &>::type;
+   using pointer   = typename std::conditional<isConst, const value_type *, value_type *>::type;
+
+   Iterator() { }
+   Iterator(const typename Tree::iterator & it) : it(it) { }
+   // an iterator can become a const_iterator, but not the other way around
+   template <bool wasConst, class = typename std::enable_if<isConst && !wasConst>::type>
+   Iterator(const Iterator<wasConst> & rhs) : it(rhs.it) { }
+
+   // compare
+   bool operator == (const Iterator & rhs) const { return it == rhs.it; }
+   bool operator != (const Iterator & rhs) const { return it != rhs.it; }
+
+   // de-reference
+   reference operator * () const { return const_cast<reference>(*it); }
+   pointer   operator -> () const { return &**this; }
+
+   // increment and decrement
+   Iterator & operator ++ ()
+   {
+      ++it;
+      return *this;
+   }
+   Iterator operator ++ (int)
+   {
+      Iterator itOld(*this);
+      ++it;
+      return itOld;
+   }
+   Iterator & operator -- ()
+   {
+      --it;
+      return *this;
+   }
+   Iterator operator -- (int)
+   {
+      Iterator itOld(*this);
+      --it;
+      return itOld;
+   }
+
+private:
+   typename Tree::iterator it;
+};
+
+/*****************************************************
+ * MAP :: AT
+ * The value for key, which had better be there
+ ****************************************************/
+template <class K, class V, class Compare, class Allocator, class Balance>
+V & map <K, V, Compare, Allocator, Balance> :: at(const K & key)
+{
+   typename Tree::iterator it = bst.find(key);
+   if (it == bst.end())
+      throw std::out_of_range("custom::map::at: no such key");
+   return iterator(it)->second;
+}
+
+template <class K, class V, class Compare, class Allocator, class Balance>
+const V & map <K, V, Compare, Allocator, Balance> :: at(const K & key) const
+{
+   typename Tree::iterator it = bst.find(key);
+   if (it == bst.end())
+      throw std::out_of_range("custom::map::at: no such key");
+   return it->second;
+}
+
+/*****************************************************
+ * MAP :: TRY EMPLACE
+ * Look for the key alone. Only when it is missing is the pair
+ * built, right in its node, from the key and args.
+ ****************************************************/
+template <class K, class V, class Compare, class Allocator, class Balance>
+template <class KK, class ... Args>
+std::pair<typename map <K, V, Compare, Allocator, Balance> :: iterator, bool>
+map <K, V, Compare, Allocator, Balance> :: tryEmplace(KK && key, Args && ... args)
+{
+   auto result = bst.emplaceUnique(key,
+                                   std::piecewise_construct,
+                                   std::forward_as_tuple(std::forward<KK>(key)),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+   return std::make_pair(iterator(typename Tree::iterator(result.first, &bst)), result.second);
+}
+
+/*****************************************************
+ * MAP :: INSERT OR ASSIGN
+ * obj is only used once: either it builds the new value
+ * or it is assigned to the old one
+ ****************************************************/
+template <class K, class V, class Compare, class Allocator, class Balance>
+template <class KK, class M>
+std::pair<typename map <K, V, Compare, Allocator, Balance> :: iterator, bool>
+map <K, V, Compare, Allocator, Balance> :: insertOrAssign(KK && key, M && obj)
+{
+   std::pair<iterator, bool> result = tryEmplace(std::forward<KK>(key), std::forward<M>(obj));
+   if (!result.second)
+      result.first->second = std::forward<M>(obj);
+   return result;
+}
+
+/************************************************
+ * SWAP
+ * Swap two maps
+ ***********************************************/
+template <class K, class V, class Compare, class Allocator, class Balance>
+void swap(map<K, V, Compare, Allocator, Balance> & lhs, map<K, V, Compare, Allocator, Balance> & rhs)
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom
@@ -0,0 +1,72 @@
+/***********************************************************************
+ * Header:
+ *    PARALLEL
+ * Summary:
+ *    Threads for the set algebra of the BST. Without this header the
+ *    BST works out both halves of a union, intersection or difference
+ *    on the calling thread (Serial in bst.h), and never pulls in the
+ *    threading headers. Pass Parallel to work on large trees with
+ *    several threads:
+ *        auto bstBoth = set_union(bstLeft, bstRight, custom::Parallel());
+ *        bstLeft.intersect(bstRight, custom::Parallel());
+ *    Like Serial, it gives:
+ *        forksFor()          : how many levels of halves get threads
+ *                              of their own, given the smaller tree
+ *        both()              : run two halves, maybe at the same time
+ *
+ *    This will contain the class definition of:
+ *        Parallel            : Halves on threads of their own
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>      // for size_t
+#include <future>       // for std::async
+#include <system_error> // for std::system_error
+#include <thread>       // for std::thread::hardware_concurrency
+
+namespace custom
+{
+
+/*****************************************************************
+ * PARALLEL
+ * The left half goes to a thread of its own while this thread
+ * does the right
+ *****************************************************************/
+struct Parallel
+{
+   // enough levels for one thread per core, and none if the smaller
+   // tree is too small for a thread to pay for itself
+   static int forksFor(size_t numSmaller)
+   {
+      if (numSmaller < 4096)
+         return 0;
+      int forks = 0;
+      for (unsigned int cores = std::thread::hardware_concurrency(); cores > 1; cores = (cores + 1) / 2)
+         forks++;
+      return forks;
+   }
+
+   // run left() and right(). With no thread to be had, both run here.
+   template <class Left, class Right>
+   static void both(Left left, Right right)
+   {
+      std::future<void> future;
+      try
+      {
+         future = std::async(std::launch::async, left);
+      }
+      catch (const std::system_error &)
+      {
+         left();
+         right();
+         return;
+      }
+      right();
+      future.get();
+   }
+};
+
+} // namespace custom
@@ -0,0 +1,642 @@
+/***********************************************************************
+ * Header:
+ *    PATH TREE
+ * Summary:
+ *    The red-black tree under LeanTree and ThreadedTree. Neither has
+ *    parent pointers, so whatever would climb back up the tree keeps
+ *    the path it came down instead, and the insert and erase fixups
+ *    are told what is above a node rather than look it up. How a node
+ *    holds its children, and its color, is up to a Links policy:
+ *        Node                : an element and two links
+ *        threads             : do empty links point to the neighbors?
+ *        left(), right()     : a child, or nullptr if there is none
+ *        leftThread(),
+ *        rightThread()       : where an empty link points, if anywhere
+ *        hangLeft(),
+ *        hangRight()         : give a node a child, or else a thread
+ *        isRed(), paint()    : the color
+ *        oneArray            : are the links indices into one array?
+ *
+ *    This will contain the class definition of:
+ *        PathTree            : A red-black tree without parents
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>    // for assert
+#include <cstddef>    // for size_t
+#include <functional> // for std::less
+#include <memory>     // for std::allocator
+#include <type_traits> // for std::is_trivially_destructible and std::conditional
+#include <utility>    // for std::forward and std::swap
+#include "pool.h"     // for NodePool and ArrayPool
+
+template <class Test, template <class ...> class Tree>
+class TestPathTree; // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * PATH TREE
+ * Unique elements in order on a red-black tree, for the containers
+ * built on it to put their iterators on. Everything here works on a
+ * path: path[0] is the root and each node after it is a child of
+ * the one before.
+ ***********************************************/
+template <class T, class Links, class Compare = std::less<T>, class Allocator = std::allocator<T> >
+class PathTree
+{
+   template <class Test, template <class ...> class Tree>
+   friend class ::TestPathTree; // give unit tests access to the privates
+
+public:
+   //
+   // Types
+   //
+
+   using value_type     = T;
+   using key_compare    = Compare;
+   using allocator_type = Allocator;
+   using size_type      = size_t;
+
+   // the deepest a red-black tree of fewer than 2^32 elements goes
+   static const int maxHeight = 64;
+
+   //
+   // Remove
+   //
+
+   void clear() noexcept;
+
+   //
+   // Status
+   //
+
+   bool   empty() const noexcept { return numElements == 0; }
+   size_t size()  const noexcept { return numElements;      }
+   Compare key_comp() const { return compare; }
+   Allocator get_allocator() const { return pool.get_allocator(); }
+
+protected:
+   using Node = typename Links::Node;
+   using Pool = typename std::conditional<Links::oneArray,
+                                          ArrayPool<Node, Allocator>,
+                                          NodePool <Node, Allocator> >::type;
+
+   PathTree() : root(nullptr), numElements(0) { }
+   explicit PathTree(const Compare & comp, const Allocator & alloc) :
+      root(nullptr), numElements(0), compare(comp), pool(alloc) { }
+   PathTree(const PathTree &) = delete;
+   PathTree & operator = (const PathTree &) = delete;
+   ~PathTree() { clear(); }
+
+   void assign(const PathTree & rhs);
+   void swapTree(PathTree & rhs)
+   {
+      std::swap(root, rhs.root);
+      std::swap(numElements, rhs.numElements);
+      std::swap(compare, rhs.compare);
+      pool.swap(rhs.pool);
+   }
+
+   // the way down to the bounds: visit(p, bound) sees every node the
+   // search goes through, and whether it is the best bound so far
+   template <class Visit> Node * lowerBoundNode(const T & t, Visit visit) const;
+   template <class Visit> Node * upperBoundNode(const T & t, Visit visit) const;
+
+   bool locate(const T & t, Node ** path, int & depth, bool & goLeft) const;
+   template <class ... Args>
+   Node * make(Node ** path, int depth, Args && ... args)
+   {
+      return make(std::integral_constant<bool, Links::oneArray>(), path, depth, std::forward<Args>(args)...);
+   }
+   void link(Node ** path, int & depth, bool goLeft, Node * pNew);
+   void remove(Node ** path, int depth);
+
+   // restructuring, with whatever is above told rather than looked up
+   void relink(Node * pAbove, Node * pOld, Node * pNew);
+   void lift(Node * pNode, Node * pParent, Node * pAbove);
+   void insertFixup(Node ** path, int & depth);
+   void eraseFixup(Node ** path, int depth, bool fromLeft);
+
+   void copyChildren(Node * pDest, const Node * pSrc, Node * pPrev, Node * pNext);
+   void destroyAll(Node * pNode) noexcept;
+
+   template <class ... Args>
+   Node * make(std::false_type, Node ** /* path */, int /* depth */, Args && ... args)
+   {
+      return pool.create(std::forward<Args>(args)...);
+   }
+   template <class ... Args>
+   Node * make(std::true_type, Node ** path, int depth, Args && ... args);
+
+   static bool isRed(const Node * pNode) { return Links::isRed(pNode); }
+   static void paint(Node * pNode, bool red) { Links::paint(pNode, red); }
+   static Node * left (const Node * pNode) { return Links::left(pNode);  }
+   static Node * right(const Node * pNode) { return Links::right(pNode); }
+
+   Node * root;                   // root node of the tree
+   size_t numElements;            // number of elements currently in the tree
+   Compare compare;               // the ordering of the elements
+   Pool pool;                     // where every node of this tree lives
+};
+
+/*********************************************
+ * PATH TREE :: ASSIGN
+ * The same shape and colors as rhs, node for node, with any
+ * threads pointing into the copy
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+void PathTree <T, Links, Compare, Allocator> :: assign(const PathTree & rhs)
+{
+   if (this == &rhs)
+      return;
+   clear();
+   compare = rhs.compare;
+   if (rhs.root)
+   {
+      try
+      {
+         pool.reserve(rhs.numElements);
+         root = pool.create(rhs.root->data);
+         paint(root, isRed(rhs.root));
+         copyChildren(root, rhs.root, nullptr, nullptr);
+      }
+      catch (...)
+      {
+         clear();
+         throw;
+      }
+   }
+   numElements = rhs.numElements;
+}
+
+/*********************************************
+ * PATH TREE :: COPY CHILDREN
+ * pPrev and pNext are the copies of the nodes just before and just
+ * after pSrc's subtree, where its threads out of it go. Every node
+ * is hung in place as soon as it is made, so that clear() finds it
+ * if a later one throws.
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+void PathTree <T, Links, Compare, Allocator> :: copyChildren(Node * pDest, const Node * pSrc, Node * pPrev, Node * pNext)
+{
+   if (Node * pLeft = left(pSrc))
+   {
+      Node * pCopy = pool.create(pLeft->data);
+      paint(pCopy, isRed(pLeft));
+      Links::hangLeft(pDest, pCopy, nullptr);
+      copyChildren(pCopy, pLeft, pPrev, pDest);
+   }
+   else
+      Links::hangLeft(pDest, nullptr, pPrev);
+
+   if (Node * pRight = right(pSrc))
+   {
+      Node * pCopy = pool.create(pRight->data);
+      paint(pCopy, isRed(pRight));
+      Links::hangRight(pDest, pCopy, nullptr);
+      copyChildren(pCopy, pRight, pDest, pNext);
+   }
+   else
+      Links::hangRight(pDest, nullptr, pNext);
+}
+
+/*********************************************
+ * PATH TREE :: CLEAR
+ * The destructors only need to run if they do something. Either
+ * way, the memory goes back a whole chunk at a time.
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+void PathTree <T, Links, Compare, Allocator> :: clear() noexcept
+{
+   if (!std::is_trivially_destructible<Node>::value)
+      destroyAll(root);
+   root = nullptr;
+   pool.release();
+   numElements = 0;
+}
+
+template <class T, class Links, class Compare, class Allocator>
+void PathTree <T, Links, Compare, Allocator> :: destroyAll(Node * pNode) noexcept
+{
+   if (pNode)
+   {
+      destroyAll(left(pNode));
+      destroyAll(right(pNode));
+      pool.destroy(pNode);
+   }
+}
+
+/*********************************************
+ * PATH TREE :: LOWER BOUND NODE
+ * The first element not before t: the last node we went left at
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+template <class Visit>
+typename PathTree <T, Links, Compare, Allocator> :: Node * PathTree <T, Links, Compare, Allocator> :: lowerBoundNode(
+   const T & t, Visit visit) const
+{
+   Node * pFound = nullptr;
+   for (Node * p = root; p; )
+   {
+      bool bound = !compare(p->data, t);
+      visit(p, bound);
+      if (bound)
+      {
+         pFound = p;
+         p = left(p);
+      }
+      else
+         p = right(p);
+   }
+   return pFound;
+}
+
+/*********************************************
+ * PATH TREE :: UPPER BOUND NODE
+ * The first element after t
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+template <class Visit>
+typename PathTree <T, Links, Compare, Allocator> :: Node * PathTree <T, Links, Compare, Allocator> :: upperBoundNode(
+   const T & t, Visit visit) const
+{
+   Node * pFound = nullptr;
+   for (Node * p = root; p; )
+   {
+      bool bound = compare(t, p->data);
+      visit(p, bound);
+      if (bound)
+      {
+         pFound = p;
+         p = left(p);
+      }
+      else
+         p = right(p);
+   }
+   return pFound;
+}
+
+/*********************************************
+ * PATH TREE :: LOCATE
+ * Go down to where t belongs, recording the way in path[0] up to
+ * path[depth - 1]. If t is already there, the path is cut back to
+ * it and we say so. Otherwise goLeft says which side of the last
+ * node it goes.
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+bool PathTree <T, Links, Compare, Allocator> :: locate(const T & t, Node ** path, int & depth, bool & goLeft) const
+{
+   int found = 0;
+   depth = 0;
+   lowerBoundNode(t, [&](Node * p, bool bound)
+   {
+      assert(depth < maxHeight);
+      path[depth++] = p;
+      if (bound)
+         found = depth;
+   });
+   if (found && !compare(t, path[found - 1]->data))
+   {
+      depth = found;
+      return true;
+   }
+   goLeft = depth && found == depth;
+   return false;
+}
+
+/*********************************************
+ * PATH TREE :: MAKE
+ * A new node, for link() to hang below path[depth - 1]. Where the
+ * nodes are in one array, making one may move them all, so the root
+ * and the path are held by index until it is done.
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+template <class ... Args>
+typename PathTree <T, Links, Compare, Allocator> :: Node * PathTree <T, Links, Compare, Allocator> :: make(
+   std::true_type, Node ** path, int depth, Args && ... args)
+{
+   if (!pool.full())
+      return pool.create(std::forward<Args>(args)...);
+
+   size_t indices[maxHeight];
+   size_t iRoot = root ? pool.indexOf(root) : 0;
+   for (int i = 0; i < depth; i++)
+      indices[i] = pool.indexOf(path[i]);
+   Node * pNew = pool.create(std::forward<Args>(args)...);
+   if (root)
+      root = pool.at(iRoot);
+   for (int i = 0; i < depth; i++)
+      path[i] = pool.at(indices[i]);
+   return pNew;
+}
+
+/*********************************************
+ * PATH TREE :: LINK
+ * Hang a new node below path[depth - 1] and rebalance. The new
+ * node takes over the thread its parent had on that side, and
+ * threads back to its parent on the other. The path follows the
+ * new node through the rotations, so path[depth] is pNew after.
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+void PathTree <T, Links, Compare, Allocator> :: link(Node ** path, int & depth, bool goLeft, Node * pNew)
+{
+   assert(depth < maxHeight);
+   if (depth == 0)
+      root = pNew;
+   else
+   {
+      Node * pParent = path[depth - 1];
+      if (goLeft)
+      {
+         Links::hangLeft(pNew, nullptr, Links::leftThread(pParent));
+         Links::hangRight(pNew, nullptr, pParent);
+         Links::hangLeft(pParent, pNew, nullptr);
+      }
+      else
+      {
+         Links::hangLeft(pNew, nullptr, pParent);
+         Links::hangRight(pNew, nullptr, Links::rightThread(pParent));
+         Links::hangRight(pParent, pNew, nullptr);
+      }
+   }
+   path[depth] = pNew;
+   numElements++;
+
+   insertFixup(path, depth);
+   paint(root, false /* red */);
+}
+
+/*********************************************
+ * PATH TREE :: RELINK
+ * Put pNew where pOld was below pAbove, or at the root
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+void PathTree <T, Links, Compare, Allocator> :: relink(Node * pAbove, Node * pOld, Node * pNew)
+{
+   if (!pAbove)
+      root = pNew;
+   else if (left(pAbove) == pOld)
+      Links::hangLeft(pAbove, pNew, nullptr);
+   else
+      Links::hangRight(pAbove, pNew, nullptr);
+}
+
+/*********************************************
+ * PATH TREE :: LIFT
+ * Rotate pNode up into the place of its parent, which hangs from
+ * pAbove. The colors stay with their nodes. If pNode had no
+ * child between the two, the parent gets a thread to pNode there.
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+void PathTree <T, Links, Compare, Allocator> :: lift(Node * pNode, Node * pParent, Node * pAbove)
+{
+   if (left(pParent) == pNode)
+   {
+      Links::hangLeft(pParent, right(pNode), pNode);
+      Links::hangRight(pNode, pParent, nullptr);
+   }
+   else
+   {
+      Links::hangRight(pParent, left(pNode), pNode);
+      Links::hangLeft(pNode, pParent, nullptr);
+   }
+   relink(pAbove, pParent, pNode);
+}
+
+/*********************************************
+ * PATH TREE :: INSERT FIXUP
+ * The red-black insert fixup, with the path standing in for the
+ * parents. path[depth] is the new node; when the rotations take
+ * ancestors off its path, they come off the array too.
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+void PathTree <T, Links, Compare, Allocator> :: insertFixup(Node ** path, int & depth)
+{
+   int i = depth;
+   while (i >= 2 && isRed(path[i - 1]))
+   {
+      Node * pNode   = path[i];
+      Node * pParent = path[i - 1];
+      Node * pGranny = path[i - 2];
+      Node * pAbove  = i >= 3 ? path[i - 3] : nullptr;
+      bool parentLeft = left(pGranny) == pParent;
+      Node * pAunt = parentLeft ? right(pGranny) : left(pGranny);
+
+      // a red aunt: push the red up to the grandparent and go on from there
+      if (isRed(pAunt))
+      {
+         paint(pParent, false /* red */);
+         paint(pAunt,   false /* red */);
+         paint(pGranny, true  /* red */);
+         i -= 2;
+         continue;
+      }
+
+      int drop;   // where the path loses a node
+      if ((left(pParent) == pNode) == parentLeft)
+      {
+         // on the outside: the parent takes the grandparent's place
+         lift(pParent, pGranny, pAbove);
+         paint(pParent, false /* red */);
+         paint(pGranny, true  /* red */);
+         drop = i - 2;
+      }
+      else
+      {
+         // on the inside: the node takes it, with the two on either side
+         bool belowLeft = i < depth && left(pNode) == path[i + 1];
+         lift(pNode, pParent, pGranny);
+         lift(pNode, pGranny, pAbove);
+         paint(pNode,   false /* red */);
+         paint(pGranny, true  /* red */);
+         path[i - 2] = pNode;
+         if (i == depth)
+         {
+            depth -= 2;
+            break;
+         }
+         path[i - 1] = belowLeft == parentLeft ? pParent : pGranny;
+         drop = i;
+      }
+      for (int j = drop; j < depth; j++)
+         path[j] = path[j + 1];
+      depth--;
+      break;
+   }
+}
+
+/*********************************************
+ * PATH TREE :: REMOVE
+ * Unlink path[depth] and rebalance. A node with two children has
+ * its in-order successor take its place and color, so the node
+ * that really leaves the shape is always one with at most one
+ * child. path needs room for the way down to that successor.
+ * Whichever thread pointed at the node that goes is moved to
+ * where the node's own thread on that side pointed.
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+void PathTree <T, Links, Compare, Allocator> :: remove(Node ** path, int depth)
+{
+   Node * pDelete = path[depth];
+   Node * pLeft  = left(pDelete);
+   Node * pRight = right(pDelete);
+   int above;          // where on the path the hole is below
+   bool fromLeft;      // which side of path[above] the hole is on
+   bool removedRed;    // the color that left the shape
+   Node * pChild;      // what fills the hole
+
+   if (pLeft && pRight)
+   {
+      // down to the in-order successor
+      int at = depth;
+      Node * pIOS = pRight;
+      path[++depth] = pIOS;
+      while (Node * p = left(pIOS))
+      {
+         assert(depth + 1 < maxHeight);
+         path[++depth] = pIOS = p;
+      }
+
+      // the largest on the left threads to pDelete; now it is the successor
+      if (Links::threads)
+      {
+         Node * pPrev = pLeft;
+         while (Node * p = right(pPrev))
+            pPrev = p;
+         Links::hangRight(pPrev, nullptr, pIOS);
+      }
+
+      removedRed = isRed(pIOS);
+      pChild = right(pIOS);
+      if (depth == at + 1)
+         fromLeft = false;
+      else
+      {
+         Links::hangLeft(path[depth - 1], pChild, pIOS);
+         Links::hangRight(pIOS, pRight, nullptr);
+         fromLeft = true;
+      }
+      Links::hangLeft(pIOS, pLeft, nullptr);
+      paint(pIOS, isRed(pDelete));
+      relink(at ? path[at - 1] : nullptr, pDelete, pIOS);
+      path[at] = pIOS;
+      above = depth - 1;
+   }
+   else
+   {
+      removedRed = isRed(pDelete);
+      pChild = pLeft ? pLeft : pRight;
+      above = depth - 1;
+      Node * pAbove = above >= 0 ? path[above] : nullptr;
+      fromLeft = pAbove && left(pAbove) == pDelete;
+
+      // the neighbor inside the one subtree threads past pDelete now
+      if (Links::threads && pLeft)
+      {
+         Node * pPrev = pLeft;
+         while (Node * p = right(pPrev))
+            pPrev = p;
+         Links::hangRight(pPrev, nullptr, Links::rightThread(pDelete));
+      }
+      else if (Links::threads && pRight)
+      {
+         Node * pNext = pRight;
+         while (Node * p = left(pNext))
+            pNext = p;
+         Links::hangLeft(pNext, nullptr, Links::leftThread(pDelete));
+      }
+
+      // a leaf leaves its parent its thread on that side
+      if (!pAbove)
+         root = pChild;
+      else if (fromLeft)
+         Links::hangLeft(pAbove, pChild, Links::leftThread(pDelete));
+      else
+         Links::hangRight(pAbove, pChild, Links::rightThread(pDelete));
+   }
+
+   pool.destroy(pDelete);
+   numElements--;
+
+   // a black node left: its child takes the black, or the hole is fixed
+   if (!removedRed)
+   {
+      if (isRed(pChild) || above < 0)
+      {
+         if (pChild)
+            paint(pChild, false /* red */);
+      }
+      else
+         eraseFixup(path, above, fromLeft);
+   }
+}
+
+/*********************************************
+ * PATH TREE :: ERASE FIXUP
+ * The red-black erase fixup for a missing black on the fromLeft
+ * side of path[depth]. A rotation at the red sibling puts one
+ * more node on the path, which has room since the successor's
+ * place is no longer on it.
+ ********************************************/
+template <class T, class Links, class Compare, class Allocator>
+void PathTree <T, Links, Compare, Allocator> :: eraseFixup(Node ** path, int depth, bool fromLeft)
+{
+   for (;;)
+   {
+      Node * pParent = path[depth];
+      Node * pAbove  = depth ? path[depth - 1] : nullptr;
+      Node * pSibling = fromLeft ? right(pParent) : left(pParent);
+
+      // a red sibling: rotate it up, and the new sibling is black
+      if (isRed(pSibling))
+      {
+         lift(pSibling, pParent, pAbove);
+         paint(pSibling, false /* red */);
+         paint(pParent,  true  /* red */);
+         path[depth++] = pSibling;
+         path[depth] = pParent;
+         pAbove = pSibling;
+         pSibling = fromLeft ? right(pParent) : left(pParent);
+      }
+
+      Node * pNear = fromLeft ? left(pSibling)  : right(pSibling);
+      Node * pFar  = fromLeft ? right(pSibling) : left(pSibling);
+
+      // black nephews: the sibling gives up its black, and the parent
+      // takes it, or passes the problem up
+      if (!isRed(pNear) && !isRed(pFar))
+      {
+         paint(pSibling, true /* red */);
+         if (isRed(pParent) || depth == 0)
+         {
+            paint(pParent, false /* red */);
+            return;
+         }
+         fromLeft = left(pAbove) == pParent;
+         depth--;
+         continue;
+      }
+
+      // a red nephew: one or two rotations and the black is back
+      if (!isRed(pFar))
+      {
+         lift(pNear, pSibling, pParent);
+         paint(pNear,    false /* red */);
+         paint(pSibling, true  /* red */);
+         pFar = pSibling;
+         pSibling = pNear;
+      }
+      lift(pSibling, pParent, pAbove);
+      paint(pSibling, isRed(pParent));
+      paint(pParent, false /* red */);
+      paint(pFar,    false /* red */);
+      return;
+   }
+}
+
+} // namespace custom
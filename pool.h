@@ -0,0 +1,901 @@
+/***********************************************************************
+ * Header:
+ *    NODE POOL
+ * Summary:
+ *    A slab allocator for the nodes of one tree. Nodes are carved out
+ *    of large chunks so neighbors in the tree tend to be neighbors in
+ *    memory, freed nodes are recycled through a free list threaded
+ *    through the free slots themselves, and the whole pool can be
+ *    handed back in one go instead of one node at a time. The chunks
+ *    come from a standard allocator, rebound to whatever the pool needs.
+ *    Two pools can share their chunks, so that nodes can move from one
+ *    tree to another without being copied, and a node taken out of a
+ *    tree can hold on to its chunk with a lease.
+ *
+ *    Where links are indices rather than pointers, every node has to
+ *    be in one array instead, which moves as a whole when it grows.
+ *
+ *    This will contain the class definition of:
+ *        NodePool            : Hands out and recycles nodes of one type
+ *        NodePool::Lease     : Keeps the chunk of a node out on its own alive
+ *        ArrayPool           : The same, with every node in one array
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>    // for assert
+#include <cstddef>    // for size_t and std::max_align_t
+#include <cstdint>    // for uint32_t
+#include <cstring>    // for std::memcpy
+#include <memory>     // for std::allocator and std::allocator_traits
+#include <stdexcept>  // for std::length_error
+#include <type_traits> // for std::true_type and std::false_type
+#include <utility>    // for std::forward and std::swap
+
+class TestBST;     // forward declaration for unit tests
+class TestCompact; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************************************
+ * NODE POOL
+ * The node type may still be incomplete when the pool is declared,
+ * so nothing here needs sizeof(Node) until a node is created.
+ * The allocator may be for any type; it is rebound to Node to
+ * construct nodes and to std::max_align_t to get chunks.
+ *****************************************************************/
+template <class Node, class Allocator = std::allocator<Node> >
+class NodePool
+{
+   friend class ::TestBST; // give unit tests access to the privates
+
+   using NodeAlloc   = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+   using NodeTraits  = std::allocator_traits<NodeAlloc>;
+   using ChunkAlloc  = typename std::allocator_traits<Allocator>::template rebind_alloc<std::max_align_t>;
+   using ChunkTraits = std::allocator_traits<ChunkAlloc>;
+   struct Group;
+public:
+   class Lease;
+
+   //
+   // Construct
+   //
+
+   explicit NodePool(const Allocator & alloc = Allocator()) :
+      alloc(alloc), pChunks(nullptr), pGroup(nullptr), pFree(nullptr), pNext(nullptr), pEnd(nullptr), chunkSize(0) {}
+   NodePool(const NodePool &) = delete;
+   NodePool & operator = (const NodePool &) = delete;
+   ~NodePool() { release(); }
+
+   //
+   // Nodes
+   //
+
+   template <class ... Args>
+   Node * create(Args && ... args);
+   void destroy(Node * pNode) noexcept;
+
+   //
+   // Whole pool
+   //
+
+   void reserve(size_t num);
+   void release() noexcept;
+   void swap(NodePool & rhs) noexcept;
+   bool adopt(NodePool & rhs) noexcept;
+   void share(NodePool & rhs);
+   bool shared() const noexcept { return pGroup != nullptr; }
+   Allocator get_allocator() const { return alloc; }
+
+   //
+   // Nodes out on their own
+   //
+
+   Lease lend();
+   void take(Lease & lease) noexcept;
+
+private:
+   // a slot on the free list holds the next free slot
+   struct FreeSlot { FreeSlot * pNext; };
+
+   // every chunk starts with this header, followed by the slots
+   struct Chunk
+   {
+      Chunk * pNext;
+      size_t  size;
+   };
+
+   // the chunks of every pool that has shared with another, directly
+   // or through a third, so however often trees split and join, a
+   // pool holds one group. When two groups meet, one takes the other's
+   // chunks and the other is left pointing at it; a pool that comes
+   // across such a link moves on to the end of it. The last pool to
+   // let go of a group gives its chunks back.
+   struct Group
+   {
+      explicit Group(const Allocator & alloc) :
+         alloc(alloc), pChunks(nullptr), pFree(nullptr), pParent(nullptr), refs(1) {}
+
+      Allocator  alloc;    // where the chunks came from
+      Chunk    * pChunks;  // every chunk of the group, none once merged away
+      FreeSlot * pFree;    // slots of nodes that died in a lease
+      Group    * pParent;  // the group this one was merged into
+      size_t     refs;     // the pools, leases and merged groups pointing here
+   };
+
+   using GroupAlloc  = typename std::allocator_traits<Allocator>::template rebind_alloc<Group>;
+   using GroupTraits = std::allocator_traits<GroupAlloc>;
+
+   static size_t slotSize()
+   {
+      return sizeof(Node) > sizeof(FreeSlot) ? sizeof(Node) : sizeof(FreeSlot);
+   }
+   static size_t headerSize()
+   {
+      const size_t align = alignof(std::max_align_t);
+      return (sizeof(Chunk) + align - 1) / align * align;
+   }
+   // a chunk of this many slots, counted in units of std::max_align_t
+   static size_t chunkWords(size_t size)
+   {
+      const size_t word = sizeof(std::max_align_t);
+      return (headerSize() + size * slotSize() + word - 1) / word;
+   }
+
+   // the allocator follows the nodes only where its traits say so
+   void swapAllocator(NodePool & rhs, std::true_type) noexcept
+   {
+      using std::swap;
+      swap(alloc, rhs.alloc);
+   }
+   void swapAllocator(NodePool & rhs, std::false_type) noexcept
+   {
+      assert(alloc == rhs.alloc);
+      (void)rhs;
+   }
+   void moveAllocator(NodePool & rhs, std::true_type) noexcept { alloc = std::move(rhs.alloc); }
+   void moveAllocator(NodePool & /* rhs */, std::false_type) noexcept { }
+   void swapChunks(NodePool & rhs) noexcept;
+
+   void * allocateSlot();
+   void grow();
+   void addChunk(size_t size);
+   static void freeChunks(Chunk * pChunk, const Allocator & alloc) noexcept;
+   static void letGo(Group * pGroup) noexcept;
+   static void unite(Group * pInto, Group * pFrom) noexcept;
+   static Group * rootOf(Group * pGroup) noexcept
+   {
+      while (pGroup->pParent)
+         pGroup = pGroup->pParent;
+      return pGroup;
+   }
+   Group * group() noexcept;
+   void meet(Group * pTheirs) noexcept;
+   void seal();
+
+   Allocator  alloc;      // where the chunks come from
+   Chunk    * pChunks;    // every chunk we own alone, newest first
+   Group    * pGroup;     // the chunks we share with other pools, if any
+   FreeSlot * pFree;      // recycled slots, ready to go
+   char     * pNext;      // the next never-used slot in the newest chunk
+   char     * pEnd;       // one past the last slot in the newest chunk
+   size_t     chunkSize;  // number of slots in the last chunk grow() added
+};
+
+/*****************************************************************
+ * NODE POOL :: LEASE
+ * A claim on the group a node taken out of the pool lives in, so
+ * that the node stays put however long the pool lasts, as a node
+ * handle needs. A node that dies in a lease leaves its slot to the
+ * group, for any pool in it to use again.
+ *****************************************************************/
+template <class Node, class Allocator>
+class NodePool <Node, Allocator> :: Lease
+{
+   friend class NodePool;
+public:
+   Lease() noexcept : pGroup(nullptr) { }
+   Lease(Lease && rhs) noexcept : pGroup(rhs.pGroup) { rhs.pGroup = nullptr; }
+   Lease & operator = (Lease && rhs) noexcept
+   {
+      Lease(std::move(rhs)).swap(*this);
+      return *this;
+   }
+   Lease(const Lease &) = delete;
+   Lease & operator = (const Lease &) = delete;
+   ~Lease() { letGo(pGroup); }
+
+   void destroy(Node * pNode) noexcept;
+   Allocator get_allocator() const { assert(pGroup); return rootOf(pGroup)->alloc; }
+   void swap(Lease & rhs) noexcept { std::swap(pGroup, rhs.pGroup); }
+
+private:
+   explicit Lease(Group * pGroup) noexcept : pGroup(pGroup) { }
+
+   Group * pGroup;   // nullptr when there is nothing held
+};
+
+/*********************************************
+ * NODE POOL :: LEASE :: DESTROY
+ * Destroy a node that lives in the group, and leave its slot there
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: Lease :: destroy(Node * pNode) noexcept
+{
+   assert(pGroup && pNode);
+   Group * pRoot = rootOf(pGroup);
+   NodeAlloc nodeAlloc(pRoot->alloc);
+   NodeTraits::destroy(nodeAlloc, pNode);
+   FreeSlot * pFreeSlot = reinterpret_cast<FreeSlot *>(pNode);
+   pFreeSlot->pNext = pRoot->pFree;
+   pRoot->pFree = pFreeSlot;
+}
+
+/*********************************************
+ * NODE POOL :: CREATE
+ * Construct a node in a recycled slot if there is one, otherwise
+ * in the next fresh slot of the newest chunk
+ ********************************************/
+template <class Node, class Allocator>
+template <class ... Args>
+Node * NodePool <Node, Allocator> :: create(Args && ... args)
+{
+   void * pSlot = allocateSlot();
+   try
+   {
+      NodeAlloc nodeAlloc(alloc);
+      Node * pNode = static_cast<Node *>(pSlot);
+      NodeTraits::construct(nodeAlloc, pNode, std::forward<Args>(args)...);
+      return pNode;
+   }
+   catch (...)
+   {
+      // the node never came to be, so its slot goes back
+      FreeSlot * pFreeSlot = static_cast<FreeSlot *>(pSlot);
+      pFreeSlot->pNext = pFree;
+      pFree = pFreeSlot;
+      throw;
+   }
+}
+
+/*********************************************
+ * NODE POOL :: DESTROY
+ * Destroy the node and put its slot on the free list
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: destroy(Node * pNode) noexcept
+{
+   assert(pNode != nullptr);
+   NodeAlloc nodeAlloc(alloc);
+   NodeTraits::destroy(nodeAlloc, pNode);
+   FreeSlot * pFreeSlot = reinterpret_cast<FreeSlot *>(pNode);
+   pFreeSlot->pNext = pFree;
+   pFree = pFreeSlot;
+}
+
+/*********************************************
+ * NODE POOL :: RESERVE
+ * Make sure the next num nodes come from one block, one after
+ * the other. Whatever is left of the newest chunk is skipped.
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: reserve(size_t num)
+{
+   if ((size_t)(pEnd - pNext) < num * slotSize())
+      addChunk(num);
+}
+
+/*********************************************
+ * NODE POOL :: RELEASE
+ * Give every chunk back at once. Any node still living in the pool
+ * is gone without its destructor being called. Shared chunks go
+ * back only once no other pool in the group is left, so until then
+ * our free slots and the fresh ones of the newest chunk are left to
+ * the group, for the pools still in it to use. Nodes still living
+ * in a shared chunk never get their slot back: destroy them first.
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: release() noexcept
+{
+   if (pGroup)
+   {
+      // our free slots may be in chunks we own alone, so those go too
+      Group * pRoot = group();
+      if (pChunks)
+      {
+         Chunk * pLast = pChunks;
+         while (pLast->pNext)
+            pLast = pLast->pNext;
+         pLast->pNext = pRoot->pChunks;
+         pRoot->pChunks = pChunks;
+      }
+      for (; pNext != pEnd; pNext += slotSize())
+      {
+         FreeSlot * pFreeSlot = reinterpret_cast<FreeSlot *>(pNext);
+         pFreeSlot->pNext = pFree;
+         pFree = pFreeSlot;
+      }
+      if (pFree)
+      {
+         FreeSlot * pLast = pFree;
+         while (pLast->pNext)
+            pLast = pLast->pNext;
+         pLast->pNext = pRoot->pFree;
+         pRoot->pFree = pFree;
+      }
+      letGo(pGroup);
+   }
+   else
+      freeChunks(pChunks, alloc);
+   pChunks = nullptr;
+   pGroup = nullptr;
+   pFree = nullptr;
+   pNext = pEnd = nullptr;
+   chunkSize = 0;
+}
+
+/*********************************************
+ * NODE POOL :: SWAP
+ * The nodes stay where they are; only the ownership changes hands.
+ * The allocators go along with the chunks they handed out if
+ * propagate_on_container_swap says so. Otherwise they must be equal,
+ * as for the standard containers.
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: swap(NodePool <Node, Allocator> & rhs) noexcept
+{
+   swapAllocator(rhs, typename std::allocator_traits<Allocator>::propagate_on_container_swap());
+   swapChunks(rhs);
+}
+
+/*********************************************
+ * NODE POOL :: ADOPT
+ * Take over every chunk of rhs, leaving it empty, as a move
+ * assignment would. We must be empty to begin with. If the
+ * allocator does not propagate on move assignment and the two are
+ * not equal, our allocator cannot give rhs's chunks back, so nothing
+ * happens and the nodes will have to be moved one at a time.
+ ********************************************/
+template <class Node, class Allocator>
+bool NodePool <Node, Allocator> :: adopt(NodePool <Node, Allocator> & rhs) noexcept
+{
+   using Propagate = typename std::allocator_traits<Allocator>::propagate_on_container_move_assignment;
+   assert(!pChunks && !pGroup);
+   if (!Propagate::value && !(alloc == rhs.alloc))
+      return false;
+
+   moveAllocator(rhs, Propagate());
+   swapChunks(rhs);
+   return true;
+}
+
+/*********************************************
+ * NODE POOL :: SWAP CHUNKS
+ * Everything but the allocator
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: swapChunks(NodePool <Node, Allocator> & rhs) noexcept
+{
+   std::swap(pChunks,   rhs.pChunks);
+   std::swap(pGroup,    rhs.pGroup);
+   std::swap(pFree,     rhs.pFree);
+   std::swap(pNext,     rhs.pNext);
+   std::swap(pEnd,      rhs.pEnd);
+   std::swap(chunkSize, rhs.chunkSize);
+}
+
+/*********************************************
+ * NODE POOL :: SHARE
+ * From now on nodes may move freely between us and rhs: the two
+ * pools join one group holding every chunk either of them had,
+ * and keep recycling slots wherever they are. Chunks added later
+ * belong to one pool again. The allocators must be equal, as for
+ * std::list::splice.
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: share(NodePool <Node, Allocator> & rhs)
+{
+   assert(alloc == rhs.alloc);
+   if (this == &rhs || (!pChunks && !pGroup && !rhs.pChunks && !rhs.pGroup))
+      return;
+
+   seal();
+   rhs.seal();
+   if (rhs.group())
+   {
+      meet(rhs.group());
+      rhs.group();
+   }
+   else
+      rhs.meet(group());
+}
+
+/*********************************************
+ * NODE POOL :: LEND
+ * A lease for a node on its way out. Our chunks go into our group,
+ * starting one if need be, so the node stays put whatever becomes
+ * of us.
+ ********************************************/
+template <class Node, class Allocator>
+typename NodePool <Node, Allocator> :: Lease NodePool <Node, Allocator> :: lend()
+{
+   seal();
+   Group * pRoot = group();
+   assert(pRoot != nullptr);   // a node is in a chunk, so there is one
+   pRoot->refs++;
+   return Lease(pRoot);
+}
+
+/*********************************************
+ * NODE POOL :: TAKE
+ * A node comes in under a lease: we join its group, as share()
+ * would have, and the lease is done with
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: take(Lease & lease) noexcept
+{
+   if (!lease.pGroup)
+      return;
+   assert(alloc == rootOf(lease.pGroup)->alloc);
+   meet(rootOf(lease.pGroup));
+   letGo(lease.pGroup);
+   lease.pGroup = nullptr;
+}
+
+/*********************************************
+ * NODE POOL :: MEET
+ * We and the group pTheirs become one. A pool with no group simply
+ * joins; otherwise the group more are in takes in the other, so
+ * fewer have links to follow.
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: meet(Group * pTheirs) noexcept
+{
+   assert(pTheirs && !pTheirs->pParent);
+   Group * pOurs = group();
+   if (pOurs == pTheirs)
+      return;
+
+   if (!pOurs)
+   {
+      pGroup = pTheirs;
+      pTheirs->refs++;
+   }
+   else if (pOurs->refs < pTheirs->refs)
+   {
+      unite(pTheirs, pOurs);
+      group();
+   }
+   else
+      unite(pOurs, pTheirs);
+}
+
+/*********************************************
+ * NODE POOL :: SEAL
+ * Hand the chunks we own alone to our group, starting one if we
+ * are in none, ready to be shared with other pools. The free
+ * slots and the fresh ones in the newest chunk are still ours to
+ * hand out.
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: seal()
+{
+   if (!pChunks)
+      return;
+   if (!pGroup)
+   {
+      GroupAlloc groupAlloc(alloc);
+      Group * pNew = GroupTraits::allocate(groupAlloc, 1);
+      GroupTraits::construct(groupAlloc, pNew, alloc);
+      pGroup = pNew;
+   }
+
+   Group * pRoot = group();
+   Chunk * pLast = pChunks;
+   while (pLast->pNext)
+      pLast = pLast->pNext;
+   pLast->pNext = pRoot->pChunks;
+   pRoot->pChunks = pChunks;
+   pChunks = nullptr;
+}
+
+/*********************************************
+ * NODE POOL :: GROUP
+ * The group we are in, nullptr if none. If it was merged into
+ * another, point straight at the one it ended up in, so the
+ * links are only followed once.
+ ********************************************/
+template <class Node, class Allocator>
+typename NodePool <Node, Allocator> :: Group * NodePool <Node, Allocator> :: group() noexcept
+{
+   if (pGroup && pGroup->pParent)
+   {
+      Group * pRoot = rootOf(pGroup);
+      pRoot->refs++;
+      letGo(pGroup);
+      pGroup = pRoot;
+   }
+   return pGroup;
+}
+
+/*********************************************
+ * NODE POOL :: UNITE
+ * Two groups become one: pInto takes the chunks and free slots of
+ * pFrom, which is left pointing at it. Both must be at the end of
+ * their links.
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: unite(Group * pInto, Group * pFrom) noexcept
+{
+   assert(!pInto->pParent && !pFrom->pParent && pInto != pFrom);
+   if (pFrom->pChunks)
+   {
+      Chunk * pLast = pFrom->pChunks;
+      while (pLast->pNext)
+         pLast = pLast->pNext;
+      pLast->pNext = pInto->pChunks;
+      pInto->pChunks = pFrom->pChunks;
+      pFrom->pChunks = nullptr;
+   }
+   if (pFrom->pFree)
+   {
+      FreeSlot * pLast = pFrom->pFree;
+      while (pLast->pNext)
+         pLast = pLast->pNext;
+      pLast->pNext = pInto->pFree;
+      pInto->pFree = pFrom->pFree;
+      pFrom->pFree = nullptr;
+   }
+   pFrom->pParent = pInto;
+   pInto->refs++;
+}
+
+/*********************************************
+ * NODE POOL :: LET GO
+ * One less pool, lease or group points to pGroup. The last one to go
+ * gives the chunks back, and lets go of the group it was merged into.
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: letGo(Group * pGroup) noexcept
+{
+   while (pGroup && --pGroup->refs == 0)
+   {
+      Group * pParent = pGroup->pParent;
+      GroupAlloc groupAlloc(pGroup->alloc);
+      freeChunks(pGroup->pChunks, pGroup->alloc);
+      GroupTraits::destroy(groupAlloc, pGroup);
+      GroupTraits::deallocate(groupAlloc, pGroup, 1);
+      pGroup = pParent;
+   }
+}
+
+/*********************************************
+ * NODE POOL :: FREE CHUNKS
+ * Give a list of chunks back to the allocator
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: freeChunks(Chunk * pChunk, const Allocator & alloc) noexcept
+{
+   ChunkAlloc chunkAlloc(alloc);
+   while (pChunk)
+   {
+      Chunk * pNextChunk = pChunk->pNext;
+      ChunkTraits::deallocate(chunkAlloc,
+                              reinterpret_cast<std::max_align_t *>(pChunk),
+                              chunkWords(pChunk->size));
+      pChunk = pNextChunk;
+   }
+}
+
+/*********************************************
+ * NODE POOL :: ALLOCATE SLOT
+ * Raw memory for one node
+ ********************************************/
+template <class Node, class Allocator>
+void * NodePool <Node, Allocator> :: allocateSlot()
+{
+   static_assert(alignof(Node) <= alignof(std::max_align_t),
+                 "over-aligned nodes are not supported");
+
+   // recycled slots first: they are likely still in the cache
+   if (pFree)
+   {
+      FreeSlot * pSlot = pFree;
+      pFree = pFree->pNext;
+      return pSlot;
+   }
+
+   // then the ones nodes that died in a lease left to our group
+   if (pGroup && group()->pFree)
+   {
+      FreeSlot * pSlot = pGroup->pFree;
+      pGroup->pFree = pSlot->pNext;
+      return pSlot;
+   }
+
+   if (pNext == pEnd)
+      grow();
+   void * pSlot = pNext;
+   pNext += slotSize();
+   return pSlot;
+}
+
+/*********************************************
+ * NODE POOL :: GROW
+ * Add a new chunk, twice the size of the last one up to a limit
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: grow()
+{
+   size_t size = (chunkSize == 0) ? 16 : (chunkSize < 4096 ? chunkSize * 2 : chunkSize);
+   addChunk(size);
+   chunkSize = size;
+}
+
+/*********************************************
+ * NODE POOL :: ADD CHUNK
+ * A chunk of size slots, which become the fresh ones
+ ********************************************/
+template <class Node, class Allocator>
+void NodePool <Node, Allocator> :: addChunk(size_t size)
+{
+   ChunkAlloc chunkAlloc(alloc);
+   Chunk * pChunk = reinterpret_cast<Chunk *>(ChunkTraits::allocate(chunkAlloc, chunkWords(size)));
+   pChunk->pNext = pChunks;
+   pChunk->size = size;
+   pChunks = pChunk;
+
+   pNext = reinterpret_cast<char *>(pChunk) + headerSize();
+   pEnd = pNext + size * slotSize();
+}
+
+/*****************************************************************
+ * ARRAY POOL
+ * Every node in one array, so that a node can be named by where it
+ * is in it. When the array is full, create() makes a new one twice
+ * the size and moves every node across, in the same order: indices
+ * stay good, but pointers into the pool do not. indexOf() and at()
+ * are for holding on to a node through that. Freed slots are
+ * recycled through a free list of indices kept in the slots.
+ *****************************************************************/
+template <class Node, class Allocator = std::allocator<Node> >
+class ArrayPool
+{
+   friend class ::TestCompact; // give unit tests access to the privates
+
+   using NodeAlloc  = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+   using NodeTraits = std::allocator_traits<NodeAlloc>;
+public:
+   // the most slots there can be, so the distance between any two
+   // fits in a 32-bit index with a bit to spare
+   static const size_t maxSize = size_t(1) << 30;
+
+   //
+   // Construct
+   //
+
+   explicit ArrayPool(const Allocator & alloc = Allocator()) :
+      alloc(alloc), pSlots(nullptr), numSlots(0), numUsed(0), iFree(noSlot) {}
+   ArrayPool(const ArrayPool &) = delete;
+   ArrayPool & operator = (const ArrayPool &) = delete;
+   ~ArrayPool() { release(); }
+
+   //
+   // Nodes
+   //
+
+   template <class ... Args>
+   Node * create(Args && ... args);
+   void destroy(Node * pNode) noexcept;
+
+   size_t indexOf(const Node * pNode) const noexcept { return pNode - pSlots; }
+   Node * at(size_t index) const noexcept { return pSlots + index; }
+
+   //
+   // Whole pool
+   //
+
+   void reserve(size_t num);
+   void release() noexcept;
+   void swap(ArrayPool & rhs) noexcept;
+   bool full() const noexcept { return iFree == noSlot && numUsed == numSlots; }
+   Allocator get_allocator() const { return alloc; }
+
+private:
+   // the end of the free list
+   static const uint32_t noSlot = 0xffffffff;
+
+   // the allocator follows the nodes only where its traits say so
+   void swapAllocator(ArrayPool & rhs, std::true_type) noexcept
+   {
+      using std::swap;
+      swap(alloc, rhs.alloc);
+   }
+   void swapAllocator(ArrayPool & rhs, std::false_type) noexcept
+   {
+      assert(alloc == rhs.alloc);
+      (void)rhs;
+   }
+
+   size_t grownSize(size_t num) const;
+   void moveTo(Node * pNew, size_t size);
+
+   Allocator  alloc;      // where the array comes from
+   Node     * pSlots;     // the array
+   size_t     numSlots;   // how many nodes fit in it
+   size_t     numUsed;    // slots ever used since it was new: the rest are fresh
+   uint32_t   iFree;      // the first recycled slot, or noSlot
+};
+
+/*********************************************
+ * ARRAY POOL :: CREATE
+ * Construct a node in a recycled slot if there is one, otherwise
+ * in the next fresh one. With neither, the new node is made in a
+ * new array before anything moves there, so the arguments may
+ * still refer to nodes in the old one.
+ ********************************************/
+template <class Node, class Allocator>
+template <class ... Args>
+Node * ArrayPool <Node, Allocator> :: create(Args && ... args)
+{
+   NodeAlloc nodeAlloc(alloc);
+   if (iFree != noSlot)
+   {
+      Node * pNode = pSlots + iFree;
+      uint32_t iNext;
+      std::memcpy(&iNext, static_cast<void *>(pNode), sizeof(iNext));
+      NodeTraits::construct(nodeAlloc, pNode, std::forward<Args>(args)...);
+      iFree = iNext;
+      return pNode;
+   }
+
+   if (numUsed == numSlots)
+   {
+      size_t size = grownSize(1);
+      Node * pNew = NodeTraits::allocate(nodeAlloc, size);
+      try
+      {
+         NodeTraits::construct(nodeAlloc, pNew + numUsed, std::forward<Args>(args)...);
+         try
+         {
+            moveTo(pNew, size);
+         }
+         catch (...)
+         {
+            NodeTraits::destroy(nodeAlloc, pNew + numUsed);
+            throw;
+         }
+      }
+      catch (...)
+      {
+         NodeTraits::deallocate(nodeAlloc, pNew, size);
+         throw;
+      }
+   }
+   else
+      NodeTraits::construct(nodeAlloc, pSlots + numUsed, std::forward<Args>(args)...);
+   return pSlots + numUsed++;
+}
+
+/*********************************************
+ * ARRAY POOL :: DESTROY
+ * Destroy the node and put its slot on the free list
+ ********************************************/
+template <class Node, class Allocator>
+void ArrayPool <Node, Allocator> :: destroy(Node * pNode) noexcept
+{
+   static_assert(sizeof(Node) >= sizeof(uint32_t), "a free slot holds the index of the next");
+   assert(pNode != nullptr);
+   NodeAlloc nodeAlloc(alloc);
+   NodeTraits::destroy(nodeAlloc, pNode);
+   std::memcpy(static_cast<void *>(pNode), &iFree, sizeof(iFree));
+   iFree = (uint32_t)indexOf(pNode);
+}
+
+/*********************************************
+ * ARRAY POOL :: RESERVE
+ * Make sure the next num nodes need no new array. Moving the nodes
+ * to a bigger one is only for a pool without holes, as it is when
+ * it is new or just released.
+ ********************************************/
+template <class Node, class Allocator>
+void ArrayPool <Node, Allocator> :: reserve(size_t num)
+{
+   if (numSlots - numUsed >= num)
+      return;
+   assert(iFree == noSlot);
+   size_t size = grownSize(num);
+   NodeAlloc nodeAlloc(alloc);
+   Node * pNew = NodeTraits::allocate(nodeAlloc, size);
+   try
+   {
+      moveTo(pNew, size);
+   }
+   catch (...)
+   {
+      NodeTraits::deallocate(nodeAlloc, pNew, size);
+      throw;
+   }
+}
+
+/*********************************************
+ * ARRAY POOL :: RELEASE
+ * Give the array back. Any node still living in it is gone
+ * without its destructor being called.
+ ********************************************/
+template <class Node, class Allocator>
+void ArrayPool <Node, Allocator> :: release() noexcept
+{
+   if (pSlots)
+   {
+      NodeAlloc nodeAlloc(alloc);
+      NodeTraits::deallocate(nodeAlloc, pSlots, numSlots);
+   }
+   pSlots = nullptr;
+   numSlots = numUsed = 0;
+   iFree = noSlot;
+}
+
+/*********************************************
+ * ARRAY POOL :: SWAP
+ * The nodes stay where they are, as for NodePool::swap
+ ********************************************/
+template <class Node, class Allocator>
+void ArrayPool <Node, Allocator> :: swap(ArrayPool <Node, Allocator> & rhs) noexcept
+{
+   swapAllocator(rhs, typename std::allocator_traits<Allocator>::propagate_on_container_swap());
+   std::swap(pSlots,   rhs.pSlots);
+   std::swap(numSlots, rhs.numSlots);
+   std::swap(numUsed,  rhs.numUsed);
+   std::swap(iFree,    rhs.iFree);
+}
+
+/*********************************************
+ * ARRAY POOL :: GROWN SIZE
+ * Twice the size, or enough for num more, whichever is bigger
+ ********************************************/
+template <class Node, class Allocator>
+size_t ArrayPool <Node, Allocator> :: grownSize(size_t num) const
+{
+   if (num > maxSize - numUsed)
+      throw std::length_error("ArrayPool: more nodes than a 32-bit index reaches");
+   size_t size = numSlots ? numSlots * 2 : 16;
+   if (size < numUsed + num)
+      size = numUsed + num;
+   return size < maxSize ? size : maxSize;
+}
+
+/*********************************************
+ * ARRAY POOL :: MOVE TO
+ * Move every node to the same slot of a new array of size slots,
+ * and let the old one go. If a move throws, the new array is left
+ * as empty as it came.
+ ********************************************/
+template <class Node, class Allocator>
+void ArrayPool <Node, Allocator> :: moveTo(Node * pNew, size_t size)
+{
+   NodeAlloc nodeAlloc(alloc);
+   size_t i = 0;
+   try
+   {
+      for (; i < numUsed; i++)
+         NodeTraits::construct(nodeAlloc, pNew + i, std::move(pSlots[i]));
+   }
+   catch (...)
+   {
+      while (i--)
+         NodeTraits::destroy(nodeAlloc, pNew + i);
+      throw;
+   }
+   for (i = 0; i < numUsed; i++)
+      NodeTraits::destroy(nodeAlloc, pSlots + i);
+   if (pSlots)
+      NodeTraits::deallocate(nodeAlloc, pSlots, numSlots);
+   pSlots = pNew;
+   numSlots = size;
+}
+
+} // namespace custom
@@ -0,0 +1,176 @@
+/***********************************************************************
+ * Header:
+ *    SET
+ * Summary:
+ *    Our custom implementation of std::set, on top of our BST
+ *
+ *    This will contain the class definition of:
+ *        set                 : A class that represents a set of unique elements
+ *        set::iterator       : An iterator through a set
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <functional> // for std::less
+#include <initializer_list> // for std::initializer_list
+#include <memory>     // for std::allocator
+#include <utility>    // for std::pair
+#include "bst.h"      // for BST
+
+class TestSet; // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * SET
+ * A set of unique elements, kept in order. The balancing policy
+ * comes last so the rest reads like std::set.
+ ***********************************************/
+template <class T,
+          class Compare   = std::less<T>,
+          class Allocator = std::allocator<T>,
+          class Balance   = RedBlack>
+class set
+{
+   friend class ::TestSet; // give unit tests access to the privates
+
+   using Tree = BST<T, Balance, Compare, Allocator>;
+public:
+   //
+   // Types
+   //
+
+   using key_type       = T;
+   using value_type     = T;
+   using key_compare    = Compare;
+   using value_compare  = Compare;
+   using allocator_type = Allocator;
+   using size_type      = size_t;
+   using iterator       = typename Tree::iterator;
+   using const_iterator = typename Tree::iterator;
+   using reverse_iterator       = typename Tree::reverse_iterator;
+   using const_reverse_iterator = typename Tree::reverse_iterator;
+   using node_type              = typename Tree::node_type;
+   using insert_return_type     = typename Tree::insert_return_type;
+
+   //
+   // Construct
+   //
+
+   set() { }
+   explicit set(const Compare & comp, const Allocator & alloc = Allocator()) : bst(comp, alloc) { }
+   explicit set(const Allocator & alloc) : bst(alloc) { }
+   set(const std::initializer_list<T> & il) { insert(il.begin(), il.end()); }
+   template <class InputIt>
+   set(InputIt first, InputIt last) { insert(first, last); }
+
+   set & operator = (const std::initializer_list<T> & il)
+   {
+      clear();
+      insert(il.begin(), il.end());
+      return *this;
+   }
+   void swap(set & rhs) { bst.swap(rhs.bst); }
+
+   //
+   // Iterator
+   //
+
+   iterator begin() const noexcept { return bst.begin(); }
+   iterator end()   const noexcept { return bst.end();   }
+   reverse_iterator rbegin() const noexcept { return bst.rbegin(); }
+   reverse_iterator rend()   const noexcept { return bst.rend();   }
+
+   //
+   // Access
+   //
+
+   iterator find(const T & t) const                   { return bst.find(t);        }
+   iterator find_and_splay(const T & t)               { return bst.find_and_splay(t); }
+   size_t   count(const T & t) const                  { return bst.count(t);       }
+   bool     contains(const T & t) const               { return bst.contains(t);    }
+   iterator lower_bound(const T & t) const            { return bst.lower_bound(t); }
+   iterator upper_bound(const T & t) const            { return bst.upper_bound(t); }
+   std::pair<iterator, iterator> equal_range(const T & t) const { return bst.equal_range(t); }
+
+   //
+   // Insert
+   //
+
+   std::pair<iterator, bool> insert(const T &  t) { return bst.insert(t, true /* keepUnique */); }
+   std::pair<iterator, bool> insert(      T && t) { return bst.insert(std::move(t), true /* keepUnique */); }
+   iterator insert(iterator hint, const T &  t) { return bst.insert(hint, t, true /* keepUnique */); }
+   iterator insert(iterator hint,       T && t) { return bst.insert(hint, std::move(t), true /* keepUnique */); }
+   template <class InputIt>
+   void insert(InputIt first, InputIt last)
+   {
+      for (; first != last; ++first)
+         insert(*first);
+   }
+
+   // built in its node, then dropped again if it is already there
+   template <class ... Args>
+   std::pair<iterator, bool> emplace(Args && ... args)
+   {
+      auto result = bst.emplaceNode(true /* keepUnique */, false, nullptr, std::forward<Args>(args)...);
+      return std::make_pair(iterator(result.first, &bst), result.second);
+   }
+   template <class ... Args>
+   iterator emplace_hint(iterator hint, Args && ... args)
+   {
+      return iterator(bst.emplaceNode(true /* keepUnique */, true, hint.pNode, std::forward<Args>(args)...).first, &bst);
+   }
+
+   //
+   // Remove
+   //
+
+   iterator erase(iterator it) { return bst.erase(it); }
+   size_t erase(const T & t)
+   {
+      iterator it = bst.find(t);
+      if (it == end())
+         return 0;
+      bst.erase(it);
+      return 1;
+   }
+   void clear() noexcept { bst.clear(); }
+
+   //
+   // Node handles
+   //
+
+   node_type extract(iterator it)  { return bst.extract(it); }
+   node_type extract(const T & t)  { return bst.extract(t);  }
+   insert_return_type insert(node_type && node) { return bst.insert(std::move(node), true /* keepUnique */); }
+   iterator insert(iterator hint, node_type && node) { return bst.insert(hint, std::move(node), true /* keepUnique */); }
+   void merge(set & rhs) { bst.merge(rhs.bst, true /* keepUnique */); }
+
+   //
+   // Status
+   //
+
+   bool   empty() const noexcept { return bst.empty(); }
+   size_t size()  const noexcept { return bst.size();  }
+   Compare   key_comp()      const { return bst.key_comp();      }
+   Allocator get_allocator() const { return bst.get_allocator(); }
+
+private:
+   Tree bst;
+};
+
+/************************************************
+ * SWAP
+ * Swap two sets
+ ***********************************************/
+template <class T, class Compare, class Allocator, class Balance>
+void swap(set<T, Compare, Allocator, Balance> & lhs, set<T, Compare, Allocator, Balance> & rhs)
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom
@@ -13,6 +13,12 @@
  //#undef DEBUG  // Remove this comment to disable unit tests
 
 #include "testBST.h"        // for the BST unit tests
+#include "testSet.h"        // for the set unit tests
+#include "testMap.h"        // for the map unit tests
+#include "testInterval.h"   // for the interval tree unit tests
+#include "testLean.h"       // for the lean tree unit tests
+#include "testThreaded.h"   // for the threaded tree unit tests
+#include "testCompact.h"    // for the compact tree unit tests
 #include "testSpy.h"        // for the spy unit tests
 int Spy::counters[] = {};
 
@@ -26,6 +32,12 @@ int main()
    // unit tests
    TestSpy().run();
    TestBST().run();
+   TestSet().run();
+   TestMap().run();
+   TestInterval().run();
+   TestLean().run();
+   TestThreaded().run();
+   TestCompact().run();
 #endif // DEBUG
    
    return 0;
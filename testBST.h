@@ -12,6 +12,7 @@
 #ifdef DEBUG
 
 #include "bst.h"
+#include "parallel.h"
 #include "unitTest.h"
 #include "spy.h"
 
@@ -19,7 +20,126 @@
 #include <memory>
 #include <iostream>
 #include <string>
+#include <algorithm>  // for std::find
 #include <functional> // for std::less and std::greater
+#include <iterator>   // for std::distance, std::next and std::prev
+#include <limits>     // for std::numeric_limits
+#include <stdexcept>  // for std::runtime_error
+#include <type_traits> // for std::is_same
+#include <vector>
+
+/***********************************************
+ * COUNTING ALLOCATOR
+ * A std::allocator that remembers how often it was called
+ ***********************************************/
+template <class T>
+struct CountingAllocator
+{
+   using value_type = T;
+   static int numAllocate;
+   static int numDeallocate;
+
+   CountingAllocator() = default;
+   template <class U>
+   CountingAllocator(const CountingAllocator<U> &) {}
+
+   T * allocate(size_t n)
+   {
+      numAllocate++;
+      return std::allocator<T>().allocate(n);
+   }
+   void deallocate(T * p, size_t n)
+   {
+      numDeallocate++;
+      std::allocator<T>().deallocate(p, n);
+   }
+};
+template <class T> int CountingAllocator<T>::numAllocate = 0;
+template <class T> int CountingAllocator<T>::numDeallocate = 0;
+template <class T, class U>
+bool operator == (const CountingAllocator<T> &, const CountingAllocator<U> &) { return true; }
+template <class T, class U>
+bool operator != (const CountingAllocator<T> &, const CountingAllocator<U> &) { return false; }
+
+/***********************************************
+ * COUNTING THREE WAY
+ * A strcmp()-style comparator that remembers how often it was called
+ ***********************************************/
+struct CountingThreeWay
+{
+   static int numCalls;
+   int operator()(int lhs, int rhs) const
+   {
+      numCalls++;
+      return (lhs > rhs) - (lhs < rhs);
+   }
+};
+int CountingThreeWay::numCalls = 0;
+
+/***********************************************
+ * COUNTING UPDATE
+ * An augmentation that keeps nothing, but counts how many
+ * times a node is brought up to date
+ ***********************************************/
+struct CountingUpdate : public custom::NoAugment
+{
+   static size_t numUpdates;
+   template <class Node>
+   static void update(Node * /* pNode */) { numUpdates++; }
+};
+size_t CountingUpdate::numUpdates = 0;
+
+/***********************************************
+ * SPY KEY LESS
+ * Orders Spies, and lets a bare int stand in for one
+ ***********************************************/
+struct SpyKeyLess
+{
+   using is_transparent = void;
+   bool operator()(const Spy & lhs, const Spy & rhs) const { return lhs < rhs; }
+   bool operator()(const Spy & lhs, int rhs)         const { return lhs.get() < rhs; }
+   bool operator()(int lhs, const Spy & rhs)         const { return lhs < rhs.get(); }
+};
+
+/***********************************************
+ * TAGGED LESS
+ * Orders ints, and carries a tag that tells two
+ * comparators apart
+ ***********************************************/
+struct TaggedLess
+{
+   int tag = 0;
+   bool operator()(int lhs, int rhs) const { return lhs < rhs; }
+};
+
+/***********************************************
+ * THROWING LESS
+ * Orders Spies until it has been called numLeft
+ * times, then throws
+ ***********************************************/
+struct ThrowingLess
+{
+   static int numLeft;
+   bool operator()(const Spy & lhs, const Spy & rhs) const
+   {
+      if (numLeft-- == 0)
+         throw std::runtime_error("ThrowingLess");
+      return lhs < rhs;
+   }
+};
+int ThrowingLess::numLeft = -1;
+
+/***********************************************
+ * CONCATENATE
+ * A monoid that cares about order: the elements strung together
+ ***********************************************/
+struct Concatenate
+{
+   using result_type = std::string;
+   std::string identity() const { return std::string(); }
+   std::string lift(const std::string & s) const { return s; }
+   std::string combine(const std::string & lhs, const std::string & rhs) const { return lhs + rhs; }
+};
 
  /***********************************************
   * TEST BST
@@ -83,6 +203,10 @@ public:
       test_iterator_decrement_standardToDone();
       test_iterator_decrement_standardEnd();
       test_iterator_dereference_standardRead();
+      test_iterator_decrement_fromEnd();
+      test_iterator_postfix_standard();
+      test_iterator_reverse_standard();
+      test_iterator_traits_algorithms();
 
       // Find
       test_find_empty();
@@ -90,6 +214,13 @@ public:
       test_find_standardLast();
       test_find_standardMissing();
 
+      // Bounds
+      test_lowerBound_standardBetween();
+      test_upperBound_standardMatch();
+      test_equalRange_duplicates();
+      test_equalRange_missing();
+      test_bounds_window();
+
       // Insert
       test_insert_oneLeft();
       test_insert_oneRight();
@@ -99,6 +230,16 @@ public:
       test_insertMove_oneRight();
       test_insertMove_duplicate();
       test_insertMove_keepUnique();
+      test_emplace_standard();
+      test_emplace_duplicate();
+      test_emplaceHint_right();
+      test_emplaceHint_end();
+      test_emplaceHint_wrong();
+      test_node_addLeftMove();
+      test_insertHint_append();
+      test_insertHint_prepend();
+      test_insertHint_duplicate();
+      test_insertHint_extremes();
 
       // Remove
       test_erase_empty();
@@ -107,8 +248,12 @@ public:
       test_erase_oneChild();
       test_erase_twoChildren();
       test_erase_twoChildrenSpecial();
+      test_erase_onlyNode();
       test_clear_empty();
       test_clear_standard();
+      test_popFront_drain();
+      test_popBack_drain();
+      test_extremes_moveSwapCopy();
 
       // Status
       test_empty_empty();
@@ -116,6 +261,118 @@ public:
       test_size_empty();
       test_size_standard();
 
+      // Balance
+      test_balance_insertRotateRight();
+      test_balance_insertRotateLeftRight();
+      test_balance_insertSorted();
+      test_balance_eraseSorted();
+      test_balance_unbalancedSorted();
+      test_balance_avlSorted();
+      test_balance_treapSorted();
+      test_balance_scapegoatSorted();
+
+      // Node pool
+      test_pool_contiguous();
+      test_pool_recycle();
+      test_pool_clearReleases();
+
+      // Allocator and comparator
+      test_allocator_chunks();
+      test_allocator_compare();
+#ifdef CUSTOM_HAS_PMR
+      test_allocator_pmrArena();
+      test_allocator_pmrMoveSwap();
+      test_allocator_pmrAugment();
+#endif
+      test_compare_threeWayFind();
+      test_compare_threeWayKeepUnique();
+#ifdef __cpp_lib_three_way_comparison
+      test_compare_spaceship();
+#endif
+      test_transparent_find();
+      test_transparent_bounds();
+
+      // Sorted build
+      test_sorted_noCompare();
+      test_sorted_redBlackEverySize();
+      test_sorted_policies();
+      test_sorted_fromSorted();
+
+      // Deep trees
+      test_deep_copyAndClear();
+      test_deep_assignKeepsBalance();
+
+      // Order statistics
+      test_orderStatistic_rankSelect();
+      test_orderStatistic_duplicates();
+      test_orderStatistic_policies();
+      test_orderStatistic_bulk();
+
+      // Aggregates
+      test_aggregate_sumWindows();
+      test_aggregate_order();
+      test_aggregate_minAfterErase();
+      test_aggregate_policies();
+
+      // Split and join
+      test_split_standard();
+      test_split_duplicates();
+      test_split_outlivesSource();
+      test_join_standard();
+      test_join_counts();
+      test_join_intoEmpty();
+      test_split_policies();
+      test_split_reshard();
+      test_split_discardHalf();
+      test_split_throws();
+
+      // Set algebra
+      test_unite_standard();
+      test_intersect_standard();
+      test_subtract_standard();
+      test_setAlgebra_copies();
+      test_setAlgebra_counts();
+      test_setAlgebra_parallel();
+      test_setAlgebra_policies();
+      test_setAlgebra_throws();
+
+      // Node handles
+      test_extract_rekey();
+      test_extract_missing();
+      test_extract_otherTree();
+      test_extract_drop();
+      test_extract_outlivesTree();
+      test_extract_outlivesClear();
+      test_extract_dropReused();
+      test_extract_clearedElsewhere();
+      test_insert_nodeDuplicate();
+      test_merge_standard();
+      test_merge_keepUnique();
+
+      // Rebalance
+      test_height_standard();
+      test_rebalance_sorted();
+      test_rebalance_counts();
+      test_rebalance_policies();
+      test_autoRebalance_sorted();
+      test_autoRebalance_policies();
+      test_autoRebalance_amortized();
+      test_autoRebalance_splitJoin();
+
+      // Splay
+      test_splay_insertToRoot();
+      test_splay_findToRoot();
+      test_splay_findMissing();
+      test_splay_findCompares();
+      test_splay_erase();
+      test_splay_otherPolicies();
+      test_splay_hotKeys();
+
+      // Packed nodes
+      test_packed_nodeSize();
+      test_packed_insertErase();
+      test_packed_copyAndHandles();
+
       report("BST");
    }
    
@@ -176,7 +433,7 @@ public:
       // setup
       //            (50)
       custom::BST <Spy> bstSrc;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p50 = bstSrc.pool.create(Spy(50));
       bstSrc.root = p50;
       bstSrc.numElements = 1;
       Spy::reset();
@@ -213,11 +470,11 @@ public:
       }
       // teardown
       if (bstSrc.root)
-         delete bstSrc.root;
+         bstSrc.pool.destroy(bstSrc.root);
       bstSrc.root = nullptr;
       bstSrc.numElements = 0;
       if (bstDest.root)
-         delete bstDest.root;
+         bstDest.pool.destroy(bstDest.root);
       bstDest.root = nullptr;
       bstDest.numElements = 0;
    }
@@ -296,7 +553,7 @@ public:
       // setup
       //            (50) 
       custom::BST <Spy> bstSrc;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p50 = bstSrc.pool.create(Spy(50));
       bstSrc.root = p50;
       bstSrc.numElements = 1;
       Spy::reset();
@@ -331,7 +588,7 @@ public:
       }
       // teardown
       if (bstDest.root)
-         delete bstDest.root;
+         bstDest.pool.destroy(bstDest.root);
       bstDest.root = nullptr;
       bstDest.numElements = 0;
    }
@@ -696,7 +953,7 @@ public:
       setupStandardFixture(bstSrc);
       //                (99) = bstDest
       custom::BST <Spy> bstDest;
-      custom::BST <Spy>::BNode* p99 = new custom::BST<Spy>::BNode(Spy(99));
+      custom::BST <Spy>::BNode* p99 = bstDest.pool.create(Spy(99));
       bstDest.root = p99;
       bstDest.numElements = 1;
       Spy::reset();
@@ -737,7 +994,7 @@ public:
    {  // setup
       //                (99) = bstSrc
       custom::BST <Spy> bstSrc;
-      custom::BST <Spy>::BNode* p99 = new custom::BST<Spy>::BNode(Spy(99));
+      custom::BST <Spy>::BNode* p99 = bstSrc.pool.create(Spy(99));
       bstSrc.root = p99;
       bstSrc.numElements = 1;
       //                (50) = bstDest
@@ -938,7 +1195,7 @@ public:
       setupStandardFixture(bstSrc);
       //                (99) = bstDest
       custom::BST <Spy> bstDest;
-      custom::BST <Spy>::BNode* p99 = new custom::BST<Spy>::BNode(Spy(99));
+      custom::BST <Spy>::BNode* p99 = bstDest.pool.create(Spy(99));
       bstDest.root = p99;
       bstDest.numElements = 1;
       Spy::reset();
@@ -972,7 +1229,7 @@ public:
    {  // setup
       //                (99) = bstSrc
       custom::BST <Spy> bstSrc;
-      custom::BST <Spy>::BNode* p99 = new custom::BST<Spy>::BNode(Spy(99));
+      custom::BST <Spy>::BNode* p99 = bstSrc.pool.create(Spy(99));
       bstSrc.root = p99;
       bstSrc.numElements = 1;
       //                (50) = bstDest
@@ -1089,7 +1346,7 @@ public:
       std::initializer_list<Spy> ilSrc{ Spy(50), Spy(30), Spy(70), Spy(20), Spy(40), Spy(60), Spy(80) };
       //                (99) = bstDest
       custom::BST <Spy> bstDest;
-      custom::BST <Spy>::BNode* p99 = new custom::BST<Spy>::BNode(Spy(99));
+      custom::BST <Spy>::BNode* p99 = bstDest.pool.create(Spy(99));
       bstDest.root = p99;
       bstDest.numElements = 1;
       Spy::reset();
@@ -1940,6 +2197,90 @@ public:
       teardownStandardFixture(bst);
    }
 
+   // stepping back from end() lands on the largest element
+   void test_iterator_decrement_fromEnd()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      auto it = bst.end();
+      Spy::reset();
+      // exercise
+      --it;
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(it != bst.end());
+      assertUnit(it.pNode == bst.root->pRight->pRight);
+      if (it != bst.end())
+         assertUnit(*it == Spy(80));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // postfix moves the iterator and hands back where it was
+   void test_iterator_postfix_standard()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      auto it = bst.begin();
+      Spy::reset();
+      // exercise
+      auto itIncrement = it++;
+      auto itAfter = it;
+      auto itDecrement = it--;
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(itIncrement.pNode == bst.root->pLeft->pLeft);   // 20
+      assertUnit(itAfter.pNode     == bst.root->pLeft);          // 30
+      assertUnit(itDecrement.pNode == bst.root->pLeft);          // 30
+      assertUnit(it.pNode          == bst.root->pLeft->pLeft);   // 20
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // a reverse walk sees everything, largest first
+   void test_iterator_reverse_standard()
+   {  // setup
+      custom::BST <int> bst { 50, 30, 70, 20, 40, 60, 80 };
+      // exercise
+      std::vector<int> descending(bst.rbegin(), bst.rend());
+      // verify
+      assertUnit(descending == std::vector<int>({ 80, 70, 60, 50, 40, 30, 20 }));
+      assertUnit(*bst.rbegin() == 80);
+      assertUnit(bst.rbegin().base() == bst.end());
+   }  // teardown
+
+   // the iterator says it is bidirectional, so the std algorithms work
+   void test_iterator_traits_algorithms()
+   {  // setup
+      using Iterator = custom::BST <int> :: iterator;
+      static_assert(std::is_same<std::iterator_traits<Iterator>::iterator_category,
+                                 std::bidirectional_iterator_tag>::value,
+                    "BST::iterator is bidirectional");
+      custom::BST <int> bst { 50, 30, 70, 20, 40, 60, 80 };
+      // exercise
+      auto num = std::distance(bst.begin(), bst.end());
+      auto itLast = std::prev(bst.end());
+      auto itFound = std::find(bst.begin(), bst.end(), 60);
+      // verify
+      assertUnit(num == 7);
+      assertUnit(*itLast == 80);
+      assertUnit(itFound != bst.end() && *itFound == 60);
+      assertUnit(*std::next(itFound, 2) == 80);
+   }  // teardown
+
    /***************************************
     * Find
     *    BST::find(const T &)
@@ -1986,8 +2327,8 @@ public:
       // exercise
       it = bst.find(s);
       // verify
-      assertUnit(Spy::numEquals() == 3);      // check [50][30][20]
-      assertUnit(Spy::numLessthan() == 2);    // compare [50][30]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numLessthan() == 4);    // compare [50][30][20], check [20]
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
@@ -2029,8 +2370,8 @@ public:
       // exercise
       it = bst.find(s);
       // verify
-      assertUnit(Spy::numEquals() == 3);      // check [50][70][80]
-      assertUnit(Spy::numLessthan() == 2);    // compare [50][70]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numLessthan() == 4);    // compare [50][70][80], check [80]
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
@@ -2072,8 +2413,8 @@ public:
       // exercise
       it = bst.find(s);
       // verify
-      assertUnit(Spy::numEquals() == 3);      // check [50][30][40]
-      assertUnit(Spy::numLessthan() == 3);    // compare [50][30][40]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numLessthan() == 4);    // compare [50][30][40], check [50]
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
@@ -2089,6 +2430,121 @@ public:
       teardownStandardFixture(bst);
    }
 
+   /***************************************
+    * Bounds
+    *    BST::lower_bound(const T &)
+    *    BST::upper_bound(const T &)
+    *    BST::equal_range(const T &)
+    ***************************************/
+
+   // the lower bound of something that is not there, one compare per level
+   void test_lowerBound_standardBetween()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy s(45);
+      Spy::reset();
+      // exercise
+      auto it = bst.lower_bound(s);
+      // verify
+      assertUnit(Spy::numLessthan() == 3);    // compare [50][30][40]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(it != bst.end());
+      assertUnit(*it == Spy(50));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // the upper bound of something that is there is the one after it
+   void test_upperBound_standardMatch()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy s(60);
+      Spy::reset();
+      // exercise
+      auto it = bst.upper_bound(s);
+      auto itLast = bst.upper_bound(Spy(80));
+      // verify
+      assertUnit(it != bst.end());
+      assertUnit(*it == Spy(70));
+      assertUnit(itLast == bst.end());
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // equal_range covers every copy of a duplicated element
+   void test_equalRange_duplicates()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i : { 30, 20, 10, 20, 40, 20, 50, 20 })
+         bst.insert(i, false /* keepUnique */);
+      // exercise
+      auto range = bst.equal_range(20);
+      // verify
+      assertUnit(range.first == bst.lower_bound(20));
+      assertUnit(range.second == bst.upper_bound(20));
+      assertUnit(range.first != bst.end() && *range.first == 20);
+      assertUnit(range.second != bst.end() && *range.second == 30);
+      int num = 0;
+      for (auto it = range.first; it != range.second; ++it)
+         num += (*it == 20);
+      assertUnit(num == 4);
+      assertUnit(bst.count(20) == 4);
+      auto itPrev = range.first;
+      assertUnit(*(--itPrev) == 10);
+   }  // teardown
+
+   // equal_range of a missing element is empty, at where it would go
+   void test_equalRange_missing()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(i);
+      // exercise
+      auto rangeMiddle = bst.equal_range(55);
+      auto rangeFront = bst.equal_range(5);
+      auto rangeBack = bst.equal_range(85);
+      // verify
+      assertUnit(rangeMiddle.first == rangeMiddle.second);
+      assertUnit(*rangeMiddle.first == 60);
+      assertUnit(rangeFront.first == bst.begin());
+      assertUnit(rangeFront.second == bst.begin());
+      assertUnit(rangeBack.first == bst.end());
+      assertUnit(rangeBack.second == bst.end());
+      assertUnit(bst.count(55) == 0);
+   }  // teardown
+
+   // every key in [a, b) is between the two lower bounds
+   void test_bounds_window()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 1000; i += 5)
+         bst.insert(i);
+      // exercise
+      auto itBegin = bst.lower_bound(101);
+      auto itEnd = bst.lower_bound(150);
+      // verify
+      int num = 0;
+      bool inWindow = true;
+      for (auto it = itBegin; it != itEnd; ++it, num++)
+         inWindow = inWindow && *it >= 101 && *it < 150;
+      assertUnit(inWindow);
+      assertUnit(num == 9);                     // 105, 110, ... 145
+   }  // teardown
 
 
    /***************************************
@@ -2101,7 +2557,7 @@ public:
    {  // setup
       //            (50) 
       custom::BST <Spy> bst;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p50 = bst.pool.create(Spy(50));
       bst.root = p50;
       bst.numElements = 1;
       Spy s(60);
@@ -2148,9 +2604,9 @@ public:
       }
       // teardown
       if (p50 && p50->pRight && p50->pRight != p50)
-         delete p50->pRight;
+         bst.pool.destroy(p50->pRight);
       if (p50)
-         delete p50;
+         bst.pool.destroy(p50);
       bst.root = nullptr;
       bst.numElements = 0;
    }
@@ -2160,7 +2616,7 @@ public:
    {  // setup
       //            (50) 
       custom::BST <Spy> bst;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p50 = bst.pool.create(Spy(50));
       bst.root = p50;
       bst.numElements = 1;
       Spy s(40);
@@ -2210,9 +2666,9 @@ public:
 
       // teardown
       if (p50 && p50->pLeft && p50->pLeft != p50)
-         delete p50->pLeft;
+         bst.pool.destroy(p50->pLeft);
       if (p50)
-         delete p50;
+         bst.pool.destroy(p50);
       bst.root = nullptr;
       bst.numElements = 0;
    }
@@ -2222,7 +2678,7 @@ public:
    {  // setup
       //            (50) 
       custom::BST <Spy> bst;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p50 = bst.pool.create(Spy(50));
       bst.root = p50;
       bst.numElements = 1;
       Spy s(50);
@@ -2271,9 +2727,9 @@ public:
 
       // teardown
       if (p50 && p50->pRight && p50->pRight != p50)
-         delete p50->pRight;
+         bst.pool.destroy(p50->pRight);
       if (p50)
-         delete p50;
+         bst.pool.destroy(p50);
       bst.root = nullptr;
       bst.numElements = 0;
    }
@@ -2293,8 +2749,8 @@ public:
       // exercise
       auto pairBST = bst.insert(s, true /* keepUnique */);
       // verify
-      assertUnit(Spy::numLessthan() == 2);    // compare [50][30]
-      assertUnit(Spy::numEquals() == 3);      // compare [50][30][40]
+      assertUnit(Spy::numLessthan() == 4);    // compare [50][30][40], check [40]
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numCopy() == 0);
       assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDestructor() == 0);
@@ -2331,7 +2787,7 @@ public:
    {  // setup
       //            (50) 
       custom::BST <Spy> bst;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p50 = bst.pool.create(Spy(50));
       bst.root = p50;
       bst.numElements = 1;
       Spy s(60);
@@ -2378,9 +2834,9 @@ public:
       }
       // teardown
       if (p50 && p50->pRight && p50->pRight != p50)
-         delete p50->pRight;
+         bst.pool.destroy(p50->pRight);
       if (p50)
-         delete p50;
+         bst.pool.destroy(p50);
       bst.root = nullptr;
       bst.numElements = 0;
    }
@@ -2390,7 +2846,7 @@ public:
    {  // setup
       //            (50) 
       custom::BST <Spy> bst;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p50 = bst.pool.create(Spy(50));
       bst.root = p50;
       bst.numElements = 1;
       Spy s(40);
@@ -2441,9 +2897,9 @@ public:
 
       // teardown
       if (p50 && p50->pLeft && p50->pLeft != p50)
-         delete p50->pLeft;
+         bst.pool.destroy(p50->pLeft);
       if (p50)
-         delete p50;
+         bst.pool.destroy(p50);
       bst.root = nullptr;
       bst.numElements = 0;
    }
@@ -2453,7 +2909,7 @@ public:
    {  // setup
       //            (50) 
       custom::BST <Spy> bst;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p50 = bst.pool.create(Spy(50));
       bst.root = p50;
       bst.numElements = 1;
       Spy s(50);
@@ -2503,9 +2959,9 @@ public:
 
       // teardown
       if (p50 && p50->pRight && p50->pRight != p50)
-         delete p50->pRight;
+         bst.pool.destroy(p50->pRight);
       if (p50)
-         delete p50;
+         bst.pool.destroy(p50);
       bst.root = nullptr;
       bst.numElements = 0;
    }
@@ -2525,8 +2981,8 @@ public:
       // exercise
       auto pairBST = bst.insert(std::move(s), true /* keepUnique */);
       // verify
-      assertUnit(Spy::numLessthan() == 2);    // compare [50][30]
-      assertUnit(Spy::numEquals() == 3);      // compare [50][30][40]
+      assertUnit(Spy::numLessthan() == 4);    // compare [50][30][40], check [40]
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numCopy() == 0);
       assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDestructor() == 0);
@@ -2553,134 +3009,396 @@ public:
 
 
    /***************************************
-    * Erase
-    *    BST::erase(it)
+    * Emplace
+    *    BST::emplace(Args &&...)
+    *    BST::emplace_hint(iterator, Args &&...)
     ***************************************/
 
-   // erase from an empty BST
-   void test_erase_empty()
+   // the element is built in its node from the argument, never copied or moved
+   void test_emplace_standard()
    {  // setup
-      custom::BST <Spy> bst;
-      auto it = bst.end();
+      //            (50) 
+      //       +----+
+      //     (30) 
+      custom::BST <Spy, custom::Unbalanced> bst;
+      bst.insert(Spy(50));
+      bst.insert(Spy(30));
       Spy::reset();
       // exercise
-      auto itReturn = bst.erase(it);
+      auto pairBST = bst.emplace(40);
       // verify
-      assertUnit(Spy::numLessthan() == 0);   
-      assertUnit(Spy::numCopy() == 0);       
-      assertUnit(Spy::numAlloc() == 0);      
-      assertUnit(Spy::numEquals() == 0);
-      assertUnit(Spy::numDestructor() == 0);
-      assertUnit(Spy::numDelete() == 0);
-      assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numDefault() == 0);
-      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numLessthan() == 2);    // compare [50][30]
+      assertUnit(Spy::numNondefault() == 1);  // create [40] in place
+      assertUnit(Spy::numCopy() == 0);
       assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(itReturn == bst.end());
-      assertEmptyFixture(bst);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(pairBST.second == true);
+      assertUnit(pairBST.first != bst.end());
+      if (pairBST.first != bst.end())
+         assertUnit(*(pairBST.first) == Spy(40));
+      //            (50) 
+      //       +----+
+      //     (30) 
+      //       +----+
+      //          (40) 
+      assertUnit(bst.size() == 3);
+      assertUnit(bst.root && bst.root->pLeft && bst.root->pLeft->pRight);
+      if (bst.root && bst.root->pLeft && bst.root->pLeft->pRight)
+      {
+         assertUnit(bst.root->pLeft->pRight->data == Spy(40));
+         assertUnit(bst.root->pLeft->pRight->pParent == bst.root->pLeft);
+      }
    }  // teardown
 
-   // erase with an empty iterator
-   void test_erase_standardMissing()
+   // emplace, like insert, keeps duplicates
+   void test_emplace_duplicate()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
-      custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      auto it = bst.end();
+      custom::BST <Spy> bst { Spy(50), Spy(30), Spy(70) };
       Spy::reset();
       // exercise
-      auto itReturn = bst.erase(it);
+      auto pairBST = bst.emplace(50);
       // verify
-      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numNondefault() == 1);
       assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
-      assertUnit(Spy::numEquals() == 0);
-      assertUnit(Spy::numDestructor() == 0);
-      assertUnit(Spy::numDelete() == 0);
-      assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numDefault() == 0);
-      assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
-      assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(itReturn == bst.end());
-      assertStandardFixture(bst);
-      // teardown
-      teardownStandardFixture(bst);
+      assertUnit(pairBST.second == true);
+      assertUnit(bst.size() == 4);
+      assertUnit(bst.count(Spy(50)) == 2);
    }  // teardown
 
-   // remove a leaf node from the standard fixture
-   void test_erase_noChildren()
+   // a good hint costs two comparisons, wherever it is in the tree
+   void test_emplaceHint_right()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40  [[60]]      80  
-      custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      auto it = custom::BST <Spy> :: iterator(bst.root->pRight->pLeft);
+      //            (50) 
+      //       +----+----+
+      //     (30)      (70) 
+      custom::BST <Spy, custom::Unbalanced> bst;
+      bst.insert(Spy(50));
+      bst.insert(Spy(30));
+      bst.insert(Spy(70));
+      auto hint = bst.find(Spy(70));
       Spy::reset();
       // exercise
-      auto itReturn = bst.erase(it);
+      auto it = bst.emplace_hint(hint, 60);
       // verify
-      assertUnit(Spy::numDestructor() == 1);  // destroy [60]
-      assertUnit(Spy::numDelete() == 1);      // delete [60]
-      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numLessthan() == 2);    // compare [50] before, [70] after
+      assertUnit(Spy::numNondefault() == 1);
       assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
-      assertUnit(Spy::numEquals() == 0);
-      assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numDefault() == 0);
-      assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
-      assertUnit(Spy::numAssignMove() == 0);
-      //                 50 
-      //          +-------+-------+
-      //         30            [[70]]
-      //     +----+----+          +----+
-      //    20        40              80  
-      assertUnit(itReturn == custom::BST <Spy> ::iterator(bst.root->pRight));
-      assertUnit(bst.root->pRight->pLeft == nullptr);
-      assertUnit(bst.numElements == 6);
-      bst.root->pRight->pLeft = new custom::BST<Spy>::BNode(Spy(60));
-      bst.root->pRight->pLeft->pParent = bst.root->pRight;
-      bst.numElements = 7;
-      assertStandardFixture(bst);
-      // teardown
-      teardownStandardFixture(bst);
+      assertUnit(it != bst.end());
+      if (it != bst.end())
+         assertUnit(*it == Spy(60));
+      //            (50) 
+      //       +----+----+
+      //     (30)      (70) 
+      //            +----+
+      //          (60) 
+      assertUnit(bst.size() == 4);
+      assertUnit(bst.root && bst.root->pRight && bst.root->pRight->pLeft);
+      if (bst.root && bst.root->pRight && bst.root->pRight->pLeft)
+         assertUnit(bst.root->pRight->pLeft->data == Spy(60));
    }  // teardown
-   
-   void test_erase_oneChild()
+
+   // end() is a good hint for something bigger than everything
+   void test_emplaceHint_end()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //       [[10]]            60
-      //          +----+     
-      //              30          
-      //            +--+--+
-      //           20    40
-      custom :: BST <int> bst;
-      auto p10 = new custom::BST<int>::BNode(10);
-      auto p20 = new custom::BST<int>::BNode(20);
-      auto p30 = new custom::BST<int>::BNode(30);
-      auto p40 = new custom::BST<int>::BNode(40);
-      auto p60 = new custom::BST<int>::BNode(60);
-      auto p50 = new custom::BST<int>::BNode(50);
-      bst.root = p10->pParent = p60->pParent = p50;
-      p50->pLeft = p30->pParent = p10;
-      p50->pRight = p60;
-      p10->pRight = p20->pParent = p40->pParent = p30;
-      p30->pLeft = p20;
-      p30->pRight = p40;
-      bst.numElements = 6;
-      auto it = custom::BST <int> :: iterator(p10);
+      //            (50) 
+      //       +----+----+
+      //     (30)      (70) 
+      custom::BST <Spy, custom::Unbalanced> bst;
+      bst.insert(Spy(50));
+      bst.insert(Spy(30));
+      bst.insert(Spy(70));
+      Spy::reset();
       // exercise
-      auto itReturn = bst.erase(it);
+      auto it = bst.emplace_hint(bst.end(), 90);
+      // verify
+      assertUnit(Spy::numLessthan() == 1);    // compare [70] before
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(it != bst.end());
+      //            (50) 
+      //       +----+----+
+      //     (30)      (70) 
+      //                 +----+
+      //                    (90) 
+      assertUnit(bst.root && bst.root->pRight && bst.root->pRight->pRight);
+      if (bst.root && bst.root->pRight && bst.root->pRight->pRight)
+         assertUnit(bst.root->pRight->pRight->data == Spy(90));
+   }  // teardown
+
+   // a wrong hint still puts the element where it belongs
+   void test_emplaceHint_wrong()
+   {  // setup
+      //            (50) 
+      //       +----+----+
+      //     (30)      (70) 
+      custom::BST <Spy, custom::Unbalanced> bst;
+      bst.insert(Spy(50));
+      bst.insert(Spy(30));
+      bst.insert(Spy(70));
+      auto hint = bst.find(Spy(30));
+      Spy::reset();
+      // exercise
+      auto it = bst.emplace_hint(hint, 60);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(it != bst.end());
+      if (it != bst.end())
+         assertUnit(*it == Spy(60));
+      assertUnit(bst.root && bst.root->pRight && bst.root->pRight->pLeft);
+      if (bst.root && bst.root->pRight && bst.root->pRight->pLeft)
+         assertUnit(bst.root->pRight->pLeft->data == Spy(60));
+   }  // teardown
+
+   // adding a child from an rvalue moves it in
+   void test_node_addLeftMove()
+   {  // setup
+      custom::BST <Spy> bst;
+      custom::BST<Spy>::BNode* p50 = bst.pool.create(Spy(50));
+      Spy s(30);
+      Spy::reset();
+      // exercise
+      p50->addLeft(bst.pool, std::move(s));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 1);
+      assertUnit(p50->pLeft != nullptr);
+      if (p50->pLeft)
+      {
+         assertUnit(p50->pLeft->data == Spy(30));
+         assertUnit(p50->pLeft->pParent == p50);
+      }
+      // teardown
+      if (p50->pLeft)
+         bst.pool.destroy(p50->pLeft);
+      bst.pool.destroy(p50);
+   }
+
+
+   /***************************************
+    * Insert with a hint
+    *    BST::insert(iterator, const T &)
+    ***************************************/
+
+   // appending in order costs one comparison each, and stays balanced
+   void test_insertHint_append()
+   {  // setup
+      custom::BST <Spy> bst;
+      Spy::reset();
+      // exercise
+      for (int i = 1; i <= 1000; i++)
+         bst.insert(bst.end(), Spy(i));
+      // verify
+      assertUnit(Spy::numLessthan() == 999);  // compare the largest so far
+      assertUnit(bst.size() == 1000);
+      assertUnit(verifyRedBlack(bst.root) > 0);
+      assertUnit(bst.leftmost && bst.leftmost->data == Spy(1));
+      assertUnit(bst.rightmost && bst.rightmost->data == Spy(1000));
+   }  // teardown
+
+   // prepending in order is just as cheap
+   void test_insertHint_prepend()
+   {  // setup
+      custom::BST <int, custom::AVL> bst;
+      // exercise
+      for (int i = 1000; i >= 1; i--)
+         bst.insert(bst.begin(), i);
+      // verify
+      assertUnit(isSequence(bst, 1, 1, 1000));
+      assertUnit(verifyAVL(bst.root) > 0);
+      assertUnit(bst.leftmost && bst.leftmost->data == 1);
+      assertUnit(bst.rightmost && bst.rightmost->data == 1000);
+   }  // teardown
+
+   // a unique element next to the hint is found without a search
+   void test_insertHint_duplicate()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      auto hint = bst.find(Spy(50));
+      Spy s(40);
+      Spy::reset();
+      // exercise
+      auto it = bst.insert(hint, s, true /* keepUnique */);
+      // verify
+      assertUnit(Spy::numLessthan() == 2);    // not after [40], not before it
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(it != bst.end());
+      if (it != bst.end())
+         assertUnit(*it == Spy(40));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // the extremes follow inserts and erases at both ends
+   void test_insertHint_extremes()
+   {  // setup
+      custom::BST <int> bst { 50, 30, 70 };
+      auto hint = bst.find(30);
+      // exercise
+      bst.insert(hint, 10);
+      bst.insert(bst.end(), 90);
+      bst.insert(hint, 80);                   // wrong hint
+      // verify
+      assertUnit(bst.size() == 6);
+      assertUnit(bst.leftmost && bst.leftmost->data == 10);
+      assertUnit(bst.rightmost && bst.rightmost->data == 90);
+      // exercise
+      auto itFirst = bst.begin();
+      bst.erase(itFirst);
+      auto itLast = bst.find(90);
+      bst.erase(itLast);
+      // verify
+      assertUnit(bst.leftmost && bst.leftmost->data == 30);
+      assertUnit(bst.rightmost && bst.rightmost->data == 80);
+      // exercise
+      bst.clear();
+      // verify
+      assertUnit(bst.leftmost == nullptr);
+      assertUnit(bst.rightmost == nullptr);
+   }  // teardown
+
+
+   /***************************************
+    * Erase
+    *    BST::erase(it)
+    ***************************************/
+
+   // erase from an empty BST
+   void test_erase_empty()
+   {  // setup
+      custom::BST <Spy> bst;
+      auto it = bst.end();
+      Spy::reset();
+      // exercise
+      auto itReturn = bst.erase(it);
+      // verify
+      assertUnit(Spy::numLessthan() == 0);   
+      assertUnit(Spy::numCopy() == 0);       
+      assertUnit(Spy::numAlloc() == 0);      
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(itReturn == bst.end());
+      assertEmptyFixture(bst);
+   }  // teardown
+
+   // erase with an empty iterator
+   void test_erase_standardMissing()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      auto it = bst.end();
+      Spy::reset();
+      // exercise
+      auto itReturn = bst.erase(it);
+      // verify
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(itReturn == bst.end());
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }  // teardown
+
+   // remove a leaf node from the standard fixture
+   void test_erase_noChildren()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40  [[60]]      80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      auto it = custom::BST <Spy> :: iterator(bst.root->pRight->pLeft);
+      Spy::reset();
+      // exercise
+      auto itReturn = bst.erase(it);
+      // verify
+      assertUnit(Spy::numDestructor() == 1);  // destroy [60]
+      assertUnit(Spy::numDelete() == 1);      // delete [60]
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //                 50 
+      //          +-------+-------+
+      //         30            [[70]]
+      //     +----+----+          +----+
+      //    20        40              80  
+      assertUnit(itReturn == custom::BST <Spy> ::iterator(bst.root->pRight));
+      assertUnit(bst.root->pRight->pLeft == nullptr);
+      assertUnit(bst.numElements == 6);
+      bst.root->pRight->pLeft = bst.pool.create(Spy(60));
+      bst.root->pRight->pLeft->pParent = bst.root->pRight;
+      bst.numElements = 7;
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }  // teardown
+   
+   void test_erase_oneChild()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //       [[10]]            60
+      //          +----+     
+      //              30          
+      //            +--+--+
+      //           20    40
+      custom :: BST <int> bst;
+      auto p10 = bst.pool.create(10);
+      auto p20 = bst.pool.create(20);
+      auto p30 = bst.pool.create(30);
+      auto p40 = bst.pool.create(40);
+      auto p60 = bst.pool.create(60);
+      auto p50 = bst.pool.create(50);
+      bst.root = p10->pParent = p60->pParent = p50;
+      p50->pLeft = p30->pParent = p10;
+      p50->pRight = p60;
+      p10->pRight = p20->pParent = p40->pParent = p30;
+      p30->pLeft = p20;
+      p30->pRight = p40;
+      bst.numElements = 6;
+      auto it = custom::BST <int> :: iterator(p10);
+      // exercise
+      auto itReturn = bst.erase(it);
       // verify
       //                 50
       //          +-------+-------+
@@ -2704,11 +3422,11 @@ public:
       assertUnit(p50->data == 50);
       assertUnit(p60->data == 60);
       // teardown
-      delete p20;
-      delete p30;
-      delete p40;
-      delete p50;
-      delete p60;
+      bst.pool.destroy(p20);
+      bst.pool.destroy(p30);
+      bst.pool.destroy(p40);
+      bst.pool.destroy(p50);
+      bst.pool.destroy(p60);
       bst.numElements = 0;
       bst.root = nullptr;
    }
@@ -2725,14 +3443,14 @@ public:
       //            +-+
       //              40 
       custom::BST <int> bst;
-      auto p10 = new custom::BST<int>::BNode(10);
-      auto p20 = new custom::BST<int>::BNode(20);
-      auto p30 = new custom::BST<int>::BNode(30);
-      auto p40 = new custom::BST<int>::BNode(40);
-      auto p50 = new custom::BST<int>::BNode(50);
-      auto p60 = new custom::BST<int>::BNode(60);
-      auto p70 = new custom::BST<int>::BNode(70);
-      auto p80 = new custom::BST<int>::BNode(80);
+      auto p10 = bst.pool.create(10);
+      auto p20 = bst.pool.create(20);
+      auto p30 = bst.pool.create(30);
+      auto p40 = bst.pool.create(40);
+      auto p50 = bst.pool.create(50);
+      auto p60 = bst.pool.create(60);
+      auto p70 = bst.pool.create(70);
+      auto p80 = bst.pool.create(80);
       bst.root = p20->pParent = p80->pParent = p70;
       p10->pParent = p50->pParent = p70->pLeft = p20;
       p70->pRight = p80;
@@ -2776,13 +3494,13 @@ public:
       assertUnit(p70->data == 70);
       assertUnit(p80->data == 80);
       // teardown
-      delete p10;
-      delete p30;
-      delete p40;
-      delete p50;
-      delete p60;
-      delete p70;
-      delete p80;
+      bst.pool.destroy(p10);
+      bst.pool.destroy(p30);
+      bst.pool.destroy(p40);
+      bst.pool.destroy(p50);
+      bst.pool.destroy(p60);
+      bst.pool.destroy(p70);
+      bst.pool.destroy(p80);
       bst.numElements = 0;
       bst.root = nullptr;
    }
@@ -2868,157 +3586,2433 @@ public:
    }
 
 
-   /**************************************************************
-    * SETUP STANDARD FIXTURE
-    *                (50) 
-    *          +-------+-------+
-    *        (30)            (70) 
-    *     +----+----+     +----+----+
-    *   (20)      (40)  (60)      (80) 
-    *************************************************************/
-   void setupStandardFixture(custom::BST <Spy>& bst)
-   {
-      // make sure that bst is clean
-      assertUnit(bst.numElements == 0);
-      assertUnit(bst.root == nullptr);
+   // erase the only node, leaving an empty tree
+   void test_erase_onlyNode()
+   {  // setup
+      //            [[50]]
+      custom::BST <Spy> bst;
+      custom::BST<Spy>::BNode* p50 = bst.pool.create(Spy(50));
+      p50->isRed = false;
+      bst.root = p50;
+      bst.numElements = 1;
+      auto it = custom::BST <Spy> ::iterator(p50);
+      Spy::reset();
+      // exercise
+      auto itReturn = bst.erase(it);
+      // verify
+      assertUnit(Spy::numDestructor() == 1);  // destroy [50]
+      assertUnit(Spy::numDelete() == 1);      // delete [50]
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(itReturn == bst.end());
+      assertEmptyFixture(bst);
+   }  // teardown
 
-      // allocate
-      custom::BST<Spy>::BNode* p20 = new custom::BST<Spy>::BNode(Spy(20));
-      custom::BST<Spy>::BNode* p30 = new custom::BST<Spy>::BNode(Spy(30));
-      custom::BST<Spy>::BNode* p40 = new custom::BST<Spy>::BNode(Spy(40));
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
-      custom::BST<Spy>::BNode* p60 = new custom::BST<Spy>::BNode(Spy(60));
-      custom::BST<Spy>::BNode* p70 = new custom::BST<Spy>::BNode(Spy(70));
-      custom::BST<Spy>::BNode* p80 = new custom::BST<Spy>::BNode(Spy(80));
 
-      // hook up the pointers down
-      p30->pLeft  = p20;
-      p30->pRight = p40;
-      p50->pLeft  = p30;
-      p50->pRight = p70;
-      p70->pLeft  = p60;
-      p70->pRight = p80;
+   /***************************************
+    * Ends
+    *    BST::front()    BST::back()
+    *    BST::pop_front()  BST::pop_back()
+    ***************************************/
 
-      // hook up the pointers up
-      p20->pParent = p40->pParent = p30;
-      p30->pParent = p70->pParent = p50;
-      p60->pParent = p80->pParent = p70;
+   // take the smallest until nothing is left, like a priority queue
+   void test_popFront_drain()
+   {  // setup
+      custom::BST <int> bst { 50, 30, 70, 20, 40, 60, 80, 10, 90, 55, 65 };
+      std::vector<int> drained;
+      bool valid = true;
+      // exercise
+      while (!bst.empty())
+      {
+         assertUnit(bst.begin() != bst.end() && *bst.begin() == bst.front());
+         drained.push_back(bst.front());
+         bst.pop_front();
+         valid = valid && verifyRedBlack(bst.root) > 0;
+      }
+      // verify
+      assertUnit(drained == std::vector<int>({ 10, 20, 30, 40, 50, 55, 60, 65, 70, 80, 90 }));
+      assertUnit(valid);
+      assertUnit(bst.begin() == bst.end());
+      assertUnit(bst.leftmost == nullptr && bst.rightmost == nullptr);
+   }  // teardown
 
-      // now assign everything to the bst
-      bst.root = p50;
-      bst.numElements = 7;
-   }
+   // take the largest until nothing is left
+   void test_popBack_drain()
+   {  // setup
+      custom::BST <int, custom::AVL> bst;
+      for (int i = 1; i <= 100; i++)
+         bst.insert((i * 37) % 101);
+      int expected = 100;
+      bool inOrder = true;
+      bool valid = true;
+      // exercise
+      while (!bst.empty())
+      {
+         inOrder = inOrder && bst.back() == expected--;
+         bst.pop_back();
+         valid = valid && verifyAVL(bst.root) >= 0;
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(valid);
+      assertUnit(expected == 0);
+   }  // teardown
+
+   // the ends travel with the nodes when a tree is moved, swapped or copied
+   void test_extremes_moveSwapCopy()
+   {  // setup
+      custom::BST <int> bst1 { 5, 3, 8 };
+      custom::BST <int> bst2 { 50, 30, 80, 10 };
+      // exercise
+      bst1.swap(bst2);
+      custom::BST <int> bstMove(std::move(bst2));
+      custom::BST <int> bstCopy(bst1);
+      // verify
+      assertUnit(bst1.front() == 10 && bst1.back() == 80);
+      assertUnit(bstMove.front() == 3 && bstMove.back() == 8);
+      assertUnit(bstCopy.front() == 10 && bstCopy.back() == 80);
+      assertUnit(bstCopy.leftmost != bst1.leftmost);
+      assertUnit(bst2.begin() == bst2.end());
+      assertUnit(bst2.leftmost == nullptr && bst2.rightmost == nullptr);
+   }  // teardown
+
+   /***************************************
+    * Balance
+    *    BST::insert() and BST::erase() keep the
+    *    red-black properties
+    ***************************************/
+
+   // insert into the left of a left child: single rotation
+   void test_balance_insertRotateRight()
+   {  // setup
+      //            (30b)
+      //        +----+
+      //      (20r)
+      custom::BST <Spy> bst;
+      bst.insert(Spy(30));
+      bst.insert(Spy(20));
+      Spy::reset();
+      // exercise
+      bst.insert(Spy(10));
+      // verify
+      assertUnit(Spy::numLessthan() == 2);    // compare [30][20]
+      assertUnit(Spy::numCopyMove() == 1);    // move [10] into the node
+      assertUnit(Spy::numAlloc() == 1);       // allocate the argument [10]
+      assertUnit(Spy::numNondefault() == 1);  // create the argument [10]
+      assertUnit(Spy::numDestructor() == 1);  // destroy the argument [10]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //            (20b)
+      //        +----+----+
+      //      (10r)      (30r)
+      assertUnit(bst.size() == 3);
+      assertUnit(bst.root != nullptr);
+      if (bst.root)
+      {
+         assertUnit(bst.root->data == Spy(20));
+         assertUnit(bst.root->isRed == false);
+         assertUnit(bst.root->pParent == nullptr);
+         assertUnit(bst.root->pLeft != nullptr);
+         assertUnit(bst.root->pRight != nullptr);
+         if (bst.root->pLeft)
+         {
+            assertUnit(bst.root->pLeft->data == Spy(10));
+            assertUnit(bst.root->pLeft->isRed == true);
+            assertUnit(bst.root->pLeft->pParent == bst.root);
+         }
+         if (bst.root->pRight)
+         {
+            assertUnit(bst.root->pRight->data == Spy(30));
+            assertUnit(bst.root->pRight->isRed == true);
+            assertUnit(bst.root->pRight->pParent == bst.root);
+         }
+      }
+      assertUnit(verifyRedBlack(bst.root) > 0);
+   }  // teardown
+
+   // insert into the right of a left child: double rotation
+   void test_balance_insertRotateLeftRight()
+   {  // setup
+      //            (30b)
+      //        +----+
+      //      (10r)
+      custom::BST <int> bst;
+      bst.insert(30);
+      bst.insert(10);
+      // exercise
+      bst.insert(20);
+      // verify
+      //            (20b)
+      //        +----+----+
+      //      (10r)      (30r)
+      assertUnit(bst.size() == 3);
+      assertUnit(bst.root != nullptr);
+      if (bst.root)
+      {
+         assertUnit(bst.root->data == 20);
+         assertUnit(bst.root->pLeft && bst.root->pLeft->data == 10);
+         assertUnit(bst.root->pRight && bst.root->pRight->data == 30);
+      }
+      assertUnit(verifyRedBlack(bst.root) > 0);
+   }  // teardown
+
+   // sorted input must not degenerate into a linked list
+   void test_balance_insertSorted()
+   {  // setup
+      custom::BST <int> bst;
+      // exercise
+      for (int i = 1; i <= 1023; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(bst.size() == 1023);
+      assertUnit(verifyRedBlack(bst.root) > 0);
+      assertUnit(height(bst.root) <= 2 * 10);   // 2 log2(n + 1)
+      int expected = 1;
+      bool inOrder = true;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         inOrder = inOrder && *it == expected++;
+      assertUnit(inOrder);
+      assertUnit(expected == 1024);
+   }  // teardown
+
+   // erasing keeps the tree balanced
+   void test_balance_eraseSorted()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 1; i <= 1023; i++)
+         bst.insert(i);
+      // exercise
+      for (int i = 1; i <= 1023; i += 2)
+      {
+         auto it = bst.find(i);
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(bst.size() == 511);
+      assertUnit(verifyRedBlack(bst.root) > 0);
+      assertUnit(height(bst.root) <= 2 * 9);    // 2 log2(n + 1)
+      int expected = 2;
+      bool inOrder = true;
+      for (auto it = bst.begin(); it != bst.end(); ++it, expected += 2)
+         inOrder = inOrder && *it == expected;
+      assertUnit(inOrder);
+      assertUnit(expected == 1024);
+   }  // teardown
+
+
+   // the unbalanced policy degenerates on sorted input, as expected
+   void test_balance_unbalancedSorted()
+   {  // setup
+      custom::BST <int, custom::Unbalanced> bst;
+      // exercise
+      for (int i = 1; i <= 100; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(bst.size() == 100);
+      assertUnit(height(bst.root) == 100);
+      assertUnit(isSequence(bst, 1, 1, 100));
+   }  // teardown
+
+   // AVL on sorted input, then erase every other element
+   void test_balance_avlSorted()
+   {  // setup
+      custom::BST <int, custom::AVL> bst;
+      // exercise
+      for (int i = 1; i <= 1023; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(verifyAVL(bst.root) > 0);
+      assertUnit(height(bst.root) <= 14);       // 1.44 log2(n + 2)
+      assertUnit(isSequence(bst, 1, 1, 1023));
+      // exercise
+      for (int i = 1; i <= 1023; i += 2)
+      {
+         auto it = bst.find(i);
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(verifyAVL(bst.root) > 0);
+      assertUnit(isSequence(bst, 2, 2, 511));
+   }  // teardown
+
+   // treap on sorted input, then erase every other element
+   void test_balance_treapSorted()
+   {  // setup
+      custom::BST <int, custom::Treap> bst;
+      // exercise
+      for (int i = 1; i <= 1023; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(verifyHeap(bst.root));
+      assertUnit(height(bst.root) <= 40);       // expected ~2.99 log2(n)
+      assertUnit(isSequence(bst, 1, 1, 1023));
+      // exercise
+      for (int i = 1; i <= 1023; i += 2)
+      {
+         auto it = bst.find(i);
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(verifyHeap(bst.root));
+      assertUnit(isSequence(bst, 2, 2, 511));
+   }  // teardown
+
+   // scapegoat on sorted input, then erase every other element
+   void test_balance_scapegoatSorted()
+   {  // setup
+      custom::BST <int, custom::Scapegoat> bst;
+      // exercise
+      for (int i = 1; i <= 1023; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(height(bst.root) <= 19);       // log3/2(n) + 1
+      assertUnit(verifyParents(bst.root, (decltype(bst.root))nullptr));
+      assertUnit(isSequence(bst, 1, 1, 1023));
+      // exercise
+      for (int i = 1; i <= 1023; i += 2)
+      {
+         auto it = bst.find(i);
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(height(bst.root) <= 17);
+      assertUnit(verifyParents(bst.root, (decltype(bst.root))nullptr));
+      assertUnit(isSequence(bst, 2, 2, 511));
+   }  // teardown
+
+
+   /***************************************
+    * Node pool
+    *    BST::pool
+    ***************************************/
+
+   // nodes inserted one after another sit next to each other in memory
+   void test_pool_contiguous()
+   {  // setup
+      custom::BST <int> bst;
+      // exercise
+      for (int i = 1; i <= 10; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(bst.pool.pChunks != nullptr);
+      assertUnit(bst.pool.pFree == nullptr);
+      const char* pFirst = (const char*)bst.find(1).pNode;
+      bool contiguous = true;
+      for (int i = 2; i <= 10; i++)
+         contiguous = contiguous && (const char*)bst.find(i).pNode ==
+                                    pFirst + (i - 1) * bst.pool.slotSize();
+      assertUnit(contiguous);
+   }  // teardown
+
+   // an erased node's slot is the next one handed out
+   void test_pool_recycle()
+   {  // setup
+      custom::BST <Spy> bst;
+      for (int i = 1; i <= 10; i++)
+         bst.insert(Spy(i * 10));
+      auto it = bst.find(Spy(40));
+      auto pSlot = it.pNode;
+      bst.erase(it);
+      Spy::reset();
+      // exercise
+      auto pairBST = bst.insert(Spy(45));
+      // verify
+      assertUnit(pairBST.first.pNode == pSlot);
+      assertUnit(bst.pool.pFree == nullptr);
+      assertUnit(Spy::numDestructor() == 1);  // destroy the argument [45]
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(bst.size() == 10);
+   }  // teardown
+
+   // clear hands every chunk back at once
+   void test_pool_clearReleases()
+   {  // setup
+      custom::BST <Spy> bst;
+      for (int i = 1; i <= 100; i++)
+         bst.insert(Spy(i));
+      Spy::reset();
+      // exercise
+      bst.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 100);
+      assertUnit(Spy::numDelete() == 100);
+      assertUnit(bst.pool.pChunks == nullptr);
+      assertUnit(bst.pool.pFree == nullptr);
+      assertEmptyFixture(bst);
+   }  // teardown
+
+   /***************************************
+    * ALLOCATOR AND COMPARATOR
+    *     BST<T, Balance, Compare, Allocator>
+    ***************************************/
+
+   // the allocator is asked for chunks, not for nodes
+   void test_allocator_chunks()
+   {  // setup
+      using Alloc = CountingAllocator<std::max_align_t>;
+      Alloc::numAllocate = Alloc::numDeallocate = 0;
+      {
+         custom::BST <int, custom::RedBlack, std::less<int>, CountingAllocator<int>> bst;
+         // exercise
+         for (int i = 1; i <= 100; i++)
+            bst.insert(i);
+         // verify
+         assertUnit(bst.size() == 100);
+         assertUnit(Alloc::numAllocate == 3);     // 16 + 32 + 64 slots
+         assertUnit(Alloc::numDeallocate == 0);
+      }  // teardown
+      assertUnit(Alloc::numDeallocate == 3);
+   }
+
+   // a different comparator gives a different order
+   void test_allocator_compare()
+   {  // setup
+      custom::BST <int, custom::RedBlack, std::greater<int>> bst;
+      // exercise
+      for (int i : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(i);
+      // verify
+      assertUnit(*bst.begin() == 80);
+      int previous = 90;
+      bool descending = true;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+      {
+         descending = descending && *it < previous;
+         previous = *it;
+      }
+      assertUnit(descending);
+      assertUnit(bst.find(40) != bst.end());
+      assertUnit(verifyRedBlack(bst.root) > 0);
+   }  // teardown
+
+#ifdef CUSTOM_HAS_PMR
+   // every node lands in the arena, and nothing goes upstream
+   void test_allocator_pmrArena()
+   {  // setup
+      alignas(std::max_align_t) char buffer[16384];
+      std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                                std::pmr::null_memory_resource());
+      custom::pmr::BST <int> bst(&arena);
+      // exercise
+      for (int i = 1; i <= 100; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(bst.size() == 100);
+      bool inArena = true;
+      for (int i = 1; i <= 100; i++)
+      {
+         const char* p = (const char*)bst.find(i).pNode;
+         inArena = inArena && p >= buffer && p < buffer + sizeof(buffer);
+      }
+      assertUnit(inArena);
+      assertUnit(bst.get_allocator().resource() == &arena);
+   }  // teardown
+
+   // a pmr tree swaps and moves without assigning its allocator: nodes
+   // come along within one resource, and are moved one at a time
+   // into a tree whose resource is another
+   void test_allocator_pmrMoveSwap()
+   {  // setup
+      std::pmr::unsynchronized_pool_resource arena;
+      std::pmr::unsynchronized_pool_resource other;
+      custom::pmr::BST <int> bst(&arena);
+      custom::pmr::BST <int> small(&arena);
+      for (int i = 1; i <= 100; i++)
+         bst.insert(i);
+      small.insert(0);
+      auto pFifty = bst.find(50).pNode;
+      // exercise
+      bst.swap(small);
+      custom::pmr::BST <int> moved(std::move(small));
+      custom::pmr::BST <int> elsewhere(&other);
+      elsewhere.insert(-1);
+      elsewhere = std::move(moved);
+      custom::pmr::BST <int> high = elsewhere.split(51);
+      custom::pmr::BST <int> sorted = custom::pmr::BST <int>::from_sorted(
+         elsewhere.begin(), elsewhere.end(), std::less<int>(), &arena);
+      // verify
+      assertUnit(bst.size() == 1 && *bst.begin() == 0);
+      assertUnit(small.empty() && moved.empty());
+      assertUnit(elsewhere.size() == 50 && high.size() == 50);
+      assertUnit(*elsewhere.begin() == 1 && *high.begin() == 51);
+      assertUnit(elsewhere.find(50).pNode != pFifty);
+      assertUnit(elsewhere.get_allocator().resource() == &other);
+      assertUnit(high.get_allocator().resource() == &other);
+      assertUnit(bst.get_allocator().resource() == &arena);
+      assertUnit(sorted.size() == 50 && sorted.get_allocator().resource() == &arena);
+      assertUnit(verifyRedBlack(elsewhere.root) > 0 && verifyRedBlack(high.root) > 0);
+   }  // teardown
+
+   // an order-statistic tree can live in an arena too
+   void test_allocator_pmrAugment()
+   {  // setup
+      alignas(std::max_align_t) char buffer[16384];
+      std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                                std::pmr::null_memory_resource());
+      custom::pmr::BST <int, custom::RedBlack, std::less<int>, custom::OrderStatistic> bst(&arena);
+      // exercise
+      for (int i = 1; i <= 100; i++)
+         bst.insert(i * 2);
+      // verify
+      assertUnit(bst.size() == 100);
+      assertUnit(bst.select(41) == 84 && bst.rank(84) == 41);
+      assertUnit(bst.count_range(10, 21) == 6);
+      assertUnit(bst.get_allocator().resource() == &arena);
+      assertUnit(verifySizes(bst.root) == 100);
+   }  // teardown
+#endif // CUSTOM_HAS_PMR
+
+   // a three-way comparator is called once per node and stops when found
+   void test_compare_threeWayFind()
+   {  // setup
+      custom::BST <int, custom::RedBlack, CountingThreeWay> bst;
+      for (int i : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(i);
+      CountingThreeWay::numCalls = 0;
+      // exercise
+      auto itRoot = bst.find(50);
+      int numRoot = CountingThreeWay::numCalls;
+      auto itLeaf = bst.find(20);
+      int numLeaf = CountingThreeWay::numCalls - numRoot;
+      auto itMissing = bst.find(42);
+      int numMissing = CountingThreeWay::numCalls - numRoot - numLeaf;
+      // verify
+      assertUnit(itRoot != bst.end() && *itRoot == 50);
+      assertUnit(numRoot == 1);                // compare [50]
+      assertUnit(itLeaf != bst.end() && *itLeaf == 20);
+      assertUnit(numLeaf == 3);                // compare [50][30][20]
+      assertUnit(itMissing == bst.end());
+      assertUnit(numMissing == 3);             // compare [50][30][40]
+   }  // teardown
+
+   // a three-way comparator finds the duplicate on the way down
+   void test_compare_threeWayKeepUnique()
+   {  // setup
+      custom::BST <int, custom::RedBlack, CountingThreeWay> bst;
+      for (int i : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(i);
+      CountingThreeWay::numCalls = 0;
+      // exercise
+      auto pairBST = bst.insert(40, true /* keepUnique */);
+      // verify
+      assertUnit(pairBST.second == false);
+      assertUnit(*pairBST.first == 40);
+      assertUnit(CountingThreeWay::numCalls == 3);  // compare [50][30][40]
+      assertUnit(bst.size() == 7);
+   }  // teardown
+
+#ifdef __cpp_lib_three_way_comparison
+   // operator<=> through std::compare_three_way
+   void test_compare_spaceship()
+   {  // setup
+      custom::BST <std::string, custom::RedBlack, std::compare_three_way> bst;
+      // exercise
+      for (const char* s : { "mango", "apple", "pear", "kiwi", "fig" })
+         bst.insert(std::string(s));
+      // verify
+      assertUnit(*bst.begin() == "apple");
+      assertUnit(bst.find(std::string("kiwi")) != bst.end());
+      assertUnit(bst.find(std::string("plum")) == bst.end());
+      assertUnit(bst.contains("fig") && !bst.contains("date"));
+      assertUnit(bst.insert(std::string("pear"), true).second == false);
+   }  // teardown
+#endif // __cpp_lib_three_way_comparison
+
+   // look up a Spy by a bare int without ever making a Spy
+   void test_transparent_find()
+   {  // setup
+      custom::BST <Spy, custom::RedBlack, SpyKeyLess> bst;
+      for (int i : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(Spy(i));
+      Spy::reset();
+      // exercise
+      auto itFound = bst.find(40);
+      auto itMissing = bst.find(42);
+      bool contains = bst.contains(60);
+      size_t count = bst.count(20);
+      // verify
+      assertUnit(Spy::numNondefault() == 0);  // no Spy made for the key
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(itFound != bst.end());
+      assertUnit((*itFound).get() == 40);
+      assertUnit(itMissing == bst.end());
+      assertUnit(contains == true);
+      assertUnit(count == 1);
+   }  // teardown
+
+   // std::less<> probes a tree of strings with a plain C string
+   void test_transparent_bounds()
+   {  // setup
+      custom::BST <std::string, custom::RedBlack, std::less<>> bst;
+      for (const char* s : { "mango", "apple", "pear", "kiwi", "fig" })
+         bst.insert(std::string(s));
+      // exercise
+      auto itLower = bst.lower_bound("g");
+      auto itUpper = bst.upper_bound("kiwi");
+      // verify
+      assertUnit(itLower != bst.end() && *itLower == "kiwi");
+      assertUnit(itUpper != bst.end() && *itUpper == "mango");
+      assertUnit(bst.lower_bound("zebra") == bst.end());
+      assertUnit(bst.count("pear") == 1);
+      assertUnit(bst.contains("plum") == false);
+   }  // teardown
+
+   /***************************************
+    * SORTED BUILD
+    *     BST::assign_sorted(first, last)
+    *     BST::from_sorted(first, last)
+    ***************************************/
+
+   // one copy per element, no comparisons, and one block in input order
+   void test_sorted_noCompare()
+   {  // setup
+      std::vector<Spy> values;
+      for (int i = 1; i <= 100; i++)
+         values.push_back(Spy(i));
+      custom::BST <Spy> bst;
+      bst.insert(Spy(999));
+      Spy::reset();
+      // exercise
+      bst.assign_sorted(values.begin(), values.end());
+      // verify
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numCopy() == 100);
+      assertUnit(Spy::numDestructor() == 1);   // the 999
+      assertUnit(bst.size() == 100);
+      assertUnit(bst.pool.pChunks != nullptr);
+      assertUnit(bst.pool.pChunks->pNext == nullptr);
+      assertUnit(verifyParents(bst.root, (custom::BST<Spy>::BNode*)nullptr));
+      assertUnit(height(bst.root) == 7);
+      const char* pFirst = (const char*)bst.begin().pNode;
+      bool inOrder = true;
+      int i = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it, ++i)
+         inOrder = inOrder && (*it).get() == i + 1 &&
+                   (const char*)it.pNode == pFirst + i * bst.pool.slotSize();
+      assertUnit(inOrder);
+      assertUnit(i == 100);
+   }  // teardown
+
+   // the colors are right for every size, and the tree keeps working
+   void test_sorted_redBlackEverySize()
+   {  // setup
+      std::vector<int> values;
+      bool valid = true;
+      bool sequence = true;
+      for (int num = 0; num <= 70; num++)
+      {
+         custom::BST <int> bst;
+         // exercise
+         bst.assign_sorted(values.begin(), values.end());
+         // verify
+         valid = valid && verifyRedBlack(bst.root) > 0;
+         sequence = sequence && isSequence(bst, 0, 2, num);
+         bst.insert(2 * num + 1);
+         for (int i = 0; i < num; i += 3)
+         {
+            auto it = bst.find(2 * i);
+            bst.erase(it);
+         }
+         valid = valid && verifyRedBlack(bst.root) > 0;
+         values.push_back(2 * num);
+      }
+      assertUnit(valid);
+      assertUnit(sequence);
+   }  // teardown
+
+   // each policy gets its metadata from the build
+   void test_sorted_policies()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 1; i <= 1000; i++)
+         values.push_back(i);
+      custom::BST <int, custom::AVL> bstAVL;
+      custom::BST <int, custom::Treap> bstTreap;
+      custom::BST <int, custom::Scapegoat> bstScapegoat;
+      // exercise
+      bstAVL.assign_sorted(values.begin(), values.end());
+      bstTreap.assign_sorted(values.begin(), values.end());
+      bstScapegoat.assign_sorted(values.begin(), values.end());
+      // verify
+      assertUnit(verifyAVL(bstAVL.root) == 10);
+      assertUnit(verifyHeap(bstTreap.root));
+      assertUnit(height(bstTreap.root) == 10);
+      assertUnit(bstScapegoat.balanceState.maxSize == 1000);
+      assertUnit(height(bstScapegoat.root) == 10);
+      // exercise
+      for (int i = 1001; i <= 1500; i++)
+      {
+         bstAVL.insert(i);
+         bstTreap.insert(i);
+         bstScapegoat.insert(i);
+      }
+      // verify
+      assertUnit(verifyAVL(bstAVL.root) > 0);
+      assertUnit(verifyHeap(bstTreap.root));
+      assertUnit(isSequence(bstAVL, 1, 1, 1500));
+      assertUnit(isSequence(bstTreap, 1, 1, 1500));
+      assertUnit(isSequence(bstScapegoat, 1, 1, 1500));
+   }  // teardown
+
+   // a new tree, in the order of its own comparator
+   void test_sorted_fromSorted()
+   {  // setup
+      std::vector<std::string> values = { "pear", "mango", "kiwi", "fig", "apple" };
+      // exercise
+      auto bst = custom::BST <std::string, custom::RedBlack, std::greater<std::string>>::
+         from_sorted(values.begin(), values.end());
+      // verify
+      assertUnit(bst.size() == 5);
+      assertUnit(*bst.begin() == "pear");
+      assertUnit(bst.find("kiwi") != bst.end());
+      assertUnit(bst.insert(std::string("lime")).second);
+      assertUnit(verifyRedBlack(bst.root) > 0);
+      assertUnit(values.size() == 5);          // copied, not moved
+   }  // teardown
+
+   /***************************************
+    * DEEP TREES
+    *     BST::operator=(const BST &)
+    *     BST::clear()
+    ***************************************/
+
+   // a stick far too deep to recurse down copies and clears fine
+   void test_deep_copyAndClear()
+   {  // setup
+      const int num = 200000;
+      custom::BST <Spy, custom::Unbalanced> bstSrc;
+      custom::BST <Spy, custom::Unbalanced> bstDest;
+      custom::BST<Spy, custom::Unbalanced>::BNode* pBottom = nullptr;
+      for (int i = num; i >= 1; i--)
+      {
+         auto pNode = bstSrc.pool.create(Spy(i));
+         pNode->pRight = pBottom;
+         if (pBottom)
+            pBottom->pParent = pNode;
+         pBottom = pNode;
+      }
+      bstSrc.root = pBottom;
+      bstSrc.numElements = num;
+      bstSrc.findExtremes();
+      bstDest.insert(Spy(-1));
+      bstDest.insert(Spy(-2));
+      Spy::reset();
+      // exercise
+      bstDest = bstSrc;
+      // verify
+      assertUnit(Spy::numAssign() == 1);        // the root is reused
+      assertUnit(Spy::numCopy() == num - 1);
+      assertUnit(Spy::numDestructor() == 1);    // the -2 had no place
+      assertUnit(bstDest.size() == num);
+      assertUnit(bstDest.root->pParent == nullptr);
+      bool same = true;
+      bool parents = true;
+      auto itSrc = bstSrc.begin();
+      for (auto it = bstDest.begin(); it != bstDest.end(); ++it, ++itSrc)
+      {
+         same = same && itSrc != bstSrc.end() && (*it).get() == (*itSrc).get();
+         parents = parents && (!it.pNode->pLeft  || it.pNode->pLeft->pParent  == it.pNode)
+                           && (!it.pNode->pRight || it.pNode->pRight->pParent == it.pNode);
+      }
+      assertUnit(same);
+      assertUnit(parents);
+      // exercise
+      Spy::reset();
+      bstSrc.clear();
+      bstDest.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 2 * num);
+      assertUnit(bstSrc.root == nullptr && bstSrc.size() == 0);
+      assertUnit(bstDest.root == nullptr && bstDest.size() == 0);
+   }  // teardown
+
+   // a copy has the colors and the state of the original
+   void test_deep_assignKeepsBalance()
+   {  // setup
+      custom::BST <int> bstSrc;
+      for (int i = 1; i <= 100; i++)
+         bstSrc.insert(i);
+      custom::BST <int> bstDest;
+      for (int i = 0; i < 30; i++)
+         bstDest.insert(1000 - i * 7);
+      // exercise
+      bstDest = bstSrc;
+      // verify
+      assertUnit(verifyRedBlack(bstDest.root) == verifyRedBlack(bstSrc.root));
+      assertUnit(verifyRedBlack(bstDest.root) > 0);
+      // exercise
+      for (int i = 101; i <= 200; i++)
+         bstDest.insert(i);
+      for (int i = 1; i <= 200; i += 2)
+      {
+         auto it = bstDest.find(i);
+         bstDest.erase(it);
+      }
+      // verify
+      assertUnit(verifyRedBlack(bstDest.root) > 0);
+      assertUnit(isSequence(bstDest, 2, 2, 100));
+      assertUnit(isSequence(bstSrc, 1, 1, 100));
+   }  // teardown
+
+   /***************************************
+    * Order statistics
+    *    BST::rank()   BST::select()
+    *    BST::nth()    BST::count_range()
+    ***************************************/
+
+   // positions and counts by walking down, not across
+   void test_orderStatistic_rankSelect()
+   {  // setup
+      custom::BST <int, custom::RedBlack, std::less<int>, std::allocator<int>, custom::OrderStatistic> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(((i * 37) % 100) * 2);     // 0, 2, ... 198, scrambled
+      // exercise and verify
+      assertUnit(verifySizes(bst.root) == 100);
+      assertUnit(bst.rank(0) == 0);
+      assertUnit(bst.rank(51) == 26);          // 0 through 50
+      assertUnit(bst.rank(52) == 26);
+      assertUnit(bst.rank(500) == 100);
+      assertUnit(bst.select(0) == 0);
+      assertUnit(bst.select(99) == 198);
+      assertUnit(bst.select(49) == 98);
+      assertUnit(bst.nth(10) != bst.end() && *bst.nth(10) == 20);
+      assertUnit(bst.nth(100) == bst.end());
+      assertUnit(bst.count_range(10, 20) == 5);   // 10 through 18
+      assertUnit(bst.count_range(11, 11) == 0);
+      assertUnit(bst.count_range(20, 10) == 0);
+      assertUnit(bst.count_range(-5, 1000) == 100);
+   }  // teardown
+
+   // equal elements sit next to each other in the positions
+   void test_orderStatistic_duplicates()
+   {  // setup
+      custom::BST <int, custom::AVL, std::less<int>, std::allocator<int>, custom::OrderStatistic> bst
+         { 5, 1, 5, 9, 5, 3, 9 };
+      // exercise and verify
+      assertUnit(bst.rank(5) == 2);            // 1, 3
+      assertUnit(bst.count_range(5, 6) == 3);
+      assertUnit(bst.count_range(5, 6) == bst.count(5));
+      assertUnit(bst.select(2) == 5 && bst.select(4) == 5 && bst.select(5) == 9);
+      assertUnit(verifySizes(bst.root) == 7);
+   }  // teardown
+
+   // every policy keeps the sizes right through its rotations and rebuilds
+   void test_orderStatistic_policies()
+   {
+      assertUnit(orderStatisticHolds<custom::Unbalanced>());
+      assertUnit(orderStatisticHolds<custom::RedBlack>());
+      assertUnit(orderStatisticHolds<custom::AVL>());
+      assertUnit(orderStatisticHolds<custom::Treap>());
+      assertUnit(orderStatisticHolds<custom::Scapegoat>());
+      assertUnit(orderStatisticHolds<custom::Splay>());
+      assertUnit(orderStatisticHolds<custom::PackedRedBlack>());
+   }
+
+   // a tree built from sorted data, copied or swapped has its sizes too
+   void test_orderStatistic_bulk()
+   {  // setup
+      using Tree = custom::BST <int, custom::RedBlack, std::less<int>, std::allocator<int>, custom::OrderStatistic>;
+      std::vector<int> values;
+      for (int i = 0; i < 1000; i++)
+         values.push_back(i);
+      Tree bstSorted;
+      Tree bstCopy { 7, 8, 9 };
+      // exercise
+      bstSorted.assign_sorted(values.begin(), values.end());
+      bstCopy = bstSorted;
+      bstSorted.pop_front();
+      // verify
+      assertUnit(verifySizes(bstSorted.root) == 999);
+      assertUnit(verifySizes(bstCopy.root) == 1000);
+      assertUnit(bstCopy.select(990) == 990);  // the 99th percentile
+      assertUnit(bstSorted.select(990) == 991);
+      assertUnit(bstCopy.rank(250) == 250);
+   }  // teardown
+
+   /***************************************
+    * Aggregates
+    *    BST::aggregate()
+    *    BST::aggregate(lo, hi)
+    ***************************************/
+
+   // the total of any window, without visiting the window
+   void test_aggregate_sumWindows()
+   {  // setup
+      custom::BST <int, custom::RedBlack, std::less<int>, std::allocator<int>,
+                   custom::Aggregate<custom::Sum<long>>> bst;
+      for (int i = 0; i < 200; i++)
+         bst.insert((i * 73) % 200);
+      // exercise and verify
+      assertUnit(bst.aggregate() == 199L * 200 / 2);
+      assertUnit(bst.aggregate(10, 20) == 145); // 10 through 19
+      assertUnit(bst.aggregate(0, 1) == 0);
+      assertUnit(bst.aggregate(199, 500) == 199);
+      assertUnit(bst.aggregate(50, 50) == 0);
+      assertUnit(bst.aggregate(60, 50) == 0);
+      assertUnit(bst.aggregate(-10, 1000) == bst.aggregate());
+      assertUnit(bst.count_range(10, 20) == 10);   // it still counts
+   }  // teardown
+
+   // the pieces are put together in order
+   void test_aggregate_order()
+   {  // setup
+      custom::BST <std::string, custom::AVL, std::less<std::string>, std::allocator<std::string>,
+                   custom::Aggregate<Concatenate>> bst;
+      for (const char * s : { "d", "b", "f", "a", "c", "e", "g", "h" })
+         bst.insert(std::string(s));
+      // exercise and verify
+      assertUnit(bst.aggregate() == "abcdefgh");
+      assertUnit(bst.aggregate(std::string("b"), std::string("g")) == "bcdef");
+      assertUnit(bst.aggregate(std::string("bb"), std::string("z")) == "cdefgh");
+   }  // teardown
+
+   // the aggregates follow the elements out of the tree
+   void test_aggregate_minAfterErase()
+   {  // setup
+      custom::BST <int, custom::Treap, std::less<int>, std::allocator<int>,
+                   custom::Aggregate<custom::Min<int>>> bst { 50, 30, 70, 20, 40, 60, 80 };
+      // exercise
+      bst.pop_front();
+      auto it = bst.find(60);
+      bst.erase(it);
+      // verify
+      assertUnit(bst.aggregate() == 30);
+      assertUnit(bst.aggregate(55, 100) == 70);
+      assertUnit(bst.aggregate(81, 100) == std::numeric_limits<int>::max());
+   }  // teardown
+
+   // every policy keeps the aggregates right through its rotations and rebuilds
+   void test_aggregate_policies()
+   {
+      assertUnit(aggregateHolds<custom::Unbalanced>());
+      assertUnit(aggregateHolds<custom::RedBlack>());
+      assertUnit(aggregateHolds<custom::AVL>());
+      assertUnit(aggregateHolds<custom::Treap>());
+      assertUnit(aggregateHolds<custom::Scapegoat>());
+      assertUnit(aggregateHolds<custom::Splay>());
+      assertUnit(aggregateHolds<custom::PackedRedBlack>());
+   }
+
+
+   /**************************************************************
+    * SETUP STANDARD FIXTURE
+    *                (50) 
+    *          +-------+-------+
+    *        (30)            (70) 
+    *     +----+----+     +----+----+
+    *   (20)      (40)  (60)      (80) 
+    *************************************************************/
+   void setupStandardFixture(custom::BST <Spy>& bst)
+   {
+      // make sure that bst is clean
+      assertUnit(bst.numElements == 0);
+      assertUnit(bst.root == nullptr);
+
+      // allocate
+      custom::BST<Spy>::BNode* p20 = bst.pool.create(Spy(20));
+      custom::BST<Spy>::BNode* p30 = bst.pool.create(Spy(30));
+      custom::BST<Spy>::BNode* p40 = bst.pool.create(Spy(40));
+      custom::BST<Spy>::BNode* p50 = bst.pool.create(Spy(50));
+      custom::BST<Spy>::BNode* p60 = bst.pool.create(Spy(60));
+      custom::BST<Spy>::BNode* p70 = bst.pool.create(Spy(70));
+      custom::BST<Spy>::BNode* p80 = bst.pool.create(Spy(80));
+
+      // hook up the pointers down
+      p30->pLeft  = p20;
+      p30->pRight = p40;
+      p50->pLeft  = p30;
+      p50->pRight = p70;
+      p70->pLeft  = p60;
+      p70->pRight = p80;
+
+      // hook up the pointers up
+      p20->pParent = p40->pParent = p30;
+      p30->pParent = p70->pParent = p50;
+      p60->pParent = p80->pParent = p70;
+
+      // now assign everything to the bst
+      bst.root = p50;
+      bst.leftmost = p20;
+      bst.rightmost = p80;
+      bst.numElements = 7;
+   }
+
+   /**************************************************************
+    * VERIFY EMPTY FIXTURE
+    *************************************************************/
+   void assertEmptyFixtureParameters(const custom::BST <Spy>& bst, int line, const char* function)
+   {
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.numElements == 0);
+   }
+
+   /**************************************************************
+    * VERIFY STANDARD FIXTURE
+    *                (50) 
+    *          +-------+-------+
+    *        (30)            (70) 
+    *     +----+----+     +----+----+
+    *   (20)      (40)  (60)      (80) 
+    *************************************************************/
+   void assertStandardFixtureParameters(const custom::BST <Spy>& bst, int line, const char* function)
+   {
+      // verify the member variables
+      assertIndirect(bst.numElements == 7);
+      assertIndirect(bst.root != nullptr);
+
+      // verify the pointers down
+      assertIndirect(bst.root != nullptr);
+      if (bst.root)
+      {
+         assertIndirect(bst.root->data == Spy(50));
+         assertIndirect(bst.root->pParent == nullptr);
+         assertIndirect(bst.root->pLeft != nullptr);
+         if (bst.root->pLeft)
+         {
+            assertIndirect(bst.root->pLeft->data == Spy(30));
+            assertIndirect(bst.root->pLeft->pParent == bst.root);
+            assertIndirect(bst.root->pLeft->pLeft != nullptr);
+            if (bst.root->pLeft->pLeft)
+            {
+               assertIndirect(bst.root->pLeft->pLeft->data == Spy(20));
+               assertIndirect(bst.root->pLeft->pLeft->pParent == bst.root->pLeft);
+               assertIndirect(bst.root->pLeft->pLeft->pLeft == nullptr);
+               assertIndirect(bst.root->pLeft->pLeft->pRight == nullptr);
+            }
+            assertIndirect(bst.root->pLeft->pRight != nullptr);
+            if (bst.root->pLeft->pRight)
+            {
+               assertIndirect(bst.root->pLeft->pRight->data == Spy(40));
+               assertIndirect(bst.root->pLeft->pRight->pParent == bst.root->pLeft);
+               assertIndirect(bst.root->pLeft->pRight->pLeft == nullptr);
+               assertIndirect(bst.root->pLeft->pRight->pRight == nullptr);
+            }
+         }
+         assertIndirect(bst.root->pRight != nullptr);
+         if (bst.root->pRight)
+         {
+            assertIndirect(bst.root->pRight->data == Spy(70));
+            assertIndirect(bst.root->pRight->pParent == bst.root);
+            assertIndirect(bst.root->pRight->pLeft != nullptr);
+            if (bst.root->pRight->pLeft)
+            {
+               assertIndirect(bst.root->pRight->pLeft->data == Spy(60));
+               assertIndirect(bst.root->pRight->pLeft->pParent == bst.root->pRight);
+               assertIndirect(bst.root->pRight->pLeft->pLeft == nullptr);
+               assertIndirect(bst.root->pRight->pLeft->pRight == nullptr);
+            }
+            assertIndirect(bst.root->pRight->pRight != nullptr);
+            if (bst.root->pRight->pRight)
+            {
+               assertIndirect(bst.root->pRight->pRight->data == Spy(80));
+               assertIndirect(bst.root->pRight->pRight->pParent == bst.root->pRight);
+               assertIndirect(bst.root->pRight->pRight->pLeft == nullptr);
+               assertIndirect(bst.root->pRight->pRight->pRight == nullptr);
+            }
+         }
+      }
+   }
+
+
+   /**************************************************************
+    * TEARDOWN STANDARD FIXTURE
+    *                 ( )
+    *          +-------+-------+
+    *         ( )             ( )
+    *     +----+----+     +----+----+
+    *    ( )       ( )   ( )       ( )
+    *************************************************************/
+   void teardownStandardFixture(custom::BST <Spy>& bst)
+   {
+      if (bst.root)
+      {
+         if (bst.root->pLeft && bst.root->pLeft != bst.root)
+         {
+            if (bst.root->pLeft->pLeft && bst.root->pLeft->pLeft != bst.root->pLeft && bst.root->pLeft->pLeft != bst.root)
+               bst.pool.destroy(bst.root->pLeft->pLeft);
+            if (bst.root->pLeft->pRight && bst.root->pLeft->pRight != bst.root->pLeft && bst.root->pLeft->pRight != bst.root)
+               bst.pool.destroy(bst.root->pLeft->pRight);
+            bst.pool.destroy(bst.root->pLeft);
+         }
+         if (bst.root->pRight && bst.root->pRight != bst.root)
+         {
+            if (bst.root->pRight->pLeft && bst.root->pRight->pLeft != bst.root->pRight && bst.root->pRight->pLeft != bst.root)
+               bst.pool.destroy(bst.root->pRight->pLeft);
+            if (bst.root->pRight->pRight && bst.root->pRight->pRight != bst.root->pRight && bst.root->pRight->pRight != bst.root)
+               bst.pool.destroy(bst.root->pRight->pRight);
+
+            bst.pool.destroy(bst.root->pRight);
+         }
+         bst.pool.destroy(bst.root);
+      }
+      bst.root = nullptr;
+      bst.leftmost = bst.rightmost = nullptr;
+      bst.numElements = 0;
+   }
+
+
+   /**************************************************************
+    * VERIFY RED BLACK
+    * Return the black height of the subtree, or -1 if any of the
+    * red-black properties are violated. Balance says where the
+    * colors are kept.
+    *************************************************************/
+   template <class Balance = custom::RedBlack, class Node>
+   int verifyRedBlack(const Node* pNode, const Node* pParent = nullptr)
+   {
+      if (!pNode)
+         return 1;
+      if (pNode->pParent != pParent)
+         return -1;
+      if (!pParent && Balance::isRed(pNode))
+         return -1;
+      if (pParent && Balance::isRed(pParent) && Balance::isRed(pNode))
+         return -1;
+      int left = verifyRedBlack<Balance>(pNode->pLeft, pNode);
+      int right = verifyRedBlack<Balance>(pNode->pRight, pNode);
+      if (left < 0 || left != right)
+         return -1;
+      return left + (Balance::isRed(pNode) ? 0 : 1);
+   }
+
+   /**************************************************************
+    * VERIFY AVL
+    * Return the height of the subtree, or -1 if a cached height is
+    * wrong or the children differ by more than one
+    *************************************************************/
+   template <class Node>
+   int verifyAVL(const Node* pNode)
+   {
+      if (!pNode)
+         return 0;
+      int left = verifyAVL(pNode->pLeft);
+      int right = verifyAVL(pNode->pRight);
+      if (left < 0 || right < 0 || left - right > 1 || right - left > 1)
+         return -1;
+      int h = 1 + (left > right ? left : right);
+      return (h == pNode->height) ? h : -1;
+   }
+
+   /**************************************************************
+    * VERIFY SIZES
+    * Does every node count its subtree right? The size of the
+    * tree, or -1 if not.
+    *************************************************************/
+   template <class Node>
+   long verifySizes(const Node* pNode)
+   {
+      if (!pNode)
+         return 0;
+      long left = verifySizes(pNode->pLeft);
+      long right = verifySizes(pNode->pRight);
+      if (left < 0 || right < 0 || (long)pNode->size != left + right + 1)
+         return -1;
+      return left + right + 1;
+   }
+
+   /***************************************
+    * SPLIT AND JOIN
+    *    BST::split()    BST::join()
+    ***************************************/
+
+   // the nodes change trees; nothing is copied or made
+   void test_split_standard()
+   {  // setup
+      custom::BST <Spy> bst { Spy(50), Spy(30), Spy(70), Spy(20), Spy(40), Spy(60), Spy(80) };
+      Spy key(45);
+      auto p40 = bst.find(Spy(40)).pNode;
+      auto p60 = bst.find(Spy(60)).pNode;
+      Spy::reset();
+      // exercise
+      auto bstUpper = bst.split(key);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(bst.size() == 3);
+      assertUnit(bstUpper.size() == 4);
+      assertUnit(bst.front() == Spy(20) && bst.back() == Spy(40));
+      assertUnit(bstUpper.front() == Spy(50) && bstUpper.back() == Spy(80));
+      assertUnit(bst.rightmost == p40);
+      assertUnit(bstUpper.find(Spy(60)).pNode == p60);
+      assertUnit(verifyRedBlack(bst.root) > 0);
+      assertUnit(verifyRedBlack(bstUpper.root) > 0);
+   }  // teardown
+
+   // everything equal to the key goes up, whatever the order it came in
+   void test_split_duplicates()
+   {  // setup
+      custom::BST <int> bst { 5, 3, 5, 7, 5, 1 };
+      // exercise
+      auto bstUpper = bst.split(5);
+      auto bstNone = bstUpper.split(100);
+      auto bstAll = bst.split(-100);
+      // verify
+      assertUnit(bst.empty() && bst.begin() == bst.end());
+      assertUnit(isSequence(bstAll, 1, 2, 2));   // 1, 3
+      assertUnit(bstUpper.size() == 4 && bstUpper.count(5) == 3 && bstUpper.back() == 7);
+      assertUnit(bstNone.empty());
+   }  // teardown
+
+   // the split-off tree keeps its nodes after the tree they came from is gone
+   void test_split_outlivesSource()
+   {  // setup
+      custom::BST <std::string, custom::AVL> bstUpper;
+      {
+         custom::BST <std::string, custom::AVL> bst;
+         for (int i = 0; i < 100; i++)
+            bst.insert(std::string(20, (char)('a' + i % 26)) + std::to_string(i));
+         // exercise
+         bstUpper = bst.split(std::string("n"));
+         bst.insert(std::string("extra"));
+      }
+      // verify
+      bstUpper.insert(std::string("zz"));
+      auto it = bstUpper.begin();
+      bstUpper.erase(it);
+      assertUnit(bstUpper.size() == 48);
+      assertUnit(bstUpper.contains("zz"));
+      assertUnit(verifyAVL(bstUpper.root) > 0);
+   }  // teardown
+
+   // the two go back together, and the emptied tree can be used again
+   void test_join_standard()
+   {  // setup
+      custom::BST <Spy> bst { Spy(50), Spy(30), Spy(20) };
+      custom::BST <Spy> bstUpper { Spy(70), Spy(60), Spy(80), Spy(90), Spy(65) };
+      Spy::reset();
+      // exercise
+      bst.join(bstUpper);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(bst.size() == 8);
+      assertUnit(bstUpper.empty() && bstUpper.begin() == bstUpper.end());
+      assertUnit(bst.front() == Spy(20) && bst.back() == Spy(90));
+      assertUnit(verifyRedBlack(bst.root) > 0);
+      std::vector<int> inOrder;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         inOrder.push_back(it->get());
+      assertUnit(inOrder == std::vector<int>({ 20, 30, 50, 60, 65, 70, 80, 90 }));
+      // exercise
+      bst.join(bstUpper);    // nothing to join
+      bstUpper.join(bst);    // joined onto an empty tree
+      bstUpper.insert(Spy(1));
+      // verify
+      assertUnit(bstUpper.size() == 9 && bst.empty());
+      assertUnit(bstUpper.front() == Spy(1));
+   }  // teardown
+
+   // sizes and aggregates come along without counting
+   void test_join_counts()
+   {  // setup
+      custom::BST <int, custom::RedBlack, std::less<int>, std::allocator<int>, custom::Aggregate<custom::Sum<long>>> bst;
+      for (int i = 1; i <= 100; i++)
+         bst.insert((i * 37) % 101);
+      // exercise
+      auto bstUpper = bst.split(60);
+      // verify
+      assertUnit(bst.size() == 59 && bstUpper.size() == 41);
+      assertUnit(verifySizes(bst.root) == 59 && verifySizes(bstUpper.root) == 41);
+      assertUnit(bst.aggregate() == 59 * 60 / 2);
+      assertUnit(bst.select(58) == 59 && bstUpper.select(0) == 60);
+      // exercise
+      bst.join(bstUpper);
+      // verify
+      assertUnit(verifySizes(bst.root) == 100);
+      assertUnit(bst.aggregate() == 100 * 101 / 2);
+      assertUnit(bst.aggregate(50, 70) == (50 + 69) * 20 / 2);
+   }  // teardown
+
+   // every policy can be split anywhere and joined back, and stays itself
+   void test_split_policies()
+   {
+      auto any = [](const void*) { return true; };
+      assertUnit(splitJoinHolds<custom::Unbalanced>(any));
+      assertUnit(splitJoinHolds<custom::RedBlack>([this](auto* p) { return verifyRedBlack(p) > 0; }));
+      assertUnit(splitJoinHolds<custom::AVL>([this](auto* p) { return verifyAVL(p) >= 0; }));
+      assertUnit(splitJoinHolds<custom::Treap>([this](auto* p) { return verifyHeap(p); }));
+      assertUnit(splitJoinHolds<custom::Scapegoat>([this](auto* p) { return height(p) <= 30; }));
+      assertUnit(splitJoinHolds<custom::Splay>(any));
+      assertUnit(splitJoinHolds<custom::PackedRedBlack>([this](auto* p) { return verifyRedBlack<custom::PackedRedBlack>(p) > 0; }));
+   }  // teardown
+
+   // trees split and joined over and over end up in one group of
+   // chunks, which holds nobody who let go and grows no bigger
+   void test_split_reshard()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstSpare;
+      for (int i = 0; i < 1000; i++)
+         bst.insert(i);
+      bstSpare.insert(1000);
+      size_t numChunks = numChunksOf(bst.pool) + numChunksOf(bstSpare.pool);
+      // exercise
+      for (int i = 0; i < 5000; i++)
+      {
+         auto bstUpper = bst.split((i * 7919) % 1000);
+         bstUpper.join(bstSpare);
+         bst.join(bstUpper);
+         bstSpare = bst.split(1000);
+      }
+      // verify
+      assertUnit(bst.size() == 1000 && bstSpare.size() == 1);
+      assertUnit(bst.front() == 0 && bst.back() == 999 && bstSpare.front() == 1000);
+      auto pGroup = bst.pool.group();
+      assertUnit(pGroup != nullptr && pGroup->pParent == nullptr);
+      assertUnit(bstSpare.pool.group() == pGroup);
+      assertUnit(pGroup->refs == 2);    // bst and bstSpare, no one else
+      assertUnit(numChunksOf(bst.pool) + numChunksOf(bstSpare.pool, false) == numChunks);
+      assertUnit(verifyRedBlack(bst.root) > 0);
+   }  // teardown
+
+   // the slots of a half split off and thrown away are used again
+   // by the tree that is left, so its chunks do not pile up
+   void test_split_discardHalf()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert(i);
+      { auto bstUpper = bst.split(500); }
+      for (int i = 500; i < 1000; i++)
+         bst.insert(i);
+      size_t numChunks = numChunksOf(bst.pool);
+      // exercise
+      for (int round = 0; round < 50; round++)
+      {
+         { auto bstUpper = bst.split(500); }
+         for (int i = 500; i < 1000; i++)
+            bst.insert(i);
+      }
+      // verify
+      assertUnit(bst.size() == 1000 && bst.front() == 0 && bst.back() == 999);
+      assertUnit(numChunksOf(bst.pool) == numChunks);
+      assertUnit(verifyRedBlack(bst.root) > 0);
+   }  // teardown
+
+   // a tree joined into an empty one keeps its own comparator, and
+   // the two share their chunks rather than swapping them
+   void test_join_intoEmpty()
+   {  // setup
+      custom::BST <int, custom::RedBlack, TaggedLess> bst(TaggedLess{ 1 });
+      custom::BST <int, custom::RedBlack, TaggedLess> bstUpper(TaggedLess{ 2 });
+      custom::BST <int, custom::RedBlack, TaggedLess> bstUnited(TaggedLess{ 3 });
+      custom::BST <int, custom::RedBlack, TaggedLess> bstOther(TaggedLess{ 4 });
+      for (int i = 0; i < 100; i++)
+      {
+         bstUpper.insert(i);
+         bstOther.insert(i);
+      }
+      auto pFifty = bstUpper.find(50).pNode;
+      // exercise
+      bst.join(bstUpper);
+      bstUnited.unite(bstOther);
+      // verify
+      assertUnit(bst.key_comp().tag == 1 && bstUpper.key_comp().tag == 2);
+      assertUnit(bstUnited.key_comp().tag == 3 && bstOther.key_comp().tag == 4);
+      assertUnit(bst.size() == 100 && bstUpper.empty() && bstUpper.begin() == bstUpper.end());
+      assertUnit(bstUnited.size() == 100 && bstOther.empty());
+      assertUnit(bst.find(50).pNode == pFifty);
+      assertUnit(bst.pool.group() != nullptr && bst.pool.group() == bstUpper.pool.group());
+      assertUnit(bstUnited.pool.group() == bstOther.pool.group());
+      bstUpper.insert(7);
+      assertUnit(bstUpper.size() == 1 && bst.size() == 100);
+      assertUnit(verifyRedBlack(bst.root) > 0);
+   }  // teardown
+
+   // a comparator that throws leaves the tree as it was
+   void test_split_throws()
+   {  // setup
+      custom::BST <Spy, custom::RedBlack, ThrowingLess> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(Spy(i));
+      bool thrown = false;
+      // exercise
+      ThrowingLess::numLeft = 3;
+      try
+      {
+         bst.split(Spy(50));
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      ThrowingLess::numLeft = -1;
+      // verify
+      assertUnit(thrown);
+      assertUnit(bst.size() == 100 && std::distance(bst.begin(), bst.end()) == 100);
+      assertUnit(bst.front() == Spy(0) && bst.back() == Spy(99));
+      assertUnit(verifyRedBlack(bst.root) > 0);
+   }  // teardown
+
+   /***************************************
+    * SET ALGEBRA
+    *     BST::unite(BST &)
+    *     BST::intersect(const BST &)
+    *     BST::subtract(const BST &)
+    *     set_union(), set_intersection(), set_difference()
+    ***************************************/
+
+   // the nodes of rhs move over, and only the repeat is destroyed
+   void test_unite_standard()
+   {  // setup
+      custom::BST <Spy> bst { Spy(40), Spy(20), Spy(30), Spy(10) };
+      custom::BST <Spy> bstOther { Spy(30), Spy(50), Spy(5) };
+      auto p30 = bst.find(Spy(30)).pNode;
+      Spy::reset();
+      // exercise
+      bst.unite(bstOther);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDestructor() == 1);     // the other [30]
+      assertUnit(bstOther.empty() && bstOther.begin() == bstOther.end());
+      assertUnit(bst.size() == 6);
+      assertUnit(bst.find(Spy(30)).pNode == p30);
+      assertUnit(bst.front() == Spy(5) && bst.back() == Spy(50));
+      assertUnit(verifyRedBlack(bst.root) > 0);
+      assertUnit(verifyParents(bst.root, decltype(bst.root)()));
+   }  // teardown
+
+   // only what both have is left, and the other tree is only read
+   void test_intersect_standard()
+   {  // setup
+      custom::BST <int> bst { 50, 30, 70, 20, 40, 60, 80 };
+      custom::BST <int> bstOther { 10, 30, 60, 65, 80, 90 };
+      // exercise
+      bst.intersect(bstOther);
+      // verify
+      assertUnit(std::vector<int>(bst.begin(), bst.end()) == std::vector<int>({ 30, 60, 80 }));
+      assertUnit(bst.size() == 3);
+      assertUnit(bstOther.size() == 6);
+      assertUnit(verifyRedBlack(bst.root) > 0);
+      // exercise
+      bst.intersect(custom::BST <int>());
+      // verify
+      assertUnit(bst.empty() && bst.begin() == bst.end());
+   }  // teardown
+
+   // what the other tree has goes, and the other tree is only read
+   void test_subtract_standard()
+   {  // setup
+      custom::BST <int, custom::AVL> bst { 50, 30, 70, 20, 40, 60, 80 };
+      custom::BST <int, custom::AVL> bstOther { 10, 30, 60, 65, 80, 90 };
+      // exercise
+      bst.subtract(bstOther);
+      // verify
+      assertUnit(std::vector<int>(bst.begin(), bst.end()) == std::vector<int>({ 20, 40, 50, 70 }));
+      assertUnit(bst.front() == 20 && bst.back() == 70);
+      assertUnit(bstOther.size() == 6);
+      assertUnit(verifyAVL(bst.root) > 0);
+      // exercise
+      bst.subtract(bst);
+      // verify
+      assertUnit(bst.empty());
+   }  // teardown
+
+   // the copying versions leave both trees alone
+   void test_setAlgebra_copies()
+   {  // setup
+      custom::BST <Spy> bstLeft { Spy(1), Spy(2), Spy(3), Spy(4) };
+      custom::BST <Spy> bstRight { Spy(3), Spy(4), Spy(5) };
+      Spy::reset();
+      // exercise
+      auto bstUnion = set_union(bstLeft, bstRight);
+      auto bstIntersection = set_intersection(bstLeft, bstRight);
+      auto bstDifference = set_difference(bstLeft, bstRight);
+      // verify
+      assertUnit(Spy::numCopy() == 7 + 3 + 4);  // both, the smaller, lhs
+      assertUnit(bstLeft.size() == 4 && bstRight.size() == 3);
+      assertUnit(bstUnion.size() == 5 && bstUnion.front() == Spy(1) && bstUnion.back() == Spy(5));
+      assertUnit(bstIntersection.size() == 2 && bstIntersection.front() == Spy(3));
+      assertUnit(bstDifference.size() == 2 && bstDifference.back() == Spy(2));
+   }  // teardown
+
+   // sizes and aggregates are right after every operation
+   void test_setAlgebra_counts()
+   {  // setup
+      using Tree = custom::BST <int, custom::RedBlack, std::less<int>, std::allocator<int>, custom::Aggregate<custom::Sum<long>>>;
+      Tree bstEvens;
+      Tree bstThrees;
+      for (int i = 0; i < 300; i++)
+      {
+         bstEvens.insert(i * 2);
+         bstThrees.insert(i * 3);
+      }
+      // exercise
+      Tree bstSixes = set_intersection(bstEvens, bstThrees);
+      Tree bstRest = set_difference(bstThrees, bstEvens);
+      bstEvens.unite(bstThrees);
+      // verify
+      assertUnit(bstSixes.size() == 100 && verifySizes(bstSixes.root) == 100);
+      assertUnit(bstSixes.aggregate() == 6L * 99 * 100 / 2);
+      assertUnit(bstRest.size() == 200 && verifySizes(bstRest.root) == 200);
+      assertUnit(bstEvens.size() == 500 && verifySizes(bstEvens.root) == 500);
+      assertUnit(bstEvens.select(499) == 897 && bstEvens.rank(300) == 200);
+   }  // teardown
+
+   // a comparator that throws halfway leaves the trees empty, and
+   // every element destroyed
+   void test_setAlgebra_throws()
+   {  // setup
+      using Tree = custom::BST <Spy, custom::RedBlack, ThrowingLess>;
+      for (int op = 0; op < 3; op++)
+      {
+         Spy::reset();
+         bool thrown = false;
+         {
+            Tree bst;
+            Tree bstOther;
+            for (int i = 0; i < 200; i++)
+               bst.insert(Spy(i * 2));
+            for (int i = 0; i < 100; i++)
+               bstOther.insert(Spy(i * 3));
+            // exercise
+            ThrowingLess::numLeft = 150;
+            try
+            {
+               if (op == 0)
+                  bst.unite(bstOther);
+               else if (op == 1)
+                  bst.intersect(bstOther);
+               else
+                  bst.subtract(bstOther);
+            }
+            catch (const std::runtime_error &)
+            {
+               thrown = true;
+            }
+            ThrowingLess::numLeft = -1;
+            // verify
+            assertUnit(bst.empty() && bst.begin() == bst.end());
+            assertUnit(op == 0 ? bstOther.empty() : bstOther.size() == 100);
+            bst.insert(Spy(5));
+            assertUnit(bst.size() == 1 && bst.front() == Spy(5));
+         }
+         assertUnit(thrown);
+         assertUnit(Spy::numAlloc() == Spy::numDelete());
+      }
+   }  // teardown
+
+   // large trees give the same answers when worked on in parallel
+   void test_setAlgebra_parallel()
+   {  // setup
+      custom::BST <int> bstLeft;
+      custom::BST <int> bstRight;
+      for (int i = 0; i < 30000; i++)
+      {
+         bstLeft.insert((i * 7919) % 30000 * 2);
+         if (i < 20000)
+            bstRight.insert((i * 7919) % 20000 * 3);
+      }
+      // exercise
+      auto bstUnion = set_union(bstLeft, bstRight, custom::Parallel());
+      auto bstIntersection = set_intersection(bstLeft, bstRight, custom::Parallel());
+      auto bstDifference = set_difference(bstLeft, bstRight, custom::Parallel());
+      // verify
+      assertUnit(std::vector<int>(bstUnion.begin(), bstUnion.end()) ==
+                 std::vector<int>(set_union(bstLeft, bstRight).begin(), set_union(bstLeft, bstRight).end()));
+      assertUnit(bstUnion.size() == 30000 + 20000 - 10000);
+      assertUnit(bstIntersection.size() == 10000 && bstIntersection.back() == 59994);
+      assertUnit(bstDifference.size() == 20000 && bstDifference.front() == 2);
+      assertUnit(verifyRedBlack(bstUnion.root) > 0);
+      assertUnit(verifyRedBlack(bstIntersection.root) > 0);
+      assertUnit(verifyRedBlack(bstDifference.root) > 0);
+   }  // teardown
+
+   // every policy gets the answers std::set_union and the rest get, and stays itself
+   void test_setAlgebra_policies()
+   {
+      auto any = [](const void*) { return true; };
+      assertUnit(setAlgebraHolds<custom::Unbalanced>(any));
+      assertUnit(setAlgebraHolds<custom::RedBlack>([this](auto* p) { return verifyRedBlack(p) > 0; }));
+      assertUnit(setAlgebraHolds<custom::AVL>([this](auto* p) { return verifyAVL(p) >= 0; }));
+      assertUnit(setAlgebraHolds<custom::Treap>([this](auto* p) { return verifyHeap(p); }));
+      assertUnit(setAlgebraHolds<custom::Scapegoat>([this](auto* p) { return height(p) <= 40; }));
+      assertUnit(setAlgebraHolds<custom::Splay>(any));
+      assertUnit(setAlgebraHolds<custom::PackedRedBlack>([this](auto* p) { return verifyRedBlack<custom::PackedRedBlack>(p) > 0; }));
+   }  // teardown
+
+   /***************************************
+    * NODE HANDLES
+    *     BST::extract(iterator)
+    *     BST::extract(const T &)
+    *     BST::insert(node_type &&)
+    *     BST::merge(BST &)
+    ***************************************/
+
+   // a new key for an element: the same node goes back where it now belongs
+   void test_extract_rekey()
+   {  // setup
+      custom::BST <Spy> bst { Spy(50), Spy(30), Spy(70), Spy(20), Spy(40), Spy(60), Spy(80) };
+      auto p30 = bst.find(Spy(30)).pNode;
+      Spy key(30);
+      Spy::reset();
+      // exercise
+      auto node = bst.extract(key);
+      node.value().set(65);
+      auto result = bst.insert(std::move(node));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(result.inserted && result.node.empty());
+      assertUnit(result.position.pNode == p30 && *result.position == Spy(65));
+      assertUnit(bst.size() == 7);
+      assertUnit(bst.front() == Spy(20));
+      assertUnit(*std::next(bst.begin(), 4) == Spy(65));
+      assertUnit(verifyRedBlack(bst.root) > 0);
+      assertUnit(verifyParents(bst.root, decltype(bst.root)()));
+   }  // teardown
+
+   // nothing to take out gives an empty handle, which inserts nothing
+   void test_extract_missing()
+   {  // setup
+      custom::BST <int> bst { 5, 3, 8 };
+      // exercise
+      auto nodeEnd = bst.extract(bst.end());
+      auto nodeMissing = bst.extract(4);
+      auto result = bst.insert(std::move(nodeMissing));
+      // verify
+      assertUnit(nodeEnd.empty() && !nodeMissing);
+      assertUnit(!result.inserted && result.position == bst.end() && result.node.empty());
+      assertUnit(bst.size() == 3);
+   }  // teardown
+
+   // a node moves to another tree, and outlives the tree it came from
+   void test_extract_otherTree()
+   {  // setup
+      using Tree = custom::BST <std::string, custom::AVL, std::less<std::string>, std::allocator<std::string>, custom::OrderStatistic>;
+      Tree bstDest { "b", "d", "f" };
+      {
+         Tree bstSrc { "a", "c", "e", "g" };
+         // exercise
+         auto node = bstSrc.extract(bstSrc.find("e"));
+         node.value() += "e";
+         bstDest.insert(bstDest.end(), std::move(node));
+         assertUnit(bstSrc.size() == 3 && verifySizes(bstSrc.root) == 3);
+      }
+      // verify
+      assertUnit(bstDest.size() == 4 && verifySizes(bstDest.root) == 4);
+      assertUnit(bstDest.select(3) == "f" && bstDest.rank("ee") == 2);
+      assertUnit(verifyAVL(bstDest.root) > 0);
+      bstDest.insert(std::string("h"));
+      assertUnit(bstDest.back() == "h");
+   }  // teardown
+
+   // a handle that is let go of destroys its element
+   void test_extract_drop()
+   {  // setup
+      custom::BST <Spy> bst { Spy(50), Spy(30), Spy(70) };
+      Spy::reset();
+      // exercise
+      {
+         auto node = bst.extract(bst.begin());
+         auto nodeMoved = std::move(node);
+         assertUnit(node.empty() && nodeMoved.value() == Spy(30));
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 2);  // [30] and the one to compare
+      assertUnit(bst.size() == 2 && bst.front() == Spy(50));
+   }  // teardown
+
+   // a handle keeps its node after the tree it came from is gone,
+   // whether it goes on to another tree or is let go of
+   void test_extract_outlivesTree()
+   {  // setup
+      custom::BST <Spy> bstDest { Spy(10), Spy(90) };
+      custom::BST <Spy>::node_type node;
+      custom::BST <Spy>::node_type nodeDropped;
+      {
+         custom::BST <Spy> bstSrc;
+         for (int i = 1; i <= 100; i++)
+            bstSrc.insert(Spy(i));
+         node = bstSrc.extract(bstSrc.find(Spy(50)));
+         nodeDropped = bstSrc.extract(bstSrc.begin());
+      }
+      // exercise
+      node.value().set(55);
+      auto result = bstDest.insert(std::move(node));
+      Spy::reset();
+      nodeDropped = custom::BST <Spy>::node_type();
+      int numDropped = Spy::numDestructor();
+      bstDest.insert(Spy(20));
+      // verify
+      assertUnit(result.inserted && *result.position == Spy(55));
+      assertUnit(numDropped == 1);            // [1]
+      assertUnit(bstDest.size() == 4 && *std::next(bstDest.begin(), 2) == Spy(55));
+      assertUnit(verifyRedBlack(bstDest.root) > 0);
+   }  // teardown
+
+   // a handle keeps its node through a clear() of its tree, even one
+   // that gives the chunks back without destroying anything
+   void test_extract_outlivesClear()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <std::string> bstString;
+      for (int i = 0; i < 100; i++)
+      {
+         bst.insert(i);
+         bstString.insert(std::string(30, 'x') + std::to_string(i));
+      }
+      // exercise
+      auto node = bst.extract(bst.find(42));
+      auto nodeString = bstString.extract(bstString.begin());
+      bst.clear();
+      bstString.clear();
+      for (int i = 0; i < 100; i++)
+         bst.insert(i + 1000);
+      node.value() = 7;
+      auto result = bst.insert(std::move(node));
+      // verify
+      assertUnit(result.inserted && bst.size() == 101 && bst.front() == 7);
+      assertUnit(nodeString.value() == std::string(30, 'x') + "0");
+      assertUnit(bstString.empty());
+      assertUnit(verifyRedBlack(bst.root) > 0);
+   }  // teardown
+
+   // the slot of a node let go of in its handle is used again
+   void test_extract_dropReused()
+   {  // setup
+      custom::BST <int> bst { 50, 30, 70 };
+      auto p30 = bst.find(30).pNode;
+      // exercise
+      bst.extract(bst.find(30));
+      auto itNew = bst.insert(40).first;
+      // verify
+      assertUnit(itNew.pNode == p30 && *itNew == 40);
+      assertUnit(bst.size() == 3);
+   }  // teardown
+
+   // a node moved to another tree that is then cleared leaves its
+   // slot for the tree it came from, however often that happens
+   void test_extract_clearedElsewhere()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstOther;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i);
+      bstOther.insert(bst.extract(bst.find(0)));
+      bstOther.clear();
+      bst.insert(0);
+      size_t numChunks = numChunksOf(bst.pool);
+      // exercise
+      for (int round = 0; round < 1000; round++)
+      {
+         bstOther.insert(bst.extract(bst.find(round % 100)));
+         bstOther.clear();
+         bst.insert(round % 100);
+      }
+      // verify
+      assertUnit(bst.size() == 100 && bst.front() == 0 && bst.back() == 99);
+      assertUnit(numChunksOf(bst.pool) == numChunks);
+      assertUnit(bstOther.empty());
+   }  // teardown
+
+   // with keepUnique, a node whose element is there already comes back
+   void test_insert_nodeDuplicate()
+   {  // setup
+      custom::BST <int> bst { 5, 3, 8 };
+      custom::BST <int> bstOther { 8, 9 };
+      // exercise
+      auto result = bst.insert(bstOther.extract(8), true /* keepUnique */);
+      // verify
+      assertUnit(!result.inserted);
+      assertUnit(result.position == bst.find(8));
+      assertUnit(!result.node.empty() && result.node.value() == 8);
+      assertUnit(bst.size() == 3 && bstOther.size() == 1);
+      // exercise
+      auto it = bst.insert(bst.end(), std::move(result.node));
+      // verify
+      assertUnit(it != bst.end() && *it == 8 && bst.count(8) == 2);
+   }  // teardown
+
+   // every node moves over, repeats and all
+   void test_merge_standard()
+   {  // setup
+      custom::BST <Spy, custom::Treap> bst { Spy(50), Spy(30), Spy(70) };
+      custom::BST <Spy, custom::Treap> bstOther { Spy(30), Spy(60), Spy(10), Spy(90) };
+      Spy::reset();
+      // exercise
+      bst.merge(bstOther);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(bstOther.empty() && bstOther.begin() == bstOther.end());
+      assertUnit(bst.size() == 7 && bst.count(Spy(30)) == 2);
+      assertUnit(bst.front() == Spy(10) && bst.back() == Spy(90));
+      assertUnit(verifyHeap(bst.root));
+      assertUnit(verifyParents(bst.root, decltype(bst.root)()));
+   }  // teardown
+
+   // with keepUnique, the repeats stay behind
+   void test_merge_keepUnique()
+   {  // setup
+      custom::BST <int, custom::Scapegoat> bst { 50, 30, 70 };
+      custom::BST <int, custom::Scapegoat> bstOther { 30, 60, 10, 70, 90 };
+      // exercise
+      bst.merge(bstOther, true /* keepUnique */);
+      // verify
+      assertUnit(std::vector<int>(bst.begin(), bst.end()) == std::vector<int>({ 10, 30, 50, 60, 70, 90 }));
+      assertUnit(std::vector<int>(bstOther.begin(), bstOther.end()) == std::vector<int>({ 30, 70 }));
+      assertUnit(bstOther.size() == 2 && bstOther.back() == 70);
+   }  // teardown
+
+   /***************************************
+    * REBALANCE
+    *     BST::height()
+    *     BST::rebalance()
+    *     BST::auto_rebalance(double)
+    ***************************************/
+
+   // the number of levels, counting the root
+   void test_height_standard()
+   {  // setup
+      custom::BST <int, custom::Unbalanced> bstEmpty;
+      custom::BST <int, custom::Unbalanced> bst { 50, 30, 70, 20, 40, 60, 80, 35 };
+      // exercise and verify
+      assertUnit(bstEmpty.height() == 0);
+      assertUnit(bst.height() == 4);             // [50][30][40][35]
+      auto it = bst.find(35);
+      bst.erase(it);
+      assertUnit(bst.height() == 3);
+   }  // teardown
+
+   // a vine becomes as short as it can be, with the same nodes
+   void test_rebalance_sorted()
+   {  // setup
+      custom::BST <Spy, custom::Unbalanced> bst;
+      for (int i = 1; i <= 100; i++)
+         bst.insert(Spy(i));
+      const void* pFirst = &*bst.begin();
+      Spy::reset();
+      // exercise
+      bst.rebalance();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(bst.height() == 7);             // floor(log2(100)) + 1
+      assertUnit(height(bst.root) == 7);
+      assertUnit(verifyParents(bst.root, decltype(bst.root)()));
+      assertUnit(&*bst.begin() == pFirst);
+      assertUnit(bst.size() == 100 && bst.front() == Spy(1) && bst.back() == Spy(100));
+      int expected = 1;
+      bool inOrder = true;
+      for (const Spy& spy : bst)
+         inOrder = inOrder && spy.get() == expected++;
+      assertUnit(inOrder);
+   }  // teardown
+
+   // the sizes in every node are recomputed on the new shape
+   void test_rebalance_counts()
+   {  // setup
+      using Tree = custom::BST <int, custom::Unbalanced, std::less<int>, std::allocator<int>, custom::OrderStatistic>;
+      Tree bst;
+      for (int i = 999; i >= 0; i--)
+         bst.insert(i);
+      // exercise
+      bst.rebalance();
+      // verify
+      assertUnit(height(bst.root) == 10);
+      assertUnit(verifySizes(bst.root) == 1000);
+      assertUnit(bst.rank(500) == 500);
+      assertUnit(bst.select(123) == 123);
+   }  // teardown
+
+   // every policy takes up the new shape and keeps going from there
+   void test_rebalance_policies()
+   {
+      auto any = [](const void*) { return true; };
+      assertUnit(rebalanceHolds<custom::Unbalanced>(any));
+      assertUnit(rebalanceHolds<custom::RedBlack>([this](auto* p) { return verifyRedBlack(p) > 0; }));
+      assertUnit(rebalanceHolds<custom::AVL>([this](auto* p) { return verifyAVL(p) >= 0; }));
+      assertUnit(rebalanceHolds<custom::Treap>([this](auto* p) { return verifyHeap(p); }));
+      assertUnit(rebalanceHolds<custom::Scapegoat>([this](auto* p) { return height(p) <= 30; }));
+      assertUnit(rebalanceHolds<custom::Splay>(any));
+      assertUnit(rebalanceHolds<custom::PackedRedBlack>([this](auto* p) { return verifyRedBlack<custom::PackedRedBlack>(p) > 0; }));
+   }  // teardown
+
+   // a sorted burst no longer makes a vine
+   void test_autoRebalance_sorted()
+   {  // setup
+      custom::BST <int, custom::Unbalanced> bst;
+      // exercise
+      bst.auto_rebalance(2.0);
+      for (int i = 1; i <= 4096; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(bst.height() <= 25);            // 2 log2(4096) + 1
+      assertUnit(isSequence(bst, 1, 1, 4096));
+      assertUnit(verifyParents(bst.root, decltype(bst.root)()));
+      // exercise
+      custom::BST <int, custom::Unbalanced> bstCopy;
+      bstCopy = bst;
+      for (int i = 0; i >= -4096; i--)
+         bstCopy.insert(i);
+      // verify
+      assertUnit(bstCopy.height() <= 27);        // 2 log2(8193) + 1
+      assertUnit(isSequence(bstCopy, -4096, 1, 8193));
+   }  // teardown
+
+   // every policy stays valid when the tree is rebalanced under it
+   void test_autoRebalance_policies()
+   {  // setup
+      using Tree = custom::BST <int, custom::Unbalanced, std::less<int>, std::allocator<int>, custom::OrderStatistic>;
+      Tree bstCounts;
+      custom::BST <int, custom::Treap> bstTreap;
+      bstCounts.auto_rebalance(1.5);
+      bstTreap.auto_rebalance(1.5);
+      // exercise
+      for (int i = 0; i < 2000; i++)
+      {
+         bstCounts.insert(i % 2 ? i : 4000 - i);
+         bstTreap.insert(i);
+      }
+      // verify
+      assertUnit(verifySizes(bstCounts.root) == 2000);
+      assertUnit(verifyParents(bstCounts.root, decltype(bstCounts.root)()));
+      assertUnit(bstCounts.height() <= 18);      // 1.5 log2(2000) + 1
+      assertUnit(verifyHeap(bstTreap.root));
+      assertUnit(isSequence(bstTreap, 0, 1, 2000));
+   }  // teardown
+
+   // a policy that cannot have part of the tree rebuilt has all of it
+   // rebuilt, but not on every insert: a sorted run stays linear
+   void test_autoRebalance_amortized()
+   {  // setup
+      custom::BST <int, custom::RedBlack, std::less<int>, std::allocator<int>, CountingUpdate> bst;
+      bst.auto_rebalance(1.2);
+      CountingUpdate::numUpdates = 0;
+      // exercise
+      for (int i = 0; i < 20000; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(CountingUpdate::numUpdates < 20 * 20000);
+      assertUnit(isSequence(bst, 0, 1, 20000));
+      assertUnit(verifyRedBlack(bst.root) > 0);
+   }  // teardown
+
+   // the factor stays with a tree that others join or unite into,
+   // and goes along with a tree split off
+   void test_autoRebalance_splitJoin()
+   {  // setup
+      custom::BST <int, custom::Unbalanced> bstJoined;
+      custom::BST <int, custom::Unbalanced> bstUnited;
+      custom::BST <int, custom::Unbalanced> bstSource;
+      bstJoined.auto_rebalance(2.0);
+      bstUnited.auto_rebalance(2.0);
+      bstSource.auto_rebalance(2.0);
+      custom::BST <int, custom::Unbalanced> bstLow;
+      custom::BST <int, custom::Unbalanced> bstHigh;
+      for (int i = 0; i < 1000; i++)
+      {
+         bstLow.insert(i);
+         bstHigh.insert(i + 1000);
+         bstSource.insert(i);
+      }
+      // exercise
+      bstJoined.join(bstLow);
+      bstUnited.unite(bstHigh);
+      auto bstSplit = bstSource.split(500);
+      for (int i = 0; i < 1000; i++)
+      {
+         bstJoined.insert(i + 5000);
+         bstUnited.insert(i + 5000);
+         bstSplit.insert(i + 5000);
+      }
+      // verify
+      assertUnit(bstJoined.size() == 2000 && bstJoined.height() <= 2 * 11);
+      assertUnit(bstUnited.size() == 2000 && bstUnited.height() <= 2 * 11);
+      assertUnit(bstSplit.size() == 1500 && bstSplit.height() <= 2 * 11);
+      assertUnit(bstLow.empty() && bstHigh.empty());
+   }  // teardown
+
+   /***************************************
+    * SPLAY
+    *     Splay
+    *     BST::find_and_splay(const T &)
+    ***************************************/
+
+   // whatever goes in ends up at the root
+   void test_splay_insertToRoot()
+   {  // setup
+      custom::BST <int, custom::Splay> bst;
+      // exercise
+      for (int i : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(i);
+      // verify
+      assertUnit(bst.root && bst.root->data == 80);
+      assertUnit(isSequence(bst, 20, 10, 7));
+      assertUnit(verifyParents(bst.root, decltype(bst.root)()));
+      assertUnit(bst.front() == 20 && bst.back() == 80);
+   }  // teardown
+
+   // what is looked up comes to the top, unless find() does the looking
+   void test_splay_findToRoot()
+   {  // setup
+      custom::BST <Spy, custom::Splay> bst;
+      for (int i = 1; i <= 100; i++)
+         bst.insert(Spy(i));
+      Spy key(37);
+      Spy::reset();
+      // exercise
+      auto itFind = bst.find(key);
+      bool stayed = bst.root == bst.rightmost;
+      auto it = bst.find_and_splay(key);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(stayed);
+      assertUnit(itFind == it);
+      assertUnit(it != bst.end() && *it == Spy(37));
+      assertUnit(bst.root->data == Spy(37));
+      assertUnit(verifyParents(bst.root, decltype(bst.root)()));
+      assertUnit(height(bst.root) < 100);        // the vine is folded up
+      int expected = 1;
+      bool inOrder = true;
+      for (const Spy& spy : bst)
+         inOrder = inOrder && spy.get() == expected++;
+      assertUnit(inOrder && expected == 101);
+   }  // teardown
+
+   // a miss brings up the node the search ended next to
+   void test_splay_findMissing()
+   {  // setup
+      custom::BST <int, custom::Splay> bst { 50, 30, 70, 20, 40, 60, 80 };
+      // exercise
+      auto itBetween = bst.find_and_splay(45);
+      int rootBetween = bst.root->data;
+      auto itPast = bst.find_and_splay(99);
+      // verify
+      assertUnit(itBetween == bst.end());
+      assertUnit(rootBetween == 50);
+      assertUnit(itPast == bst.end());
+      assertUnit(bst.root->data == 80);
+      assertUnit(isSequence(bst, 20, 10, 7));
+   }  // teardown
+
+   // find_and_splay() calls the comparator as often as find() does:
+   // once per node, and once more to check what it found
+   void test_splay_findCompares()
+   {  // setup
+      custom::BST <Spy, custom::Splay> bst;
+      for (int i = 1; i <= 100; i++)
+         bst.insert(Spy(i));
+      custom::BST <int, custom::Splay, CountingThreeWay> bstThreeWay;
+      for (int i = 1; i <= 100; i++)
+         bstThreeWay.insert(i);
+      Spy key(37);
+      int numOnPath = 0;        // to the bottom, as for the lower bound
+      for (auto p = bst.root; p; p = p->data.get() < 37 ? p->pRight : p->pLeft)
+         numOnPath++;
+      int numOnPathThreeWay = 1; // down to [37] and no further
+      for (auto p = bstThreeWay.root; p->data != 37; p = 37 < p->data ? p->pLeft : p->pRight)
+         numOnPathThreeWay++;
+      Spy::reset();
+      CountingThreeWay::numCalls = 0;
+      // exercise
+      auto it = bst.find_and_splay(key);
+      auto itThreeWay = bstThreeWay.find_and_splay(37);
+      // verify
+      assertUnit(it != bst.end() && *it == Spy(37));
+      assertUnit(Spy::numLessthan() == numOnPath + 1);  // then [37] again
+      assertUnit(itThreeWay != bstThreeWay.end() && *itThreeWay == 37);
+      assertUnit(CountingThreeWay::numCalls == numOnPathThreeWay);
+      assertUnit(bst.root->data == Spy(37) && bstThreeWay.root->data == 37);
+   }  // teardown
+
+   // erase brings up the parent of the node that left
+   void test_splay_erase()
+   {  // setup
+      custom::BST <int, custom::Splay> bst;
+      for (int i = 0; i < 200; i++)
+         bst.insert((i * 67) % 200);
+      // exercise
+      for (int i = 0; i < 200; i += 2)
+      {
+         auto it = bst.find(i);
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(isSequence(bst, 1, 2, 100));
+      assertUnit(verifyParents(bst.root, decltype(bst.root)()));
+      assertUnit(bst.front() == 1 && bst.back() == 199);
+   }  // teardown
+
+   // the other policies keep their shape: find_and_splay() is find()
+   void test_splay_otherPolicies()
+   {  // setup
+      custom::BST <int> bst { 50, 30, 70, 20, 40, 60, 80 };
+      // exercise
+      auto it = bst.find_and_splay(20);
+      // verify
+      assertUnit(it != bst.end() && *it == 20);
+      assertUnit(bst.root->data == 50);
+      assertUnit(verifyRedBlack(bst.root) > 0);
+   }  // teardown
+
+   // a few keys looked up again and again stay near the top
+   void test_splay_hotKeys()
+   {  // setup
+      using Tree = custom::BST <int, custom::Splay, std::less<int>, std::allocator<int>, custom::OrderStatistic>;
+      Tree bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert((i * 379) % 1000);
+      // exercise
+      for (int round = 0; round < 20; round++)
+         for (int hot : { 111, 222, 333, 444 })
+            bst.find_and_splay(hot);
+      // verify
+      bool shallow = true;
+      for (int hot : { 111, 222, 333, 444 })
+      {
+         int depth = 0;
+         for (auto p = bst.find(hot).pNode; p->pParent; p = p->pParent)
+            depth++;
+         shallow = shallow && depth < 4;
+      }
+      assertUnit(shallow);
+      assertUnit(verifySizes(bst.root) == 1000);
+      assertUnit(bst.rank(500) == 500);
+   }  // teardown
+
+   /***************************************
+    * PACKED NODES
+    *     PackedRedBlack
+    *     TaggedLink
+    ***************************************/
+
+   // the color costs nothing: it lives in the parent pointer
+   void test_packed_nodeSize()
+   {
+      using Packed = custom::BST <long long, custom::PackedRedBlack>;
+      using Plain  = custom::BST <long long, custom::RedBlack>;
+      assertUnit(sizeof(Packed::BNode) == sizeof(long long) + 3 * sizeof(void*));
+      assertUnit(sizeof(Packed::BNode) < sizeof(Plain::BNode));
+   }  // teardown
+
+   // scrambled inserts and erases keep the colors and the parents right
+   void test_packed_insertErase()
+   {  // setup
+      custom::BST <int, custom::PackedRedBlack> bst;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         bst.insert((i * 263) % 1000);
+      bool validFull = verifyRedBlack<custom::PackedRedBlack>(bst.root) > 0;
+      for (int i = 0; i < 1000; i += 3)
+      {
+         auto it = bst.find(i);
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(validFull);
+      assertUnit(verifyRedBlack<custom::PackedRedBlack>(bst.root) > 0);
+      assertUnit(bst.size() == 666);
+      assertUnit(bst.front() == 1 && bst.back() == 998);
+      assertUnit(height(bst.root) <= 20);         // 2 log2(n + 1)
+      int previous = -1;
+      bool inOrder = true;
+      for (int value : bst)
+      {
+         inOrder = inOrder && value > previous && value % 3 != 0;
+         previous = value;
+      }
+      assertUnit(inOrder);
+   }  // teardown
+
+   // a copy takes the colors along, and a black node taken out goes
+   // back in red, as a new node would
+   void test_packed_copyAndHandles()
+   {  // setup
+      custom::BST <int, custom::PackedRedBlack> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i);
+      custom::BST <int, custom::PackedRedBlack> bstCopy;
+      bstCopy.insert(7);
+      // exercise
+      bstCopy = bst;
+      int rootValue = bst.root->data;
+      auto node = bst.extract(bst.find(rootValue));
+      bool black = !custom::PackedRedBlack::isRed(node.pNode);
+      node.value() = 1000;
+      bst.insert(std::move(node));
+      // verify
+      assertUnit(black);
+      assertUnit(verifyRedBlack<custom::PackedRedBlack>(bstCopy.root) > 0);
+      assertUnit(verifyRedBlack<custom::PackedRedBlack>(bst.root) > 0);
+      assertUnit(isSequence(bstCopy, 0, 1, 100));
+      assertUnit(bst.size() == 100 && bst.back() == 1000 && !bst.contains(rootValue));
+   }  // teardown
 
    /**************************************************************
-    * VERIFY EMPTY FIXTURE
+    * REBALANCE HOLDS
+    * Grow a tree with the given policy from a sorted run and some
+    * scrambled keys, rebalance it, and check the shape, the order
+    * and the policy's own rules (verify), then that inserts and
+    * erases after that keep to them
     *************************************************************/
-   void assertEmptyFixtureParameters(const custom::BST <Spy>& bst, int line, const char* function)
+   template <class Balance, class Verify>
+   bool rebalanceHolds(Verify verify)
    {
-      assertUnit(bst.root == nullptr);
-      assertUnit(bst.numElements == 0);
+      custom::BST <int, Balance> bst;
+      for (int i = 0; i < 300; i++)
+         bst.insert(i);
+      for (int i = 0; i < 300; i++)
+         bst.insert(300 + (i * 263) % 300);
+      bst.rebalance();
+      if (height(bst.root) != 10 || !verify(bst.root) || !isSequence(bst, 0, 1, 600) ||
+          !verifyParents(bst.root, decltype(bst.root)()))
+         return false;
+      for (int i = 600; i < 900; i++)
+         bst.insert(i);
+      for (int i = 0; i < 600; i += 2)
+      {
+         auto it = bst.find(i);
+         bst.erase(it);
+      }
+      for (int i = 0; i < 600; i += 2)
+         bst.insert(i);
+      return verify(bst.root) && isSequence(bst, 0, 1, 900) &&
+             verifyParents(bst.root, decltype(bst.root)());
    }
 
    /**************************************************************
-    * VERIFY STANDARD FIXTURE
-    *                (50) 
-    *          +-------+-------+
-    *        (30)            (70) 
-    *     +----+----+     +----+----+
-    *   (20)      (40)  (60)      (80) 
+    * SET ALGEBRA HOLDS
+    * Unite, intersect and subtract a scrambled tree with the given
+    * policy and trees from empty to as large, checking the answers
+    * against the standard algorithms, and the policy's own rules
+    * (verify) on each
     *************************************************************/
-   void assertStandardFixtureParameters(const custom::BST <Spy>& bst, int line, const char* function)
+   template <class Balance, class Verify>
+   bool setAlgebraHolds(Verify verify)
    {
-      // verify the member variables
-      assertIndirect(bst.numElements == 7);
-      assertIndirect(bst.root != nullptr);
-
-      // verify the pointers down
-      assertIndirect(bst.root != nullptr);
-      if (bst.root)
+      custom::BST <int, Balance> bst;
+      for (int i = 0; i < 400; i++)
+         bst.insert((i * 263) % 400 * 2);
+      std::vector<int> values(bst.begin(), bst.end());
+      for (int numOther : { 0, 1, 7, 60, 400 })
       {
-         assertIndirect(bst.root->data == Spy(50));
-         assertIndirect(bst.root->pParent == nullptr);
-         assertIndirect(bst.root->pLeft != nullptr);
-         if (bst.root->pLeft)
-         {
-            assertIndirect(bst.root->pLeft->data == Spy(30));
-            assertIndirect(bst.root->pLeft->pParent == bst.root);
-            assertIndirect(bst.root->pLeft->pLeft != nullptr);
-            if (bst.root->pLeft->pLeft)
-            {
-               assertIndirect(bst.root->pLeft->pLeft->data == Spy(20));
-               assertIndirect(bst.root->pLeft->pLeft->pParent == bst.root->pLeft);
-               assertIndirect(bst.root->pLeft->pLeft->pLeft == nullptr);
-               assertIndirect(bst.root->pLeft->pLeft->pRight == nullptr);
-            }
-            assertIndirect(bst.root->pLeft->pRight != nullptr);
-            if (bst.root->pLeft->pRight)
-            {
-               assertIndirect(bst.root->pLeft->pRight->data == Spy(40));
-               assertIndirect(bst.root->pLeft->pRight->pParent == bst.root->pLeft);
-               assertIndirect(bst.root->pLeft->pRight->pLeft == nullptr);
-               assertIndirect(bst.root->pLeft->pRight->pRight == nullptr);
-            }
-         }
-         assertIndirect(bst.root->pRight != nullptr);
-         if (bst.root->pRight)
-         {
-            assertIndirect(bst.root->pRight->data == Spy(70));
-            assertIndirect(bst.root->pRight->pParent == bst.root);
-            assertIndirect(bst.root->pRight->pLeft != nullptr);
-            if (bst.root->pRight->pLeft)
-            {
-               assertIndirect(bst.root->pRight->pLeft->data == Spy(60));
-               assertIndirect(bst.root->pRight->pLeft->pParent == bst.root->pRight);
-               assertIndirect(bst.root->pRight->pLeft->pLeft == nullptr);
-               assertIndirect(bst.root->pRight->pLeft->pRight == nullptr);
-            }
-            assertIndirect(bst.root->pRight->pRight != nullptr);
-            if (bst.root->pRight->pRight)
-            {
-               assertIndirect(bst.root->pRight->pRight->data == Spy(80));
-               assertIndirect(bst.root->pRight->pRight->pParent == bst.root->pRight);
-               assertIndirect(bst.root->pRight->pRight->pLeft == nullptr);
-               assertIndirect(bst.root->pRight->pRight->pRight == nullptr);
-            }
-         }
+         custom::BST <int, Balance> bstOther;
+         for (int i = 0; i < numOther; i++)
+            bstOther.insert((i * 37) % 700);
+         std::vector<int> others(bstOther.begin(), bstOther.end());
+
+         std::vector<int> united;
+         std::vector<int> common;
+         std::vector<int> rest;
+         std::set_union(values.begin(), values.end(), others.begin(), others.end(), std::back_inserter(united));
+         std::set_intersection(values.begin(), values.end(), others.begin(), others.end(), std::back_inserter(common));
+         std::set_difference(values.begin(), values.end(), others.begin(), others.end(), std::back_inserter(rest));
+
+         custom::BST <int, Balance> bstUnited(bst);
+         custom::BST <int, Balance> bstTaken(bstOther);
+         bstUnited.unite(bstTaken);
+         custom::BST <int, Balance> bstCommon(bst);
+         bstCommon.intersect(bstOther);
+         custom::BST <int, Balance> bstRest(bst);
+         bstRest.subtract(bstOther);
+         for (auto* pTree : { &bstUnited, &bstCommon, &bstRest })
+            if (!verify(pTree->root) || !verifyParents(pTree->root, decltype(bst.root)()))
+               return false;
+         if (std::vector<int>(bstUnited.begin(), bstUnited.end()) != united || bstUnited.size() != united.size() ||
+             std::vector<int>(bstCommon.begin(), bstCommon.end()) != common || bstCommon.size() != common.size() ||
+             std::vector<int>(bstRest.begin(), bstRest.end()) != rest || bstRest.size() != rest.size() ||
+             !bstTaken.empty())
+            return false;
+
+         // the other way around
+         bstOther.unite(bstUnited);
+         bstCommon = bst;
+         bstTaken = bstOther;
+         bstTaken.intersect(bstCommon);
+         if (std::vector<int>(bstOther.begin(), bstOther.end()) != united ||
+             std::vector<int>(bstTaken.begin(), bstTaken.end()) != values ||
+             !verify(bstOther.root) || !verify(bstTaken.root))
+            return false;
       }
+      return true;
    }
 
+   /**************************************************************
+    * ORDER STATISTIC HOLDS
+    * Insert and erase a scrambled sequence with the given policy,
+    * then check the sizes, rank() and select() against the sequence
+    *************************************************************/
+   template <class Balance>
+   bool orderStatisticHolds()
+   {
+      custom::BST <int, Balance, std::less<int>, std::allocator<int>, custom::OrderStatistic> bst;
+      for (int i = 0; i < 500; i++)
+         bst.insert((i * 263) % 500);
+      for (int i = 0; i < 500; i += 3)
+      {
+         auto it = bst.find(i);
+         bst.erase(it);
+      }
+      if (verifySizes(bst.root) != (long)bst.size())
+         return false;
+      size_t position = 0;
+      for (int i = 0; i < 500; i++)
+      {
+         if (i % 3 == 0)
+            continue;
+         if (bst.rank(i) != position || bst.select(position) != i)
+            return false;
+         position++;
+      }
+      return position == bst.size();
+   }
 
    /**************************************************************
-    * TEARDOWN STANDARD FIXTURE
-    *                 ( )
-    *          +-------+-------+
-    *         ( )             ( )
-    *     +----+----+     +----+----+
-    *    ( )       ( )   ( )       ( )
+    * AGGREGATE HOLDS
+    * Insert and erase a scrambled sequence with the given policy,
+    * then check the sum of every window against adding it up
     *************************************************************/
-   void teardownStandardFixture(custom::BST <Spy>& bst)
+   template <class Balance>
+   bool aggregateHolds()
    {
-      if (bst.root)
+      custom::BST <int, Balance, std::less<int>, std::allocator<int>, custom::Aggregate<custom::Sum<long>>> bst;
+      for (int i = 0; i < 300; i++)
+         bst.insert((i * 97) % 300);
+      for (int i = 0; i < 300; i += 4)
       {
-         if (bst.root->pLeft && bst.root->pLeft != bst.root)
+         auto it = bst.find(i);
+         bst.erase(it);
+      }
+      for (int lo = -1; lo <= 301; lo += 7)
+         for (int hi = lo; hi <= 302; hi += 11)
          {
-            if (bst.root->pLeft->pLeft && bst.root->pLeft->pLeft != bst.root->pLeft && bst.root->pLeft->pLeft != bst.root)
-               delete bst.root->pLeft->pLeft;
-            if (bst.root->pLeft->pRight && bst.root->pLeft->pRight != bst.root->pLeft && bst.root->pLeft->pRight != bst.root)
-               delete bst.root->pLeft->pRight;
-            delete bst.root->pLeft;
+            long sum = 0;
+            for (int i = (lo < 0 ? 0 : lo); i < hi && i < 300; i++)
+               if (i % 4 != 0)
+                  sum += i;
+            if (bst.aggregate(lo, hi) != sum)
+               return false;
          }
-         if (bst.root->pRight && bst.root->pRight != bst.root)
-         {
-            if (bst.root->pRight->pLeft && bst.root->pRight->pLeft != bst.root->pRight && bst.root->pRight->pLeft != bst.root)
-               delete bst.root->pRight->pLeft;
-            if (bst.root->pRight->pRight && bst.root->pRight->pRight != bst.root->pRight && bst.root->pRight->pRight != bst.root)
-               delete bst.root->pRight->pRight;
+      return verifySizes(bst.root) == (long)bst.size();
+   }
 
-            delete bst.root->pRight;
-         }
-         delete bst.root;
+   /**************************************************************
+    * SPLIT JOIN HOLDS
+    * Split a scrambled tree with the given policy at every tenth key
+    * and join it back, checking the order, the sizes and the
+    * policy's own rules (verify) on both sides each time
+    *************************************************************/
+   template <class Balance, class Verify>
+   bool splitJoinHolds(Verify verify)
+   {
+      custom::BST <int, Balance> bst;
+      for (int i = 0; i < 400; i++)
+         bst.insert((i * 263) % 400);
+      for (int key = -5; key <= 405; key += 10)
+      {
+         auto bstUpper = bst.split(key);
+         int numLower = key < 0 ? 0 : (key > 400 ? 400 : key);
+         if (!isSequence(bst, 0, 1, numLower) || !isSequence(bstUpper, numLower, 1, 400 - numLower))
+            return false;
+         if (!verify(bst.root) || !verify(bstUpper.root) ||
+             !verifyParents(bst.root, decltype(bst.root)()) ||
+             !verifyParents(bstUpper.root, decltype(bst.root)()))
+            return false;
+         bst.join(bstUpper);
+         if (!isSequence(bst, 0, 1, 400) || !bstUpper.empty() || !verify(bst.root))
+            return false;
       }
-      bst.root = nullptr;
-      bst.numElements = 0;
+      return verifyParents(bst.root, decltype(bst.root)());
+   }
+
+   /**************************************************************
+    * VERIFY HEAP
+    * Is every treap priority at most its parent's?
+    *************************************************************/
+   template <class Node>
+   bool verifyHeap(const Node* pNode)
+   {
+      if (!pNode)
+         return true;
+      if (pNode->pParent && pNode->pParent->priority < pNode->priority)
+         return false;
+      return verifyHeap(pNode->pLeft) && verifyHeap(pNode->pRight);
+   }
+
+   /**************************************************************
+    * VERIFY PARENTS
+    * Does every node point back up to its parent?
+    *************************************************************/
+   template <class Node>
+   bool verifyParents(const Node* pNode, const Node* pParent)
+   {
+      if (!pNode)
+         return true;
+      return pNode->pParent == pParent &&
+             verifyParents(pNode->pLeft, pNode) &&
+             verifyParents(pNode->pRight, pNode);
+   }
+
+   /**************************************************************
+    * IS SEQUENCE
+    * Does an in-order walk yield first, first + step, ... (num values)?
+    *************************************************************/
+   template <class Tree>
+   bool isSequence(Tree& bst, int first, int step, size_t num)
+   {
+      if (bst.size() != num)
+         return false;
+      size_t count = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it, ++count)
+         if (*it != first + step * (int)count)
+            return false;
+      return count == num;
+   }
+
+   /**************************************************************
+    * NUM CHUNKS OF
+    * How many chunks a pool has alone, and in its group too unless
+    * another pool of the group was already counted
+    *************************************************************/
+   template <class Pool>
+   size_t numChunksOf(Pool& pool, bool withGroup = true)
+   {
+      size_t num = 0;
+      for (auto pChunk = pool.pChunks; pChunk; pChunk = pChunk->pNext)
+         num++;
+      if (withGroup && pool.group())
+         for (auto pChunk = pool.group()->pChunks; pChunk; pChunk = pChunk->pNext)
+            num++;
+      return num;
+   }
+
+   /**************************************************************
+    * HEIGHT
+    * The number of levels in a subtree
+    *************************************************************/
+   template <class Node>
+   int height(const Node* pNode)
+   {
+      if (!pNode)
+         return 0;
+      int left = height(pNode->pLeft);
+      int right = height(pNode->pRight);
+      return 1 + (left > right ? left : right);
    }
 
   
@@ -0,0 +1,136 @@
+/***********************************************************************
+ * Header:
+ *    TEST COMPACT
+ * Summary:
+ *    Unit tests for the compact tree
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "compact.h"
+#include "testLean.h"
+#include "testPathTree.h"
+
+#include <cstdint>    // for int32_t
+#include <string>
+
+/***********************************************
+ * TEST COMPACT
+ * Unit tests for the CompactTree class. The set behavior is in
+ * TestPathTree, and the iterators are the lean tree's; what is left
+ * is the one array the nodes live in.
+ ***********************************************/
+class TestCompact : public TestPathTree <TestCompact, custom::CompactTree>
+{
+public:
+   void run()
+   {
+      reset();
+
+      runShared();
+
+      // One array
+      test_grow_oneArray();
+      test_grow_moves();
+      test_grow_emplaceFromInside();
+      test_erase_recycles();
+
+      report("Compact");
+   }
+
+   /***************************************
+    * ONE ARRAY
+    *     CompactTree::insert(const T &)
+    *     CompactTree::emplace(args...)
+    *     CompactTree::erase(const T &)
+    ***************************************/
+
+   // however often it grows, every node is in the array
+   void test_grow_oneArray()
+   {  // setup
+      custom::CompactTree <int> tree;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         tree.insert((i * 7919) % 1000);
+      // verify
+      bool inArray = true;
+      for (auto it = tree.begin(); it != tree.end(); ++it)
+         inArray = inArray && tree.pool.indexOf(it.path[it.depth - 1]) < tree.pool.numSlots;
+      assertUnit(inArray);
+      assertUnit(tree.pool.numSlots >= 1000 && tree.pool.numSlots < 2000);
+      assertUnit(tree.size() == 1000);
+      assertUnit(shapeHolds(tree));
+   }  // teardown
+
+   // growing moves every element across, and copies none of them
+   void test_grow_moves()
+   {  // setup
+      custom::CompactTree <Spy> tree;
+      for (int i = 0; i < 16; i++)
+         tree.insert(Spy(i));
+      Spy value(99);
+      assertUnit(tree.pool.full());
+      Spy::reset();
+      // exercise
+      auto pairNew = tree.insert(value);
+      // verify
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numCopyMove() == 16);
+      assertUnit(Spy::numDestructor() == 16);
+      assertUnit(pairNew.second && *pairNew.first == Spy(99));
+      assertUnit(TestLean().pathHolds(tree, pairNew.first));
+      assertUnit(tree.size() == 17 && shapeHolds(tree));
+   }  // teardown
+
+   // the new element is made before the old ones move, so it can be
+   // made from one of them
+   void test_grow_emplaceFromInside()
+   {  // setup
+      custom::CompactTree <std::string> tree;
+      for (int i = 0; i < 16; i++)
+         tree.insert("element number " + std::to_string(i + 10));
+      assertUnit(tree.pool.full());
+      // exercise
+      auto pairNew = tree.emplace(*tree.begin(), 8);
+      // verify
+      assertUnit(pairNew.second && *pairNew.first == "number 10");
+      assertUnit(tree.contains("number 10") && tree.contains("element number 25"));
+      assertUnit(tree.size() == 17 && shapeHolds(tree));
+   }  // teardown
+
+   // the slots of erased elements are used again before the array grows
+   void test_erase_recycles()
+   {  // setup
+      custom::CompactTree <int> tree;
+      for (int i = 0; i < 16; i++)
+         tree.insert(i);
+      // exercise
+      for (int i = 0; i < 16; i += 2)
+         tree.erase(i);
+      for (int i = 100; i < 108; i++)
+         tree.insert(i);
+      // verify
+      assertUnit(tree.pool.numSlots == 16 && tree.pool.full());
+      assertUnit(tree.size() == 16 && shapeHolds(tree));
+      assertUnit(*tree.begin() == 1 && *--tree.end() == 107);
+   }  // teardown
+
+   // a link is 32 bits
+   static const size_t linkSize = sizeof(int32_t);
+
+   /**************************************************************
+    * INSERT HOLDS
+    * The iterators are the lean tree's, and so is the check
+    *************************************************************/
+   template <class Tree>
+   bool insertHolds(const Tree & tree, const typename Tree::iterator & it)
+   {
+      return TestLean().pathHolds(tree, it);
+   }
+};
+
+#endif // DEBUG
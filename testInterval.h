@@ -0,0 +1,207 @@
+/***********************************************************************
+ * Header:
+ *    TEST INTERVAL
+ * Summary:
+ *    Unit tests for the interval tree
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "interval.h"
+#include "unitTest.h"
+
+#include <vector>
+
+/***********************************************
+ * TEST INTERVAL
+ * Unit tests for the IntervalTree class
+ ***********************************************/
+class TestInterval : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Overlaps
+      test_overlaps_range();
+      test_overlaps_point();
+      test_overlaps_iterators();
+      test_overlaps_touching();
+
+      // Keep the ends right
+      test_maxEnd_erase();
+      test_maxEnd_policies();
+
+      report("Interval");
+   }
+
+   /***************************************
+    * OVERLAPS
+    *     IntervalTree::overlaps(lo, hi, f)
+    *     IntervalTree::overlaps(point, f)
+    ***************************************/
+
+   // everything that shares a point with the range, in order of start
+   void test_overlaps_range()
+   {  // setup
+      custom::IntervalTree <int> tree { { 1, 5 }, { 3, 4 }, { 6, 9 }, { 2, 12 }, { 10, 11 }, { 13, 20 } };
+      std::vector<custom::Interval<int>> found;
+      // exercise
+      tree.overlaps(4, 7, [&](const custom::Interval<int> & interval) { found.push_back(interval); });
+      // verify
+      assertUnit(found.size() == 3);
+      if (found.size() == 3)
+      {
+         assertUnit(found[0] == custom::Interval<int>(1, 5));
+         assertUnit(found[1] == custom::Interval<int>(2, 12));
+         assertUnit(found[2] == custom::Interval<int>(6, 9));
+      }
+   }  // teardown
+
+   // everything that contains the point
+   void test_overlaps_point()
+   {  // setup
+      custom::IntervalTree <double> tree { { 0.0, 1.5 }, { 1.0, 2.0 }, { 2.0, 3.0 }, { 0.5, 0.9 } };
+      std::vector<custom::Interval<double>> found;
+      // exercise
+      tree.overlaps(1.2, [&](const custom::Interval<double> & interval) { found.push_back(interval); });
+      // verify
+      assertUnit(found.size() == 2);
+      if (found.size() == 2)
+      {
+         assertUnit(found[0] == custom::Interval<double>(0.0, 1.5));
+         assertUnit(found[1] == custom::Interval<double>(1.0, 2.0));
+      }
+   }  // teardown
+
+   // the answer as iterators, which can be used to erase
+   void test_overlaps_iterators()
+   {  // setup
+      custom::IntervalTree <int> tree { { 1, 5 }, { 3, 4 }, { 6, 9 }, { 2, 12 } };
+      // exercise
+      auto found = tree.overlaps(3);
+      for (auto it : found)
+         tree.erase(it);
+      // verify
+      assertUnit(found.size() == 3);
+      assertUnit(tree.size() == 1);
+      assertUnit(tree.begin() != tree.end() && *tree.begin() == custom::Interval<int>(6, 9));
+      assertUnit(tree.overlaps(0, 100).size() == 1);
+   }  // teardown
+
+   // ranges are half open: touching is not overlapping
+   void test_overlaps_touching()
+   {  // setup
+      custom::IntervalTree <int> tree { { 1, 5 }, { 5, 8 } };
+      // exercise and verify
+      assertUnit(tree.overlaps(5).size() == 1);
+      assertUnit(tree.overlaps(8).size() == 0);
+      assertUnit(tree.overlaps(0, 1).size() == 0);
+      assertUnit(tree.overlaps(4, 6).size() == 2);
+      assertUnit(tree.overlaps(6, 6).size() == 0);
+   }  // teardown
+
+   /***************************************
+    * MAX END
+    *     IntervalMax
+    ***************************************/
+
+   // taking away the longest interval shortens the reach of the tree
+   void test_maxEnd_erase()
+   {  // setup
+      custom::IntervalTree <int> tree { { 5, 6 }, { 1, 100 }, { 7, 8 }, { 2, 3 } };
+      // exercise
+      tree.erase(custom::Interval<int>(1, 100));
+      // verify
+      assertUnit(tree.bst.root && tree.bst.root->maxEnd == 8);
+      assertUnit(verifyMaxEnd(tree.bst.root));
+      assertUnit(tree.overlaps(50, 60).empty());
+   }  // teardown
+
+   // every policy keeps the ends right, and every query matches a scan
+   void test_maxEnd_policies()
+   {
+      assertUnit(overlapsHold<custom::Unbalanced>());
+      assertUnit(overlapsHold<custom::RedBlack>());
+      assertUnit(overlapsHold<custom::AVL>());
+      assertUnit(overlapsHold<custom::Treap>());
+      assertUnit(overlapsHold<custom::Scapegoat>());
+      assertUnit(overlapsHold<custom::Splay>());
+      assertUnit(overlapsHold<custom::PackedRedBlack>());
+   }
+
+   /**************************************************************
+    * VERIFY MAX END
+    * Does every node know the largest end below it?
+    *************************************************************/
+   template <class Node>
+   bool verifyMaxEnd(const Node * pNode)
+   {
+      if (!pNode)
+         return true;
+      auto maxEnd = pNode->data.end;
+      if (pNode->pLeft && maxEnd < pNode->pLeft->maxEnd)
+         maxEnd = pNode->pLeft->maxEnd;
+      if (pNode->pRight && maxEnd < pNode->pRight->maxEnd)
+         maxEnd = pNode->pRight->maxEnd;
+      return maxEnd == pNode->maxEnd && verifyMaxEnd(pNode->pLeft) && verifyMaxEnd(pNode->pRight);
+   }
+
+   /**************************************************************
+    * OVERLAPS HOLD
+    * Insert and erase scrambled intervals with the given policy,
+    * then hold every query up against checking each interval
+    *************************************************************/
+   template <class Balance>
+   bool overlapsHold()
+   {
+      custom::IntervalTree <int, Balance> tree;
+      std::vector<custom::Interval<int>> intervals;
+      for (int i = 0; i < 400; i++)
+      {
+         int start = (i * 89) % 400;
+         custom::Interval<int> interval(start, start + 1 + (i * 37) % 25);
+         tree.insert(interval);
+         if (i % 5 != 0)
+            intervals.push_back(interval);
+      }
+      for (int i = 0; i < 400; i += 5)
+      {
+         int start = (i * 89) % 400;
+         tree.erase(custom::Interval<int>(start, start + 1 + (i * 37) % 25));
+      }
+      if (!verifyMaxEnd(tree.bst.root))
+         return false;
+
+      for (int lo = -5; lo < 430; lo += 3)
+         for (int width = 1; width < 40; width += 13)
+         {
+            size_t expected = 0;
+            size_t expectedPoint = 0;
+            for (const auto & interval : intervals)
+            {
+               expected += interval.overlaps(lo, lo + width);
+               expectedPoint += interval.contains(lo);
+            }
+            size_t num = 0;
+            bool inOrder = true;
+            custom::Interval<int> previous(-100, -100);
+            tree.overlaps(lo, lo + width, [&](const custom::Interval<int> & interval)
+            {
+               num++;
+               inOrder = inOrder && !(interval < previous);
+               previous = interval;
+            });
+            if (num != expected || !inOrder || tree.overlaps(lo).size() != expectedPoint)
+               return false;
+         }
+      return true;
+   }
+};
+
+#endif // DEBUG
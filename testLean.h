@@ -0,0 +1,61 @@
+/***********************************************************************
+ * Header:
+ *    TEST LEAN
+ * Summary:
+ *    Unit tests for the lean tree
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "lean.h"
+#include "testPathTree.h"
+
+/***********************************************
+ * TEST LEAN
+ * Unit tests for the LeanTree class. The set behavior is in
+ * TestPathTree; what is left is the iterator's path.
+ ***********************************************/
+class TestLean : public TestPathTree <TestLean, custom::LeanTree>
+{
+public:
+   void run()
+   {
+      reset();
+
+      runShared();
+
+      report("Lean");
+   }
+
+   /**************************************************************
+    * INSERT HOLDS
+    * Every iterator insert hands back must lead back to the root
+    *************************************************************/
+   template <class Tree>
+   bool insertHolds(const Tree & tree, const typename Tree::iterator & it)
+   {
+      return pathHolds(tree, it);
+   }
+
+   /**************************************************************
+    * PATH HOLDS
+    * Does the iterator's path start at the root, and go from each
+    * node to one of its children?
+    *************************************************************/
+   template <class Tree>
+   bool pathHolds(const Tree & tree, const typename Tree::iterator & it)
+   {
+      if (it.depth == 0 || it.path[0] != tree.root)
+         return false;
+      for (int i = 1; i < it.depth; i++)
+         if (Tree::left(it.path[i - 1]) != it.path[i] && Tree::right(it.path[i - 1]) != it.path[i])
+            return false;
+      return true;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,324 @@
+/***********************************************************************
+ * Header:
+ *    TEST MAP
+ * Summary:
+ *    Unit tests for map
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "map.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <iterator>   // for std::distance and std::prev
+#include <stdexcept>  // for std::out_of_range
+#include <string>
+
+/***********************************************
+ * TEST MAP
+ * Unit tests for the map class
+ ***********************************************/
+class TestMap : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Access
+      test_square_new();
+      test_square_existing();
+      test_at_existing();
+      test_at_missing();
+      test_find_keyOnly();
+      test_reverse_standard();
+      test_findAndSplay_root();
+
+      // Insert
+      test_emplace_new();
+      test_tryEmplace_new();
+      test_tryEmplace_existing();
+      test_insertOrAssign_new();
+      test_insertOrAssign_existing();
+      test_insert_duplicate();
+
+      // Remove and copy
+      test_erase_key();
+      test_copy_standard();
+
+      report("Map");
+   }
+
+   /***************************************
+    * ACCESS
+    *     map::operator[](const K &)
+    *     map::at(const K &)
+    *     map::find(const K &)
+    *     map::rbegin()
+    *     map::find_and_splay(const K &)
+    ***************************************/
+
+   // a missing key gets a default value
+   void test_square_new()
+   {  // setup
+      custom::map <int, Spy> m;
+      Spy::reset();
+      // exercise
+      Spy & value = m[50];
+      // verify
+      assertUnit(Spy::numDefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(value.empty());
+      assertUnit(m.size() == 1);
+   }  // teardown
+
+   // an existing key is found, and nothing is made
+   void test_square_existing()
+   {  // setup
+      custom::map <int, Spy> m;
+      m.try_emplace(50, 5);
+      m.try_emplace(30, 3);
+      Spy::reset();
+      // exercise
+      Spy & value = m[30];
+      // verify
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(value.get() == 3);
+      assertUnit(m.size() == 2);
+   }  // teardown
+
+   // at() on a key that is there can change the value
+   void test_at_existing()
+   {  // setup
+      custom::map <std::string, int> m { { "one", 1 }, { "two", 2 } };
+      // exercise
+      m.at("two") = 22;
+      // verify
+      const custom::map <std::string, int> & mConst = m;
+      assertUnit(mConst.at("two") == 22);
+      assertUnit(mConst.at("one") == 1);
+   }  // teardown
+
+   // at() on a missing key throws and adds nothing
+   void test_at_missing()
+   {  // setup
+      custom::map <std::string, int> m { { "one", 1 } };
+      bool thrown = false;
+      // exercise
+      try
+      {
+         m.at("three");
+      }
+      catch (const std::out_of_range &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(m.size() == 1);
+   }  // teardown
+
+   // looking up a key compares keys only and copies no pairs
+   void test_find_keyOnly()
+   {  // setup
+      custom::map <Spy, int> m;
+      for (int i : { 50, 30, 70, 20, 40, 60, 80 })
+         m.try_emplace(Spy(i), i * 10);
+      Spy key(60);
+      Spy::reset();
+      // exercise
+      auto it = m.find(key);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numLessthan() == 4);      // [50][70][60], then check [60]
+      assertUnit(it != m.end());
+      assertUnit(it->second == 600);
+   }  // teardown
+
+   // walk backwards, changing values on the way
+   void test_reverse_standard()
+   {  // setup
+      custom::map <int, int> m { { 5, 50 }, { 3, 30 }, { 8, 80 } };
+      std::string keys;
+      // exercise
+      for (auto it = m.rbegin(); it != m.rend(); ++it)
+      {
+         keys += std::to_string(it->first);
+         it->second++;
+      }
+      // verify
+      assertUnit(keys == "853");
+      const custom::map <int, int> & mConst = m;
+      assertUnit(mConst.rbegin()->second == 81);
+      assertUnit(std::prev(mConst.end())->first == 8);
+      assertUnit(std::distance(m.begin(), m.end()) == 3);
+   }  // teardown
+
+   // a splay map brings what it finds to the root, value and all
+   void test_findAndSplay_root()
+   {  // setup
+      custom::map <int, std::string, std::less<int>, std::allocator<std::pair<const int, std::string>>, custom::Splay> m;
+      for (int i = 1; i <= 50; i++)
+         m[i] = std::to_string(i);
+      // exercise
+      auto it = m.find_and_splay(17);
+      it->second += "!";
+      // verify
+      assertUnit(m.bst.root && m.bst.root->data.first == 17);
+      assertUnit(m.at(17) == "17!");
+      assertUnit(m.find_and_splay(51) == m.end());
+      assertUnit(m.size() == 50 && m.begin()->first == 1);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    *     map::emplace(args...)
+    *     map::try_emplace(const K &, args...)
+    *     map::insert_or_assign(const K &, M &&)
+    *     map::insert(const value_type &)
+    ***************************************/
+
+   // the whole pair is built in place from the arguments
+   void test_emplace_new()
+   {  // setup
+      custom::map <int, Spy> m;
+      m.try_emplace(50, 5);
+      Spy::reset();
+      // exercise
+      auto pairMap = m.emplace(30, 3);
+      auto itHint = m.emplace_hint(m.end(), 70, 7);
+      // verify
+      assertUnit(pairMap.second == true);
+      assertUnit(pairMap.first->second.get() == 3);
+      assertUnit(itHint->first == 70);
+      assertUnit(Spy::numNondefault() == 2);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(m.size() == 3);
+   }  // teardown
+
+   // the value is built in place from the arguments
+   void test_tryEmplace_new()
+   {  // setup
+      custom::map <int, Spy> m;
+      Spy::reset();
+      // exercise
+      auto pairMap = m.try_emplace(50, 99);
+      // verify
+      assertUnit(pairMap.second == true);
+      assertUnit(pairMap.first->first == 50);
+      assertUnit(pairMap.first->second.get() == 99);
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+   }  // teardown
+
+   // an existing key leaves the arguments alone
+   void test_tryEmplace_existing()
+   {  // setup
+      custom::map <int, Spy> m;
+      m.try_emplace(50, 5);
+      Spy value(99);
+      Spy::reset();
+      // exercise
+      auto pairMap = m.try_emplace(50, std::move(value));
+      // verify
+      assertUnit(pairMap.second == false);
+      assertUnit(pairMap.first->second.get() == 5);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(value.get() == 99);            // not moved from
+   }  // teardown
+
+   // a new key is inserted with the value
+   void test_insertOrAssign_new()
+   {  // setup
+      custom::map <int, Spy> m;
+      Spy value(99);
+      Spy::reset();
+      // exercise
+      auto pairMap = m.insert_or_assign(50, value);
+      // verify
+      assertUnit(pairMap.second == true);
+      assertUnit(pairMap.first->second.get() == 99);
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numAssign() == 0);
+   }  // teardown
+
+   // an existing key has its value assigned, nothing more
+   void test_insertOrAssign_existing()
+   {  // setup
+      custom::map <int, Spy> m;
+      m.try_emplace(50, 5);
+      Spy value(99);
+      Spy::reset();
+      // exercise
+      auto pairMap = m.insert_or_assign(50, value);
+      // verify
+      assertUnit(pairMap.second == false);
+      assertUnit(pairMap.first->second.get() == 99);
+      assertUnit(Spy::numAssign() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(m.size() == 1);
+   }  // teardown
+
+   // insert does not replace an existing value
+   void test_insert_duplicate()
+   {  // setup
+      custom::map <std::string, int> m { { "one", 1 } };
+      // exercise
+      auto pairMap = m.insert(std::make_pair(std::string("one"), 11));
+      // verify
+      assertUnit(pairMap.second == false);
+      assertUnit(pairMap.first->second == 1);
+      assertUnit(m.size() == 1);
+   }  // teardown
+
+   /***************************************
+    * REMOVE AND COPY
+    *     map::erase(const K &)
+    *     map::operator=(const map &)
+    ***************************************/
+
+   // erase by key
+   void test_erase_key()
+   {  // setup
+      custom::map <int, int> m { { 5, 50 }, { 3, 30 }, { 8, 80 } };
+      // exercise
+      size_t numThere = m.erase(3);
+      size_t numMissing = m.erase(4);
+      // verify
+      assertUnit(numThere == 1);
+      assertUnit(numMissing == 0);
+      assertUnit(m.size() == 2);
+      assertUnit(m.begin()->first == 5);
+   }  // teardown
+
+   // copying over a map with other keys: the const keys are rebuilt
+   void test_copy_standard()
+   {  // setup
+      custom::map <std::string, int> mSrc { { "a", 1 }, { "b", 2 }, { "c", 3 } };
+      custom::map <std::string, int> mDest { { "x", 9 }, { "y", 8 } };
+      // exercise
+      mDest = mSrc;
+      mSrc["a"] = 100;
+      // verify
+      assertUnit(mDest.size() == 3);
+      assertUnit(mDest["a"] == 1);
+      assertUnit(mDest.count("x") == 0);
+      std::string keys;
+      for (auto & pair : mDest)
+         keys += pair.first;
+      assertUnit(keys == "abc");
+   }  // teardown
+};
+
+#endif // DEBUG
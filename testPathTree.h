@@ -0,0 +1,294 @@
+/***********************************************************************
+ * Header:
+ *    TEST PATH TREE
+ * Summary:
+ *    Unit tests that every set on the path tree has to pass, whatever
+ *    its links do
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "pathtree.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <functional> // for std::greater
+#include <set>        // for std::set
+#include <vector>
+
+/***********************************************
+ * TEST PATH TREE
+ * The set behavior of a tree on PathTree. Test is the unit test
+ * derived from this one, which can check more of the tree with
+ *    shapeHolds(tree)       : after every change, beyond red-black
+ *    insertHolds(tree, it)  : of each iterator insert hands back
+ ***********************************************/
+template <class Test, template <class ...> class Tree>
+class TestPathTree : public UnitTest
+{
+public:
+   void runShared()
+   {
+      // Layout
+      test_node_size();
+
+      // Insert and find
+      test_insert_duplicate();
+      test_bounds_standard();
+
+      // Walk
+      test_iterate_bothWays();
+      test_iterate_greater();
+
+      // Remove
+      test_erase_iterator();
+      test_erase_scrambled();
+
+      // Copy and clear
+      test_copy_independent();
+      test_clear_destructors();
+   }
+
+   /***************************************
+    * LAYOUT
+    *     Tree::Node
+    ***************************************/
+
+   // an element and two links: the color, and whatever else the links
+   // mark, cost nothing
+   void test_node_size()
+   {
+      using Set = Tree <long long>;
+      assertUnit(sizeof(typename Set::Node) == sizeof(long long) + 2 * Test::linkSize);
+   }  // teardown
+
+   /***************************************
+    * INSERT AND FIND
+    *     Tree::insert(const T &)
+    *     Tree::emplace(args...)
+    *     Tree::lower_bound(const T &)
+    ***************************************/
+
+   // a repeat is not copied, and comes back as what is already there
+   void test_insert_duplicate()
+   {  // setup
+      Tree <Spy> tree { Spy(50), Spy(30), Spy(70) };
+      Spy value(30);
+      Spy::reset();
+      // exercise
+      auto pairOld = tree.insert(value);
+      auto pairNew = tree.emplace(40);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(pairOld.second == false && *pairOld.first == Spy(30));
+      assertUnit(pairNew.second == true && *pairNew.first == Spy(40));
+      assertUnit(tree.size() == 4);
+      assertUnit(test().shapeHolds(tree));
+   }  // teardown
+
+   // the bounds of something between two elements, and of the ends
+   void test_bounds_standard()
+   {  // setup
+      Tree <int> tree { 50, 30, 70, 20, 40, 60, 80 };
+      // exercise and verify
+      assertUnit(*tree.lower_bound(45) == 50);
+      assertUnit(*tree.lower_bound(40) == 40);
+      assertUnit(*tree.upper_bound(40) == 50);
+      assertUnit(*tree.lower_bound(0) == 20);
+      assertUnit(tree.upper_bound(80) == tree.end());
+      assertUnit(tree.find(65) == tree.end());
+      assertUnit(tree.count(60) == 1 && !tree.contains(61));
+   }  // teardown
+
+   /***************************************
+    * WALK
+    *     Tree::iterator::operator++
+    *     Tree::iterator::operator--
+    ***************************************/
+
+   // forwards from begin, backwards from end, and from the middle
+   void test_iterate_bothWays()
+   {  // setup
+      Tree <int> tree;
+      for (int i = 0; i < 100; i++)
+         tree.insert((i * 37) % 100);
+      // exercise
+      std::vector<int> ascending(tree.begin(), tree.end());
+      std::vector<int> descending(tree.rbegin(), tree.rend());
+      auto it = tree.find(50);
+      // verify
+      bool inOrder = ascending.size() == 100 && descending.size() == 100;
+      for (int i = 0; inOrder && i < 100; i++)
+         inOrder = ascending[i] == i && descending[i] == 99 - i;
+      assertUnit(inOrder);
+      assertUnit(*--tree.end() == 99);
+      assertUnit(*++it == 51);
+      assertUnit(*--it == 50 && *--it == 49);
+   }  // teardown
+
+   // the comparator decides the order
+   void test_iterate_greater()
+   {  // setup
+      Tree <int, std::greater<int>> tree { 1, 4, 2, 5, 3 };
+      // exercise
+      std::vector<int> inOrder(tree.begin(), tree.end());
+      // verify
+      assertUnit(inOrder == std::vector<int>({ 5, 4, 3, 2, 1 }));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    *     Tree::erase(iterator)
+    *     Tree::erase(const T &)
+    ***************************************/
+
+   // erase by iterator hands back the next one, ready to walk on
+   void test_erase_iterator()
+   {  // setup
+      Tree <int> tree;
+      for (int i = 0; i < 64; i++)
+         tree.insert(i);
+      // exercise: every other one
+      auto it = tree.begin();
+      while (it != tree.end())
+      {
+         it = tree.erase(it);
+         if (it != tree.end())
+            ++it;
+      }
+      // verify
+      std::vector<int> left(tree.begin(), tree.end());
+      bool odd = left.size() == 32;
+      for (size_t i = 0; odd && i < left.size(); i++)
+         odd = left[i] == (int)(2 * i + 1);
+      assertUnit(odd);
+      assertUnit(tree.size() == 32);
+      assertUnit(test().shapeHolds(tree));
+   }  // teardown
+
+   // scrambled inserts and erases keep the shape, and agree with std::set
+   void test_erase_scrambled()
+   {  // setup
+      Tree <int> tree;
+      std::set<int> expected;
+      bool insertsHold = true;
+      bool shapeHolds = true;
+      // exercise
+      for (int i = 0; i < 2000; i++)
+      {
+         int value = (i * 7919) % 1000;
+         if (i % 3 == 2)
+         {
+            assertUnit(tree.erase(value) == expected.erase(value));
+         }
+         else
+         {
+            auto pairTree = tree.insert(value);
+            bool inserted = expected.insert(value).second;
+            insertsHold = insertsHold && *pairTree.first == value &&
+                          pairTree.second == inserted &&
+                          test().insertHolds(tree, pairTree.first);
+         }
+         if (i % 100 == 0)
+            shapeHolds = shapeHolds && test().shapeHolds(tree);
+      }
+      // verify
+      assertUnit(insertsHold);
+      assertUnit(shapeHolds && test().shapeHolds(tree));
+      assertUnit(tree.size() == expected.size());
+      assertUnit(std::vector<int>(tree.begin(), tree.end()) ==
+                 std::vector<int>(expected.begin(), expected.end()));
+   }  // teardown
+
+   /***************************************
+    * COPY AND CLEAR
+    *     Tree::operator=(const Tree &)
+    *     Tree::clear()
+    ***************************************/
+
+   // the copy has the same shape and colors, and a life of its own
+   void test_copy_independent()
+   {  // setup
+      Tree <int> tree { 50, 30, 70, 20, 40, 60, 80, 10 };
+      Tree <int> copy { 99 };
+      // exercise
+      copy = tree;
+      tree.erase(30);
+      // verify
+      assertUnit(copy.size() == 8 && tree.size() == 7);
+      assertUnit(copy.contains(30) && copy.find(99) == copy.end());
+      assertUnit(verifyRedBlack(copy) == verifyRedBlack(tree));
+      assertUnit(test().shapeHolds(copy) && test().shapeHolds(tree));
+      assertUnit(std::vector<int>(copy.begin(), copy.end()) ==
+                 std::vector<int>({ 10, 20, 30, 40, 50, 60, 70, 80 }));
+   }  // teardown
+
+   // every element is destroyed, once
+   void test_clear_destructors()
+   {  // setup
+      Tree <Spy> tree { Spy(5), Spy(3), Spy(8), Spy(1) };
+      Spy::reset();
+      // exercise
+      tree.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 4);
+      assertUnit(tree.empty() && tree.begin() == tree.end());
+   }  // teardown
+
+   // how big a link is. Test hides this if its links are not pointers.
+   static const size_t linkSize = sizeof(void *);
+
+   /**************************************************************
+    * SHAPE HOLDS and INSERT HOLDS
+    * What every tree has to keep. Test hides these with its own
+    * to check more.
+    *************************************************************/
+   template <class Set>
+   bool shapeHolds(const Set & tree)
+   {
+      return verifyRedBlack(tree) > 0;
+   }
+
+   template <class Set>
+   bool insertHolds(const Set &, const typename Set::iterator &)
+   {
+      return true;
+   }
+
+   /**************************************************************
+    * VERIFY RED BLACK
+    * Return the black height of the tree, or -1 if the root is
+    * red, a red node has a red child, or the black heights differ.
+    * The links decide what is a child.
+    *************************************************************/
+   template <class Set>
+   int verifyRedBlack(const Set & tree)
+   {
+      return verifyRedBlack<Set>(tree.root, false, true);
+   }
+
+   template <class Set>
+   int verifyRedBlack(const typename Set::Node * pNode, bool parentRed, bool isRoot)
+   {
+      if (!pNode)
+         return 1;
+      bool red = Set::isRed(pNode);
+      if ((isRoot && red) || (parentRed && red))
+         return -1;
+      int left = verifyRedBlack<Set>(Set::left(pNode), red, false);
+      int right = verifyRedBlack<Set>(Set::right(pNode), red, false);
+      if (left < 0 || left != right)
+         return -1;
+      return left + (red ? 0 : 1);
+   }
+
+private:
+   Test & test() { return static_cast<Test &>(*this); }
+};
+
+#endif // DEBUG
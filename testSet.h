@@ -0,0 +1,275 @@
+/***********************************************************************
+ * Header:
+ *    TEST SET
+ * Summary:
+ *    Unit tests for set
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "set.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <algorithm>  // for std::copy
+#include <functional> // for std::greater
+#include <iterator>   // for std::inserter
+#include <vector>
+
+/***********************************************
+ * TEST SET
+ * Unit tests for the set class
+ ***********************************************/
+class TestSet : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Insert
+      test_insert_unique();
+      test_insert_duplicate();
+      test_insert_range();
+      test_insert_inserter();
+      test_emplace_duplicate();
+
+      // Access
+      test_find_standard();
+      test_bounds_standard();
+      test_reverse_standard();
+
+      // Remove
+      test_erase_key();
+      test_erase_iterator();
+
+      // Order
+      test_compare_greater();
+
+      // Node handles
+      test_extract_rekey();
+      test_merge_duplicates();
+
+      report("Set");
+   }
+
+   /***************************************
+    * INSERT
+    *     set::insert(const T &)
+    *     set::emplace(args...)
+    ***************************************/
+
+   // a new element goes in
+   void test_insert_unique()
+   {  // setup
+      custom::set <Spy> s;
+      Spy value(50);
+      Spy::reset();
+      // exercise
+      auto pairSet = s.insert(value);
+      // verify
+      assertUnit(pairSet.second == true);
+      assertUnit(*pairSet.first == Spy(50));
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   // an element that is already there is not copied again
+   void test_insert_duplicate()
+   {  // setup
+      custom::set <Spy> s { Spy(50), Spy(30), Spy(70) };
+      Spy value(30);
+      Spy::reset();
+      // exercise
+      auto pairSet = s.insert(value);
+      // verify
+      assertUnit(pairSet.second == false);
+      assertUnit(*pairSet.first == Spy(30));
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(s.size() == 3);
+   }  // teardown
+
+   // a range with repeats keeps one of each, in order
+   void test_insert_range()
+   {  // setup
+      std::vector<int> values = { 5, 3, 8, 3, 1, 8, 5, 9 };
+      // exercise
+      custom::set <int> s(values.begin(), values.end());
+      // verify
+      assertUnit(s.size() == 5);
+      std::vector<int> inOrder;
+      for (int value : s)
+         inOrder.push_back(value);
+      assertUnit(inOrder == std::vector<int>({ 1, 3, 5, 8, 9 }));
+   }  // teardown
+
+   // std::inserter hands each element the last position as a hint
+   void test_insert_inserter()
+   {  // setup
+      std::vector<int> values = { 1, 2, 3, 3, 4, 5 };
+      custom::set <int> s { 0, 9 };
+      // exercise
+      std::copy(values.begin(), values.end(), std::inserter(s, s.find(9)));
+      // verify
+      std::vector<int> inOrder;
+      for (int value : s)
+         inOrder.push_back(value);
+      assertUnit(inOrder == std::vector<int>({ 0, 1, 2, 3, 4, 5, 9 }));
+   }  // teardown
+
+   // an element that is already there is built, then dropped
+   void test_emplace_duplicate()
+   {  // setup
+      custom::set <Spy> s { Spy(50), Spy(30), Spy(70) };
+      Spy::reset();
+      // exercise
+      auto pairNew = s.emplace(40);
+      auto pairOld = s.emplace_hint(s.end(), 70);
+      // verify
+      assertUnit(Spy::numNondefault() == 2);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 1);  // the second [70]
+      assertUnit(pairNew.second == true);
+      assertUnit(*pairNew.first == Spy(40));
+      assertUnit(*pairOld == Spy(70));
+      assertUnit(s.size() == 4);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    *     set::find(const T &)
+    *     set::lower_bound(const T &)
+    *     set::rbegin()
+    ***************************************/
+
+   // find what is there and what is not
+   void test_find_standard()
+   {  // setup
+      custom::set <int> s { 50, 30, 70, 20, 40, 60, 80 };
+      // exercise
+      auto itFound = s.find(60);
+      auto itMissing = s.find(65);
+      // verify
+      assertUnit(itFound != s.end() && *itFound == 60);
+      assertUnit(itMissing == s.end());
+      assertUnit(s.count(40) == 1);
+      assertUnit(s.contains(45) == false);
+   }  // teardown
+
+   // the bounds of something between two elements
+   void test_bounds_standard()
+   {  // setup
+      custom::set <int> s { 50, 30, 70, 20, 40, 60, 80 };
+      // exercise
+      auto range = s.equal_range(45);
+      // verify
+      assertUnit(range.first == range.second);
+      assertUnit(*range.first == 50);
+      assertUnit(*s.lower_bound(40) == 40);
+      assertUnit(*s.upper_bound(40) == 50);
+   }  // teardown
+
+   // walk backwards from the end
+   void test_reverse_standard()
+   {  // setup
+      custom::set <int> s { 50, 30, 70, 20, 40 };
+      // exercise
+      std::vector<int> descending(s.rbegin(), s.rend());
+      // verify
+      assertUnit(descending == std::vector<int>({ 70, 50, 40, 30, 20 }));
+      assertUnit(*--s.end() == 70);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    *     set::erase(const T &)
+    *     set::erase(iterator)
+    ***************************************/
+
+   // erase by value says how many went
+   void test_erase_key()
+   {  // setup
+      custom::set <int> s { 50, 30, 70 };
+      // exercise
+      size_t numThere = s.erase(30);
+      size_t numMissing = s.erase(35);
+      // verify
+      assertUnit(numThere == 1);
+      assertUnit(numMissing == 0);
+      assertUnit(s.size() == 2);
+      assertUnit(s.find(30) == s.end());
+   }  // teardown
+
+   // erase by iterator hands back the next one
+   void test_erase_iterator()
+   {  // setup
+      custom::set <int> s { 50, 30, 70, 20, 40 };
+      // exercise
+      auto it = s.erase(s.find(40));
+      // verify
+      assertUnit(it != s.end() && *it == 50);
+      assertUnit(s.size() == 4);
+   }  // teardown
+
+   /***************************************
+    * ORDER
+    *     set<T, Compare>
+    ***************************************/
+
+   // the comparator decides the order
+   void test_compare_greater()
+   {  // setup
+      custom::set <int, std::greater<int>> s;
+      // exercise
+      s = { 1, 4, 2, 5, 3 };
+      // verify
+      std::vector<int> inOrder;
+      for (int value : s)
+         inOrder.push_back(value);
+      assertUnit(inOrder == std::vector<int>({ 5, 4, 3, 2, 1 }));
+   }  // teardown
+
+   /***************************************
+    * NODE HANDLES
+    *     set::extract(const T &)
+    *     set::insert(node_type &&)
+    *     set::merge(set &)
+    ***************************************/
+
+   // a changed element goes back unless it would be a repeat
+   void test_extract_rekey()
+   {  // setup
+      custom::set <int> s { 10, 20, 30 };
+      // exercise
+      auto node = s.extract(10);
+      node.value() = 25;
+      auto resultNew = s.insert(std::move(node));
+      auto nodeRepeat = s.extract(20);
+      nodeRepeat.value() = 30;
+      auto resultRepeat = s.insert(std::move(nodeRepeat));
+      // verify
+      assertUnit(resultNew.inserted && *resultNew.position == 25);
+      assertUnit(!resultRepeat.inserted && resultRepeat.node.value() == 30);
+      assertUnit(std::vector<int>(s.begin(), s.end()) == std::vector<int>({ 25, 30 }));
+   }  // teardown
+
+   // what is in both stays in the set it came from
+   void test_merge_duplicates()
+   {  // setup
+      custom::set <int> s { 1, 3, 5 };
+      custom::set <int> sOther { 2, 3, 4, 5, 6 };
+      // exercise
+      s.merge(sOther);
+      // verify
+      assertUnit(std::vector<int>(s.begin(), s.end()) == std::vector<int>({ 1, 2, 3, 4, 5, 6 }));
+      assertUnit(std::vector<int>(sOther.begin(), sOther.end()) == std::vector<int>({ 3, 5 }));
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,121 @@
+/***********************************************************************
+ * Header:
+ *    TEST THREADED
+ * Summary:
+ *    Unit tests for the threaded tree
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "threaded.h"
+#include "testPathTree.h"
+
+#include <vector>
+
+/***********************************************
+ * TEST THREADED
+ * Unit tests for the ThreadedTree class. The set behavior is in
+ * TestPathTree, which checks the threads after every change; what
+ * is left is where the threads go.
+ ***********************************************/
+class TestThreaded : public TestPathTree <TestThreaded, custom::ThreadedTree>
+{
+public:
+   void run()
+   {
+      reset();
+
+      runShared();
+
+      // Threads
+      test_insert_threads();
+      test_copy_threads();
+
+      report("Threaded");
+   }
+
+   /***************************************
+    * THREADS
+    *     ThreadedTree::insert(const T &)
+    *     ThreadedTree::operator=(const ThreadedTree &)
+    ***************************************/
+
+   // a new leaf threads to both its neighbors
+   void test_insert_threads()
+   {  // setup
+      custom::ThreadedTree <Spy> tree { Spy(50), Spy(30), Spy(70) };
+      // exercise
+      auto pairNew = tree.emplace(40);
+      // verify
+      auto pNew = pairNew.first.pNode;
+      assertUnit(pNew->pLeft.tagAt(1) && pNew->pLeft->data == Spy(30));
+      assertUnit(pNew->pRight.tag() && pNew->pRight->data == Spy(50));
+      assertUnit(shapeHolds(tree));
+   }  // teardown
+
+   // the copy's threads lead through the copy, not back to the original
+   void test_copy_threads()
+   {  // setup
+      custom::ThreadedTree <int> tree { 50, 30, 70, 20, 40, 60, 80, 10 };
+      custom::ThreadedTree <int> copy { 99 };
+      // exercise
+      copy = tree;
+      tree.clear();
+      // verify
+      assertUnit(copy.size() == 8 && tree.empty());
+      assertUnit(shapeHolds(copy));
+      assertUnit(std::vector<int>(copy.begin(), copy.end()) ==
+                 std::vector<int>({ 10, 20, 30, 40, 50, 60, 70, 80 }));
+      assertUnit(std::vector<int>(copy.rbegin(), copy.rend()) ==
+                 std::vector<int>({ 80, 70, 60, 50, 40, 30, 20, 10 }));
+   }  // teardown
+
+   /**************************************************************
+    * SHAPE HOLDS
+    * Red-black, and every thread where it should be
+    *************************************************************/
+   template <class Tree>
+   bool shapeHolds(const Tree & tree)
+   {
+      return verifyRedBlack(tree) > 0 && verifyThreads(tree);
+   }
+
+   /**************************************************************
+    * VERIFY THREADS
+    * Walk the tree in order by its children alone, and check that
+    * every thread points to the neighbor on its side
+    *************************************************************/
+   template <class Tree>
+   bool verifyThreads(const Tree & tree)
+   {
+      std::vector<const typename Tree::Node *> inOrder;
+      collect(tree.root, inOrder);
+      for (size_t i = 0; i < inOrder.size(); i++)
+      {
+         auto pNode = inOrder[i];
+         auto pPrev = i > 0 ? inOrder[i - 1] : nullptr;
+         auto pNext = i + 1 < inOrder.size() ? inOrder[i + 1] : nullptr;
+         if (pNode->pLeft.tagAt(1) && pNode->pLeft.get() != pPrev)
+            return false;
+         if (pNode->pRight.tag() && pNode->pRight.get() != pNext)
+            return false;
+      }
+      return inOrder.size() == tree.size();
+   }
+
+   template <class Node>
+   void collect(const Node * pNode, std::vector<const Node *> & inOrder)
+   {
+      if (!pNode)
+         return;
+      collect(pNode->pLeft.tagAt(1) ? nullptr : pNode->pLeft.get(), inOrder);
+      inOrder.push_back(pNode);
+      collect(pNode->pRight.tag() ? nullptr : pNode->pRight.get(), inOrder);
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,409 @@
+/***********************************************************************
+ * Header:
+ *    THREADED
+ * Summary:
+ *    A red-black tree for cursors that page through it. Where a node
+ *    has no child, the link points instead to the node just before it
+ *    (on the left) or just after it (on the right), and a tag bit says
+ *    which links are such threads. An iterator is a node and nothing
+ *    more, and ++ or -- never goes up: it follows a thread, or goes
+ *    down one link and then as far as it can the other way. Like
+ *    lean.h there are no parent pointers, so a node is its element
+ *    and two links, and the tree is the PathTree in pathtree.h; the
+ *    links here keep the threads up as it moves nodes around.
+ *
+ *    This will contain the class definition of:
+ *        ThreadedLinks          : Children, or else threads to the neighbors
+ *        ThreadedTree           : A set on a threaded red-black tree
+ *        ThreadedTree::iterator : An iterator that follows the threads
+ * Author
+ *    Joshua Sooaemalelagi & Brooklyn Sowards
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>    // for assert
+#include <cstddef>    // for size_t and std::ptrdiff_t
+#include <functional> // for std::less
+#include <initializer_list> // for std::initializer_list
+#include <iterator>   // for std::reverse_iterator and the iterator tags
+#include <memory>     // for std::allocator
+#include <utility>    // for std::pair, std::forward and std::move
+#include "balance.h"  // for TaggedLink
+#include "pathtree.h" // for PathTree
+
+class TestThreaded; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************************************
+ * THREADED LINKS
+ * An element and its two links, which start out as null threads.
+ * The left link carries the color (set for black) and whether it is
+ * a thread; the right link only whether it is a thread. Assigning a
+ * new node to a link keeps its tags.
+ *****************************************************************/
+template <class T>
+struct ThreadedLinks
+{
+   static const int colorTag  = 0;
+   static const int threadTag = 1;
+
+   class Node
+   {
+   public:
+      template <class ... Args>
+      explicit Node(Args && ... args) : data(std::forward<Args>(args)...)
+      {
+         pLeft.tagAt(threadTag, true);
+         pRight.tag(true);
+      }
+
+      T data;                     // user data
+      TaggedLink<Node, 2> pLeft;  // left child or thread, and the color (red when new)
+      TaggedLink<Node> pRight;    // right child or thread
+   };
+
+   static const bool oneArray = false;
+   static const bool threads = true;
+
+   static bool isRed(const Node * pNode) { return pNode && !pNode->pLeft.tagAt(colorTag); }
+   static void paint(Node * pNode, bool red) { pNode->pLeft.tagAt(colorTag, !red); }
+
+   // a child, or nullptr where the link is a thread
+   static Node * left (const Node * pNode) { return pNode->pLeft.tagAt(threadTag) ? nullptr : pNode->pLeft.get(); }
+   static Node * right(const Node * pNode) { return pNode->pRight.tag()        ? nullptr : pNode->pRight.get(); }
+
+   // the neighbor a thread points to, or nullptr where the link is a child
+   static Node * leftThread (const Node * pNode) { return pNode->pLeft.tagAt(threadTag) ? pNode->pLeft.get() : nullptr; }
+   static Node * rightThread(const Node * pNode) { return pNode->pRight.tag()        ? pNode->pRight.get() : nullptr; }
+
+   static void hangLeft(Node * pNode, Node * pChild, Node * pThread)
+   {
+      pNode->pLeft = pChild ? pChild : pThread;
+      pNode->pLeft.tagAt(threadTag, !pChild);
+   }
+   static void hangRight(Node * pNode, Node * pChild, Node * pThread)
+   {
+      pNode->pRight = pChild ? pChild : pThread;
+      pNode->pRight.tag(!pChild);
+   }
+};
+
+/************************************************
+ * THREADED TREE
+ * Unique elements in order, like set, on a red-black tree whose
+ * empty links are threads. Walking the whole tree touches every
+ * link once, so a step is O(1) on average, and even the longest
+ * step only goes down. The smallest element's left thread and the
+ * largest element's right thread are null.
+ ***********************************************/
+template <class T,
+          class Compare   = std::less<T>,
+          class Allocator = std::allocator<T> >
+class ThreadedTree : public PathTree <T, ThreadedLinks<T>, Compare, Allocator>
+{
+   friend class ::TestThreaded; // give unit tests access to the privates
+   template <class Test, template <class ...> class Tree>
+   friend class ::TestPathTree;
+
+   using Base = PathTree <T, ThreadedLinks<T>, Compare, Allocator>;
+   using Node = typename Base::Node;
+public:
+   //
+   // Types
+   //
+
+   class iterator;
+   using reverse_iterator = std::reverse_iterator<iterator>;
+   using Base::maxHeight;
+
+   //
+   // Construct
+   //
+
+   ThreadedTree() { }
+   explicit ThreadedTree(const Allocator & alloc) : Base(Compare(), alloc) { }
+   explicit ThreadedTree(const Compare & comp, const Allocator & alloc = Allocator()) : Base(comp, alloc) { }
+   ThreadedTree(const ThreadedTree & rhs) : Base(rhs.compare, rhs.get_allocator()) { this->assign(rhs); }
+   ThreadedTree(ThreadedTree && rhs) : Base(rhs.compare, rhs.get_allocator()) { swap(rhs); }
+   ThreadedTree(const std::initializer_list<T> & il)
+   {
+      for (const T & t : il)
+         insert(t);
+   }
+
+   //
+   // Assign
+   //
+
+   ThreadedTree & operator = (const ThreadedTree & rhs)
+   {
+      this->assign(rhs);
+      return *this;
+   }
+   ThreadedTree & operator = (ThreadedTree && rhs)
+   {
+      this->clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(ThreadedTree & rhs) { this->swapTree(rhs); }
+
+   //
+   // Iterator
+   //
+
+   iterator begin() const;
+   iterator end()   const { return iterator(nullptr, this); }
+   reverse_iterator rbegin() const { return reverse_iterator(end());   }
+   reverse_iterator rend()   const { return reverse_iterator(begin()); }
+
+   //
+   // Access
+   //
+
+   iterator find       (const T & t) const;
+   iterator lower_bound(const T & t) const { return iterator(this->lowerBoundNode(t, [](Node *, bool) { }), this); }
+   iterator upper_bound(const T & t) const { return iterator(this->upperBoundNode(t, [](Node *, bool) { }), this); }
+   bool   contains(const T & t) const { return find(t) != end(); }
+   size_t count   (const T & t) const { return contains(t) ? 1 : 0; }
+
+   //
+   // Insert
+   //
+
+   std::pair<iterator, bool> insert(const T &  t);
+   std::pair<iterator, bool> insert(      T && t);
+   template <class ... Args>
+   std::pair<iterator, bool> emplace(Args && ... args);
+
+   //
+   // Remove
+   //
+
+   iterator erase(iterator it);
+   size_t   erase(const T & t);
+
+private:
+   iterator link(Node ** path, int depth, bool goLeft, Node * pNew);
+};
+
+/**************************************************
+ * THREADED TREE :: ITERATOR
+ * Just the node, and the tree to come back from the end
+ *************************************************/
+template <class T, class Compare, class Allocator>
+class ThreadedTree <T, Compare, Allocator> :: iterator
+{
+   friend class ::TestThreaded; // give unit tests access to the privates
+   friend class ThreadedTree;
+   using Links = ThreadedLinks<T>;
+public:
+   // what std algorithms look at to pick their strategy
+   using iterator_category = std::bidirectional_iterator_tag;
+   using value_type        = T;
+   using difference_type   = std::ptrdiff_t;
+   using pointer           = const T *;
+   using reference         = const T &;
+
+   iterator() : pNode(nullptr), pTree(nullptr) { }
+
+   // compare
+   bool operator == (const iterator & rhs) const { return pNode == rhs.pNode; }
+   bool operator != (const iterator & rhs) const { return pNode != rhs.pNode; }
+
+   // de-reference. Cannot change because it will invalidate the tree
+   const T & operator * () const { return pNode->data; }
+   const T * operator -> () const { return &pNode->data; }
+
+   // increment and decrement
+   iterator & operator ++ ();
+   iterator & operator -- ();
+   iterator   operator ++ (int)
+   {
+      iterator itOld(*this);
+      ++*this;
+      return itOld;
+   }
+   iterator   operator -- (int)
+   {
+      iterator itOld(*this);
+      --*this;
+      return itOld;
+   }
+
+private:
+   iterator(Node * pNode, const ThreadedTree * pTree) : pNode(pNode), pTree(pTree) { }
+
+   Node * pNode;                 // where we are, nullptr at the end
+   const ThreadedTree * pTree;   // the tree, to find the way back from the end
+};
+
+/*********************************************
+ * THREADED TREE :: ITERATOR :: INCREMENT PREFIX
+ * A thread goes straight to the next node. Otherwise it is the
+ * leftmost node of the right subtree.
+ ********************************************/
+template <class T, class Compare, class Allocator>
+typename ThreadedTree <T, Compare, Allocator> :: iterator & ThreadedTree <T, Compare, Allocator> :: iterator :: operator ++ ()
+{
+   assert(pNode != nullptr);
+   bool thread = pNode->pRight.tag();
+   pNode = pNode->pRight.get();
+   if (!thread)
+      while (Node * pLeft = Links::left(pNode))
+         pNode = pLeft;
+   return *this;
+}
+
+/*********************************************
+ * THREADED TREE :: ITERATOR :: DECREMENT PREFIX
+ * The mirror image of increment, except that the end comes back
+ * to the largest element
+ ********************************************/
+template <class T, class Compare, class Allocator>
+typename ThreadedTree <T, Compare, Allocator> :: iterator & ThreadedTree <T, Compare, Allocator> :: iterator :: operator -- ()
+{
+   bool thread;
+   if (pNode)
+   {
+      thread = pNode->pLeft.tagAt(Links::threadTag);
+      pNode = pNode->pLeft.get();
+   }
+   else
+   {
+      thread = false;
+      pNode = pTree->root;
+   }
+   if (!thread && pNode)
+      while (Node * pRight = Links::right(pNode))
+         pNode = pRight;
+   return *this;
+}
+
+/*********************************************
+ * THREADED TREE :: BEGIN
+ * All the way down the left
+ ********************************************/
+template <class T, class Compare, class Allocator>
+typename ThreadedTree <T, Compare, Allocator> :: iterator ThreadedTree <T, Compare, Allocator> :: begin() const
+{
+   Node * pNode = this->root;
+   if (pNode)
+      while (Node * pLeft = this->left(pNode))
+         pNode = pLeft;
+   return iterator(pNode, this);
+}
+
+/*********************************************
+ * THREADED TREE :: FIND
+ * The lower bound, if it is not after t
+ ********************************************/
+template <class T, class Compare, class Allocator>
+typename ThreadedTree <T, Compare, Allocator> :: iterator ThreadedTree <T, Compare, Allocator> :: find(const T & t) const
+{
+   iterator it = lower_bound(t);
+   if (it.pNode && this->compare(t, it.pNode->data))
+      it.pNode = nullptr;
+   return it;
+}
+
+/*********************************************
+ * THREADED TREE :: INSERT
+ * Nothing is copied if the element is already there
+ ********************************************/
+template <class T, class Compare, class Allocator>
+std::pair<typename ThreadedTree <T, Compare, Allocator> :: iterator, bool> ThreadedTree <T, Compare, Allocator> :: insert(const T & t)
+{
+   Node * path[maxHeight + 1];
+   int depth;
+   bool goLeft;
+   if (this->locate(t, path, depth, goLeft))
+      return std::make_pair(iterator(path[depth - 1], this), false);
+   return std::make_pair(link(path, depth, goLeft, this->make(path, depth, t)), true);
+}
+
+template <class T, class Compare, class Allocator>
+std::pair<typename ThreadedTree <T, Compare, Allocator> :: iterator, bool> ThreadedTree <T, Compare, Allocator> :: insert(T && t)
+{
+   Node * path[maxHeight + 1];
+   int depth;
+   bool goLeft;
+   if (this->locate(t, path, depth, goLeft))
+      return std::make_pair(iterator(path[depth - 1], this), false);
+   return std::make_pair(link(path, depth, goLeft, this->make(path, depth, std::move(t))), true);
+}
+
+/*********************************************
+ * THREADED TREE :: EMPLACE
+ * The element has to be built to be compared, so a repeat is
+ * built and then dropped
+ ********************************************/
+template <class T, class Compare, class Allocator>
+template <class ... Args>
+std::pair<typename ThreadedTree <T, Compare, Allocator> :: iterator, bool> ThreadedTree <T, Compare, Allocator> :: emplace(Args && ... args)
+{
+   Node * pNew = this->make(nullptr, 0, std::forward<Args>(args)...);
+   Node * path[maxHeight + 1];
+   int depth;
+   bool goLeft;
+   if (this->locate(pNew->data, path, depth, goLeft))
+   {
+      this->pool.destroy(pNew);
+      return std::make_pair(iterator(path[depth - 1], this), false);
+   }
+   return std::make_pair(link(path, depth, goLeft, pNew), true);
+}
+
+/*********************************************
+ * THREADED TREE :: LINK
+ * The node does not move in memory, so it is the iterator
+ * whatever the rotations do
+ ********************************************/
+template <class T, class Compare, class Allocator>
+typename ThreadedTree <T, Compare, Allocator> :: iterator ThreadedTree <T, Compare, Allocator> :: link(Node ** path, int depth, bool goLeft, Node * pNew)
+{
+   Base::link(path, depth, goLeft, pNew);
+   return iterator(pNew, this);
+}
+
+/*********************************************
+ * THREADED TREE :: ERASE
+ * Erase by iterator hands back the next one. No node moves in
+ * memory, so the next one can be found before anything changes.
+ ********************************************/
+template <class T, class Compare, class Allocator>
+typename ThreadedTree <T, Compare, Allocator> :: iterator ThreadedTree <T, Compare, Allocator> :: erase(iterator it)
+{
+   assert(it.pNode != nullptr);
+   iterator itNext = it;
+   ++itNext;
+   erase(*it);
+   return itNext;
+}
+
+template <class T, class Compare, class Allocator>
+size_t ThreadedTree <T, Compare, Allocator> :: erase(const T & t)
+{
+   Node * path[maxHeight + 1];
+   int depth;
+   bool goLeft;
+   if (!this->locate(t, path, depth, goLeft))
+      return 0;
+   this->remove(path, depth - 1);
+   return 1;
+}
+
+/************************************************
+ * SWAP
+ * Swap two threaded trees
+ ***********************************************/
+template <class T, class Compare, class Allocator>
+void swap(ThreadedTree<T, Compare, Allocator> & lhs, ThreadedTree<T, Compare, Allocator> & rhs)
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom